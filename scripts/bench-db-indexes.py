@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+
+# Seeds a SQLite database with the plugin's own schema and synthetic times and jumpstats, then prints the query plan
+# and the mean run time of the lookups served by IX_Times_Player, IX_Times_Course and IX_Jumpstats_Player,
+# once with the indexes and once after dropping them.
+#
+# The tables, migrations and queries are read from src/kz/db, so the benchmark always runs what the plugin runs.
+#
+#   scripts/bench-db-indexes.py [--times 1000000] [--players 20000] [--courses 1000] [--jumpstats 500000] [--db bench.sqlite3]
+
+import argparse
+import os
+import random
+import re
+import sqlite3
+import statistics
+import sys
+import tempfile
+import time
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+DB_DIR = os.path.join(ROOT, 'src', 'kz', 'db')
+
+BENCHMARKED_INDEXES = ['IX_Times_Player', 'IX_Times_Course', 'IX_Jumpstats_Player']
+COURSES_PER_MAP = 5
+MODE_COUNT = 2
+RUNS = 5
+
+
+def load_queries():
+	queries = {}
+	pattern = re.compile(r'constexpr char (\w+)\[\] = R"\((.*?)\)";', re.S)
+	queries_dir = os.path.join(DB_DIR, 'queries')
+	for name in sorted(os.listdir(queries_dir)):
+		with open(os.path.join(queries_dir, name)) as file:
+			for match in pattern.finditer(file.read()):
+				# save_time.h and personal_best.h define the same names with the same queries.
+				queries.setdefault(match.group(1), ' '.join(match.group(2).split()))
+	return queries
+
+
+def load_migrations(queries):
+	with open(os.path.join(DB_DIR, 'migrations.cpp')) as file:
+		source = file.read()
+	block = re.search(r'sqliteMigrations\[\] =\s*\{(.*?)\};', source, re.S).group(1)
+	return [queries[name] for name in re.findall(r'trimString\((\w+)\)', block)]
+
+
+def to_python_format(query):
+	# The queries are printf formats, %llu and %d both become %d.
+	return query.replace('%llu', '%d')
+
+
+def seed(db, args, rng):
+	cursor = db.cursor()
+	cursor.executemany('INSERT INTO Modes (Name, ShortName) VALUES (?, ?)', [('Mode %d' % i, 'M%d' % i) for i in range(MODE_COUNT)])
+	steamIDs = [76561197960265728 + i for i in range(args.players)]
+	cursor.executemany('INSERT INTO Players (SteamID64, Alias, Cheater) VALUES (?, ?, 0)', [(s, 'player%d' % i) for i, s in enumerate(steamIDs)])
+	mapCount = (args.courses + COURSES_PER_MAP - 1) // COURSES_PER_MAP
+	cursor.executemany('INSERT INTO Maps (ID, Name) VALUES (?, ?)', [(i + 1, 'kz_map%d' % i) for i in range(mapCount)])
+	cursor.executemany('INSERT INTO MapCourses (ID, MapID, Name, StageID) VALUES (?, ?, ?, ?)',
+					   [(i + 1, i // COURSES_PER_MAP + 1, 'Course %d' % (i % COURSES_PER_MAP), i % COURSES_PER_MAP) for i in range(args.courses)])
+
+	# Popular courses get most of the times, like on a real server.
+	courseWeights = [1.0 / (i + 1) for i in range(args.courses)]
+	for start in range(0, args.times, 100000):
+		count = min(100000, args.times - start)
+		courses = rng.choices(range(1, args.courses + 1), courseWeights, k=count)
+		rows = []
+		for course in courses:
+			teleports = 0 if rng.random() < 0.4 else rng.randint(1, 200)
+			rows.append((rng.choice(steamIDs), course, rng.randint(1, MODE_COUNT), rng.uniform(10.0, 1200.0), teleports))
+		cursor.executemany('INSERT INTO Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports, Metadata) '
+						   'VALUES (?, ?, ?, 0, ?, ?, NULL)', rows)
+
+	rows = []
+	for _ in range(args.jumpstats):
+		isBlockJump = rng.random() < 0.3
+		rows.append((rng.choice(steamIDs), rng.randint(0, 8), rng.randint(1, MODE_COUNT), rng.randint(2200000, 3000000), int(isBlockJump),
+					 rng.randint(220, 300) if isBlockJump else 0))
+	cursor.executemany('INSERT INTO Jumpstats (SteamID64, JumpType, Mode, Distance, IsBlockJump, Block, Strafes, Sync, Pre, Max, Airtime) '
+					   'VALUES (?, ?, ?, ?, ?, ?, 0, 0, 0, 0, 0)', rows)
+	db.commit()
+	return steamIDs
+
+
+def benchmark(db, queries, cases):
+	results = {}
+	for name, params in cases:
+		query = to_python_format(queries[name]) % params
+		plan = db.execute('EXPLAIN QUERY PLAN ' + query).fetchall()
+		print('  %s' % name)
+		for row in plan:
+			print('    %s' % row[-1])
+		samples = []
+		for _ in range(RUNS):
+			start = time.perf_counter()
+			db.execute(query).fetchall()
+			samples.append((time.perf_counter() - start) * 1000.0)
+		results[name] = statistics.mean(samples)
+	return results
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Benchmark the Times and Jumpstats indexes on a seeded SQLite database.')
+	parser.add_argument('--times', type=int, default=1000000)
+	parser.add_argument('--players', type=int, default=20000)
+	parser.add_argument('--courses', type=int, default=1000)
+	parser.add_argument('--jumpstats', type=int, default=500000)
+	parser.add_argument('--db', help='Database file to create, a temporary file by default')
+	parser.add_argument('--seed', type=int, default=1)
+	args = parser.parse_args()
+
+	path = args.db or os.path.join(tempfile.mkdtemp(), 'bench.sqlite3')
+	if os.path.exists(path):
+		sys.exit('%s already exists' % path)
+	queries = load_queries()
+	migrations = load_migrations(queries)
+	rng = random.Random(args.seed)
+
+	db = sqlite3.connect(path)
+	# The personal best backfill runs over Times, so seed before the migrations that create and fill PersonalBests.
+	backfillStart = migrations.index(queries['sqlite_pbs_create'])
+	for migration in migrations[:backfillStart]:
+		db.execute(migration)
+	print('Seeding %d times and %d jumpstats into %s' % (args.times, args.jumpstats, path))
+	steamIDs = seed(db, args, rng)
+	for migration in migrations[backfillStart:]:
+		db.execute(migration)
+	db.commit()
+
+	# The most played course and a player that has times on it.
+	player, course, mode = db.execute('SELECT SteamID64, MapCourseID, ModeID FROM Times WHERE MapCourseID=1 LIMIT 1').fetchone()
+	mapName, courseName = db.execute('SELECT Maps.Name, MapCourses.Name FROM MapCourses '
+									 'INNER JOIN Maps ON Maps.ID=MapCourses.MapID WHERE MapCourses.ID=?', (course,)).fetchone()
+	runTime = db.execute('SELECT RunTime FROM Times WHERE SteamID64=? AND MapCourseID=? AND ModeID=?', (player, course, mode)).fetchone()[0]
+	jumper = rng.choice(steamIDs)
+	cases = [
+		('sql_getpb', (player, mapName, courseName, mode, 0, 1)),
+		('sql_getpbpro', (player, mapName, courseName, mode, 0, 1)),
+		('sql_times_findid', (player, course, mode, runTime)),
+		('sqlite_pbs_update', (player, course, mode, 0)),
+		('sqlite_pbs_update_pro', (player, course, mode, 0)),
+		('sql_jumpstats_getrecord', (jumper, 1, 1, 0)),
+		('sql_jumpstats_getpbs', (jumper,)),
+		('sql_jumpstats_getblockpbs', (jumper, jumper)),
+	]
+
+	# The upserts write, keep every run on the same data.
+	db.isolation_level = None
+	print('With indexes:')
+	db.execute('BEGIN')
+	after = benchmark(db, queries, cases)
+	db.execute('ROLLBACK')
+	for index in BENCHMARKED_INDEXES:
+		db.execute('DROP INDEX %s' % index)
+	# A fresh connection, so that no statement prepared against the old schema is reused.
+	db.close()
+	db = sqlite3.connect(path, isolation_level=None)
+	print('Without %s:' % ', '.join(BENCHMARKED_INDEXES))
+	db.execute('BEGIN')
+	before = benchmark(db, queries, cases)
+	db.execute('ROLLBACK')
+	db.close()
+
+	print('Mean of %d runs:' % RUNS)
+	print('  %-28s %12s %12s' % ('query', 'without', 'with'))
+	for name, _ in cases:
+		print('  %-28s %9.2f ms %9.2f ms' % (name, before[name], after[name]))
+	if not args.db:
+		os.remove(path)
+
+
+if __name__ == '__main__':
+	main()
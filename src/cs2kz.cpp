@@ -7,6 +7,7 @@
 #include "utils/utils.h"
 #include "utils/hooks.h"
 #include "utils/gameconfig.h"
+#include "utils/perf.h"
 
 #include "movement/movement.h"
 #include "kz/kz.h"
@@ -17,6 +18,7 @@
 #include "kz/goto/kz_goto.h"
 #include "kz/style/kz_style.h"
 #include "kz/quiet/kz_quiet.h"
+#include "kz/replays/kz_replays.h"
 #include "kz/tip/kz_tip.h"
 #include "kz/option/kz_option.h"
 #include "kz/language/kz_language.h"
@@ -45,6 +47,7 @@ bool KZPlugin::Load(PluginId id, ISmmAPI *ismm, char *error, size_t maxlen, bool
 		return false;
 	}
 
+	perf::Init();
 	hooks::Initialize();
 	movement::InitDetours();
 	KZCheckpointService::Init();
@@ -56,6 +59,7 @@ bool KZPlugin::Load(PluginId id, ISmmAPI *ismm, char *error, size_t maxlen, bool
 	KZ::misc::Init();
 	KZQuietService::Init();
 	KZ::misc::RegisterCommands();
+	perf::RegisterCommands();
 	if (!KZ::mode::InitModeCvars())
 	{
 		return false;
@@ -69,6 +73,7 @@ bool KZPlugin::Load(PluginId id, ISmmAPI *ismm, char *error, size_t maxlen, bool
 	KZ::mode::DisableReplicatedModeCvars();
 
 	KZOptionService::InitOptions();
+	KZReplayService::Init();
 	KZTipService::InitTips();
 	if (late)
 	{
@@ -90,6 +95,9 @@ bool KZPlugin::Unload(char *error, size_t maxlen)
 	g_pKZStyleManager->Cleanup();
 	g_pPlayerManager->Cleanup();
 	KZDatabaseService::Cleanup();
+	KZReplayService::Cleanup();
+	KZTimerService::Cleanup();
+	perf::Cleanup();
 	return true;
 }
 
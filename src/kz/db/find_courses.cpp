@@ -1,17 +1,15 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 #include "queries/courses.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::FindFirstCourseByMapName(CUtlString mapName, TransactionSuccessCallbackFunc onSuccess,
 												 TransactionFailureCallbackFunc onFailure)
 {
-	auto cleanMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
-
-	char query[1024];
-	V_snprintf(query, sizeof(query), sql_mapcourses_findfirst_mapname, cleanMapName.c_str(), cleanMapName.c_str());
-
 	Transaction txn;
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement(sql_mapcourses_findfirst_mapname).Bind(mapName.Get()).Bind(mapName.Get()).Get());
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(txn, onSuccess, onFailure);
 }
@@ -1,8 +1,11 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 #include "queries/players.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::FindPlayerByAlias(CUtlString playerName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
 {
 	if (!KZDatabaseService::IsReady())
@@ -11,12 +14,9 @@ void KZDatabaseService::FindPlayerByAlias(CUtlString playerName, TransactionSucc
 	}
 
 	Transaction txn;
-	char query[1024];
 
 	// Get player's steamID through their alias.
-	std::string cleanedPlayerName = KZDatabaseService::GetDatabaseConnection()->Escape(playerName.Get());
-	V_snprintf(query, sizeof(query), sql_players_searchbyalias, cleanedPlayerName.c_str(), cleanedPlayerName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement(sql_players_searchbyalias).Bind(playerName.Get()).Bind(playerName.Get()).Get());
 
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, onSuccess, onFailure);
+	KZDatabaseService::ExecuteTransaction(txn, onSuccess, onFailure);
 }
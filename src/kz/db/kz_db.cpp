@@ -1,4 +1,5 @@
 #include "kz_db.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 using namespace KZ::Database;
@@ -23,16 +24,33 @@ bool KZDatabaseService::UnregisterEventListener(KZDatabaseServiceEventListener *
 	return eventListeners.FindAndRemove(eventListener);
 }
 
+void KZDatabaseService::ExecuteTransaction(Transaction &txn, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure)
+{
+	for (size_t i = 0; i < txn.queries.size(); i++)
+	{
+		if (txn.queries[i].empty())
+		{
+			META_CONPRINTF("[KZ::DB] Refusing to run a transaction with an invalid statement at %i.\n", (i32)i);
+			onFailure("Invalid statement", (i32)i);
+			return;
+		}
+	}
+	databaseConnection->ExecuteTransaction(txn, onSuccess, onFailure);
+}
+
 void KZDatabaseService::Init()
 {
 	KZDatabaseService::SetupDatabase();
+	KZDatabaseService::InitTimeBatching();
 }
 
 void KZDatabaseService::Cleanup()
 {
+	KZDatabaseService::FlushTimes();
 	if (databaseConnection)
 	{
 		databaseConnection->Destroy();
 		databaseConnection = NULL;
 	}
+	KZ::Database::ClearStatementCache();
 }
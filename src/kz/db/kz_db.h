@@ -3,8 +3,13 @@
 #include "kz/jumpstats/kz_jumpstats.h"
 #include "kz/timer/kz_timer.h"
 
+// Times are not written right away but batched into one transaction, whichever of these limits is reached first.
+#define KZ_DB_DEFAULT_WRITE_BATCH_SIZE     32
+#define KZ_DB_DEFAULT_WRITE_BATCH_INTERVAL 0.25
+
 class ISQLConnection;
 class ISQLQuery;
+struct Transaction;
 typedef std::function<void(std::vector<ISQLQuery *>)> TransactionSuccessCallbackFunc;
 typedef std::function<void(std::string, int)> TransactionFailureCallbackFunc;
 
@@ -93,6 +98,10 @@ public:
 
 	static void OnGenericQuerySuccess(ISQLQuery *query) {}
 
+	// Runs the transaction on the database connection, unless one of its statements couldn't be built (see Statement::IsValid).
+	// onFailure is called right away then and nothing is sent to the database.
+	static void ExecuteTransaction(Transaction &txn, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure);
+
 	static void SetupDatabase();
 	static void OnDatabaseConnected(bool connect);
 
@@ -104,6 +113,7 @@ private:
 public:
 	static bool IsMapSetUp();
 	static void SetupMap();
+	static void LoadLeaderboards();
 
 	static i32 GetMapID()
 	{
@@ -140,7 +150,11 @@ public:
 	static void InsertAndUpdateStyleIDs(CUtlString styleName, CUtlString shortName);
 
 	// Times
+	// Queue a time for the next batch, the rank results are still reported per time through UpdateLocalRankData.
 	static void SaveTime(u32 id, KZPlayer *player, CUtlString courseName, f64 time, u64 teleportsUsed, CUtlString metadata);
+	static void InitTimeBatching();
+	// Write every queued time now.
+	static void FlushTimes();
 	static void QueryAllPBs(u64 steamID64, CUtlString mapName, TransactionSuccessCallbackFunc onSuccess, TransactionFailureCallbackFunc onFailure);
 	static void QueryPB(u64 steamID64, CUtlString mapName, CUtlString courseName, u32 modeID, TransactionSuccessCallbackFunc onSuccess,
 						TransactionFailureCallbackFunc onFailure);
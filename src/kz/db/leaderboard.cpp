@@ -0,0 +1,368 @@
+#include "kz_db.h"
+#include "leaderboard.h"
+#include "statement.h"
+#include "queries/course_top.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::Database;
+
+u32 Leaderboard::NextPriority()
+{
+	// xorshift32, priorities only need to be well spread out.
+	this->seed ^= this->seed << 13;
+	this->seed ^= this->seed >> 17;
+	this->seed ^= this->seed << 5;
+	return this->seed;
+}
+
+i32 Leaderboard::AllocateNode(const LeaderboardEntry &entry)
+{
+	Node node {entry, this->NextPriority(), 1, -1, -1};
+	if (this->freeList == -1)
+	{
+		return this->nodes.AddToTail(node);
+	}
+	i32 index = this->freeList;
+	this->freeList = this->nodes[index].left;
+	this->nodes[index] = node;
+	return index;
+}
+
+void Leaderboard::Split(i32 subtree, const LeaderboardEntry &key, i32 &left, i32 &right)
+{
+	if (subtree == -1)
+	{
+		left = right = -1;
+		return;
+	}
+	if (Before(this->nodes[subtree].entry, key))
+	{
+		this->Split(this->nodes[subtree].right, key, this->nodes[subtree].right, right);
+		left = subtree;
+	}
+	else
+	{
+		this->Split(this->nodes[subtree].left, key, left, this->nodes[subtree].left);
+		right = subtree;
+	}
+	this->Update(subtree);
+}
+
+i32 Leaderboard::Merge(i32 left, i32 right)
+{
+	if (left == -1 || right == -1)
+	{
+		return left == -1 ? right : left;
+	}
+	if (this->nodes[left].priority > this->nodes[right].priority)
+	{
+		this->nodes[left].right = this->Merge(this->nodes[left].right, right);
+		this->Update(left);
+		return left;
+	}
+	this->nodes[right].left = this->Merge(left, this->nodes[right].left);
+	this->Update(right);
+	return right;
+}
+
+i32 Leaderboard::Insert(i32 subtree, i32 node)
+{
+	if (subtree == -1)
+	{
+		return node;
+	}
+	if (this->nodes[node].priority > this->nodes[subtree].priority)
+	{
+		this->Split(subtree, this->nodes[node].entry, this->nodes[node].left, this->nodes[node].right);
+		this->Update(node);
+		return node;
+	}
+	if (Before(this->nodes[node].entry, this->nodes[subtree].entry))
+	{
+		this->nodes[subtree].left = this->Insert(this->nodes[subtree].left, node);
+	}
+	else
+	{
+		this->nodes[subtree].right = this->Insert(this->nodes[subtree].right, node);
+	}
+	this->Update(subtree);
+	return subtree;
+}
+
+i32 Leaderboard::Remove(i32 subtree, i32 node)
+{
+	if (subtree == node)
+	{
+		return this->Merge(this->nodes[node].left, this->nodes[node].right);
+	}
+	if (Before(this->nodes[node].entry, this->nodes[subtree].entry))
+	{
+		this->nodes[subtree].left = this->Remove(this->nodes[subtree].left, node);
+	}
+	else
+	{
+		this->nodes[subtree].right = this->Remove(this->nodes[subtree].right, node);
+	}
+	this->Update(subtree);
+	return subtree;
+}
+
+bool Leaderboard::Submit(const LeaderboardEntry &entry)
+{
+	auto it = this->players.find(entry.steamID64);
+	if (it != this->players.end())
+	{
+		i32 previous = it->second;
+		if (this->nodes[previous].entry.time <= entry.time)
+		{
+			return false;
+		}
+		this->root = this->Remove(this->root, previous);
+		this->nodes[previous].left = this->freeList;
+		this->freeList = previous;
+	}
+	i32 node = this->AllocateNode(entry);
+	this->root = this->Insert(this->root, node);
+	this->players[entry.steamID64] = node;
+	return true;
+}
+
+const LeaderboardEntry *Leaderboard::Find(u64 steamID64) const
+{
+	auto it = this->players.find(steamID64);
+	return it == this->players.end() ? nullptr : &this->nodes[it->second].entry;
+}
+
+u32 Leaderboard::GetRank(f64 time) const
+{
+	u32 faster = 0;
+	i32 node = this->root;
+	while (node != -1)
+	{
+		if (this->nodes[node].entry.time < time)
+		{
+			faster += this->Size(this->nodes[node].left) + 1;
+			node = this->nodes[node].right;
+		}
+		else
+		{
+			node = this->nodes[node].left;
+		}
+	}
+	return faster + 1;
+}
+
+const LeaderboardEntry *Leaderboard::GetEntry(u32 position) const
+{
+	i32 node = this->root;
+	while (node != -1)
+	{
+		u32 leftSize = this->Size(this->nodes[node].left);
+		if (position == leftSize)
+		{
+			return &this->nodes[node].entry;
+		}
+		if (position < leftSize)
+		{
+			node = this->nodes[node].left;
+		}
+		else
+		{
+			position -= leftSize + 1;
+			node = this->nodes[node].right;
+		}
+	}
+	return nullptr;
+}
+
+void Leaderboard::SetRunID(u64 steamID64, f64 time, u64 runID)
+{
+	auto it = this->players.find(steamID64);
+	if (it != this->players.end() && this->nodes[it->second].entry.time == time)
+	{
+		this->nodes[it->second].entry.runID = runID;
+	}
+}
+
+struct LateTime
+{
+	u32 courseID;
+	u32 modeID;
+	LeaderboardEntry entry;
+};
+
+static_global std::unordered_map<u64, Leaderboard> leaderboards;
+static_global bool leaderboardsLoaded;
+static_global bool leaderboardsLoading;
+// Bumped every time the leaderboards are reset, so that results of an outdated load are thrown away.
+static_global u32 loadGeneration;
+// Times submitted while the leaderboards are loading, they are not part of the query result.
+static_global CUtlVector<LateTime> lateTimes;
+
+static_function u64 GetLeaderboardKey(u32 courseID, u32 modeID, bool pro)
+{
+	return ((u64)courseID << 32) | ((u64)modeID << 1) | (pro ? 1 : 0);
+}
+
+static_function void AddToLeaderboards(u32 courseID, u32 modeID, const LeaderboardEntry &entry)
+{
+	leaderboards[GetLeaderboardKey(courseID, modeID, false)].Submit(entry);
+	if (entry.teleportsUsed == 0)
+	{
+		leaderboards[GetLeaderboardKey(courseID, modeID, true)].Submit(entry);
+	}
+}
+
+Leaderboard *KZ::Database::GetLeaderboard(u32 courseID, u32 modeID, bool pro)
+{
+	if (!leaderboardsLoaded)
+	{
+		return nullptr;
+	}
+	// Courses without any time simply get an empty leaderboard.
+	return &leaderboards[GetLeaderboardKey(courseID, modeID, pro)];
+}
+
+Leaderboard *KZ::Database::GetLeaderboard(const char *mapName, const char *courseName, u32 modeID, bool pro)
+{
+	if (!leaderboardsLoaded || !KZ_STREQI(mapName, g_pKZUtils->GetCurrentMapName().Get()))
+	{
+		return nullptr;
+	}
+	const KZCourse *course = KZ::course::GetCourse(courseName);
+	if (!course || !course->localDatabaseID)
+	{
+		return nullptr;
+	}
+	return KZ::Database::GetLeaderboard(course->localDatabaseID, modeID, pro);
+}
+
+static_function void SubmitToLeaderboard(Leaderboard *leaderboard, const LeaderboardEntry &entry, bool &firstTime, f32 &pbDiff, u32 &rank,
+										 u32 &maxRank)
+{
+	const LeaderboardEntry *previous = leaderboard->Find(entry.steamID64);
+	firstTime = !previous;
+	if (previous)
+	{
+		pbDiff = entry.time - previous->time;
+	}
+	leaderboard->Submit(entry);
+	rank = leaderboard->GetRank(leaderboard->Find(entry.steamID64)->time);
+	maxRank = leaderboard->Count();
+}
+
+bool KZ::Database::SubmitTime(u32 courseID, u32 modeID, u64 steamID64, const char *name, f64 time, u32 teleportsUsed,
+							  KZ::timer::LocalRankData &data)
+{
+	LeaderboardEntry entry {steamID64, name, time, teleportsUsed, 0};
+	if (!leaderboardsLoaded)
+	{
+		if (leaderboardsLoading)
+		{
+			lateTimes.AddToTail({courseID, modeID, entry});
+		}
+		return false;
+	}
+	SubmitToLeaderboard(GetLeaderboard(courseID, modeID, false), entry, data.firstTime, data.pbDiff, data.rank, data.maxRank);
+	if (teleportsUsed == 0)
+	{
+		SubmitToLeaderboard(GetLeaderboard(courseID, modeID, true), entry, data.firstTimePro, data.pbDiffPro, data.rankPro, data.maxRankPro);
+	}
+	return true;
+}
+
+void KZ::Database::SetRunID(u32 courseID, u32 modeID, u64 steamID64, f64 time, u64 runID)
+{
+	if (!leaderboardsLoaded)
+	{
+		return;
+	}
+	GetLeaderboard(courseID, modeID, false)->SetRunID(steamID64, time, runID);
+	GetLeaderboard(courseID, modeID, true)->SetRunID(steamID64, time, runID);
+}
+
+void KZ::Database::RevokeTime(u32 courseID, u32 modeID, u64 steamID64, f64 time)
+{
+	FOR_EACH_VEC_BACK(lateTimes, i)
+	{
+		const LateTime &late = lateTimes[i];
+		if (late.courseID == courseID && late.modeID == modeID && late.entry.steamID64 == steamID64 && late.entry.time == time)
+		{
+			lateTimes.Remove(i);
+		}
+	}
+	if (!leaderboardsLoaded)
+	{
+		return;
+	}
+	const LeaderboardEntry *entry = GetLeaderboard(courseID, modeID, false)->Find(steamID64);
+	const LeaderboardEntry *entryPro = GetLeaderboard(courseID, modeID, true)->Find(steamID64);
+	if ((entry && entry->time == time) || (entryPro && entryPro->time == time))
+	{
+		META_CONPRINTF("[KZ::DB] Failed to save a time of %llu, reloading the leaderboards.\n", steamID64);
+		KZDatabaseService::LoadLeaderboards();
+	}
+}
+
+void KZ::Database::ResetLeaderboards()
+{
+	leaderboards.clear();
+	lateTimes.Purge();
+	leaderboardsLoaded = false;
+	leaderboardsLoading = false;
+	loadGeneration++;
+}
+
+void KZDatabaseService::LoadLeaderboards()
+{
+	KZ::Database::ResetLeaderboards();
+	if (!KZDatabaseService::IsReady() || !KZDatabaseService::IsMapSetUp())
+	{
+		return;
+	}
+	// Queued times are written before the leaderboards are read, everything submitted after this point is a late time.
+	KZDatabaseService::FlushTimes();
+	leaderboardsLoading = true;
+	u32 generation = loadGeneration;
+
+	Transaction txn;
+	txn.queries.push_back(Statement(sql_getmapleaderboards).Bind(KZDatabaseService::GetMapID()).Get());
+	// clang-format off
+	KZDatabaseService::ExecuteTransaction(
+		txn,
+		[generation](std::vector<ISQLQuery *> queries)
+		{
+			if (generation != loadGeneration)
+			{
+				return;
+			}
+			// Rows are sorted by time, so only the first time of every player ends up in the leaderboards.
+			ISQLResult *result = queries[0]->GetResultSet();
+			while (result->FetchRow())
+			{
+				LeaderboardEntry entry {(u64)result->GetInt64(1), result->GetString(2), result->GetFloat(5), (u32)result->GetInt(6),
+										(u64)result->GetInt64(0)};
+				AddToLeaderboards(result->GetInt(3), result->GetInt(4), entry);
+			}
+			FOR_EACH_VEC(lateTimes, i)
+			{
+				AddToLeaderboards(lateTimes[i].courseID, lateTimes[i].modeID, lateTimes[i].entry);
+			}
+			lateTimes.Purge();
+			leaderboardsLoading = false;
+			leaderboardsLoaded = true;
+			META_CONPRINTF("[KZ::DB] Loaded %i leaderboards.\n", (i32)leaderboards.size());
+		},
+		[generation](std::string error, int failIndex)
+		{
+			KZDatabaseService::OnGenericTxnFailure(error, failIndex);
+			if (generation == loadGeneration)
+			{
+				lateTimes.Purge();
+				leaderboardsLoading = false;
+			}
+		});
+	// clang-format on
+}
@@ -0,0 +1,98 @@
+// Local leaderboards of the current map, kept in memory so that ranks and course tops don't need to scan the Times table.
+// They are loaded once per map and every new unstyled time is submitted to them, the database is only used to persist times.
+
+#pragma once
+#include "kz/timer/kz_timer.h"
+#include <unordered_map>
+
+namespace KZ
+{
+	namespace Database
+	{
+		struct LeaderboardEntry
+		{
+			u64 steamID64;
+			CUtlString name;
+			f64 time;
+			u32 teleportsUsed;
+			// 0 until the ID of a time submitted during this map is known.
+			u64 runID;
+		};
+
+		// Best time of every player on one course, mode and pro/nub combination.
+		// Entries are kept in a treap ordered by time where every node knows the size of its subtree,
+		// so the rank of a time and the n-th entry are both found in O(log n).
+		class Leaderboard
+		{
+		public:
+			// Returns false if the player already has an equal or better time.
+			bool Submit(const LeaderboardEntry &entry);
+			const LeaderboardEntry *Find(u64 steamID64) const;
+
+			u32 Count() const
+			{
+				return root == -1 ? 0 : nodes[root].size;
+			}
+
+			// Rank of a time among every player best, ties share the same rank.
+			u32 GetRank(f64 time) const;
+			// Entry at the given zero based position, sorted by time.
+			const LeaderboardEntry *GetEntry(u32 position) const;
+
+			void SetRunID(u64 steamID64, f64 time, u64 runID);
+
+		private:
+			struct Node
+			{
+				LeaderboardEntry entry;
+				u32 priority;
+				u32 size;
+				i32 left;
+				i32 right;
+			};
+
+			CUtlVector<Node> nodes;
+			i32 root = -1;
+			// Nodes removed from the tree, linked through their left child.
+			i32 freeList = -1;
+			u32 seed = 0x9E3779B9;
+			std::unordered_map<u64, i32> players;
+
+			static bool Before(const LeaderboardEntry &a, const LeaderboardEntry &b)
+			{
+				return a.time < b.time || (a.time == b.time && a.steamID64 < b.steamID64);
+			}
+
+			u32 Size(i32 node) const
+			{
+				return node == -1 ? 0 : nodes[node].size;
+			}
+
+			void Update(i32 node)
+			{
+				nodes[node].size = 1 + Size(nodes[node].left) + Size(nodes[node].right);
+			}
+
+			u32 NextPriority();
+			i32 AllocateNode(const LeaderboardEntry &entry);
+			i32 Insert(i32 subtree, i32 node);
+			i32 Remove(i32 subtree, i32 node);
+			void Split(i32 subtree, const LeaderboardEntry &key, i32 &left, i32 &right);
+			i32 Merge(i32 left, i32 right);
+		};
+
+		// Leaderboard of the current map, or nullptr if it isn't loaded or the map/course isn't the current one.
+		Leaderboard *GetLeaderboard(const char *mapName, const char *courseName, u32 modeID, bool pro);
+		Leaderboard *GetLeaderboard(u32 courseID, u32 modeID, bool pro);
+
+		// Submit a new unstyled time of a player who isn't a cheater and fill in its rank data.
+		// Returns false if the leaderboards aren't loaded yet, the rank has to be queried from the database then.
+		bool SubmitTime(u32 courseID, u32 modeID, u64 steamID64, const char *name, f64 time, u32 teleportsUsed, KZ::timer::LocalRankData &data);
+		void SetRunID(u32 courseID, u32 modeID, u64 steamID64, f64 time, u64 runID);
+		// Take back a time passed to SubmitTime that never made it into the database.
+		// The entry it replaced isn't kept, so the leaderboards are reloaded if the time is still the player's best.
+		void RevokeTime(u32 courseID, u32 modeID, u64 steamID64, f64 time);
+		// Drop the leaderboards of the previous map, they stay unavailable until KZDatabaseService::LoadLeaderboards is done.
+		void ResetLeaderboards();
+	} // namespace Database
+} // namespace KZ
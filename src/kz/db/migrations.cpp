@@ -41,6 +41,13 @@ static_global const std::string mysqlMigrations[] =
 	trimString(mysql_times_create),
 	trimString(mysql_jumpstats_create),
 	trimString(mysql_startpos_create),
+	trimString(mysql_times_create_index_player),
+	trimString(mysql_times_create_index_course),
+	trimString(mysql_jumpstats_create_index_player),
+	trimString(mysql_pbs_create),
+	trimString(mysql_pbs_create_index_course),
+	trimString(sql_pbs_backfill),
+	trimString(sql_pbs_backfill_pro),
 };
 
 static_global const std::string sqliteMigrations[] = 
@@ -53,6 +60,13 @@ static_global const std::string sqliteMigrations[] =
 	trimString(sqlite_times_create),
 	trimString(sqlite_jumpstats_create),
 	trimString(sqlite_startpos_create),
+	trimString(sqlite_times_create_index_player),
+	trimString(sqlite_times_create_index_course),
+	trimString(sqlite_jumpstats_create_index_player),
+	trimString(sqlite_pbs_create),
+	trimString(sqlite_pbs_create_index_course),
+	trimString(sql_pbs_backfill),
+	trimString(sql_pbs_backfill_pro),
 };
 
 // clang-format on
@@ -1,59 +1,71 @@
 constexpr char sql_getcoursetop[] = R"(
-    SELECT t.ID, t.SteamID64, p.Alias, t.RunTime AS PBTime, t.Teleports 
-        FROM Times t 
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID 
+    SELECT pb.TimeID, pb.SteamID64, p.Alias, pb.RunTime AS PBTime, pb.Teleports 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses mc ON mc.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = mc.MapID
-        INNER JOIN Players p ON p.SteamID64=t.SteamID64 
-        LEFT OUTER JOIN Times t2 ON t2.SteamID64=t.SteamID64 
-        AND t2.MapCourseID=t.MapCourseID AND t2.ModeID=t.ModeID
-        AND t2.StyleIDFlags=t.StyleIDFlags AND t2.RunTime<t.RunTime 
-        WHERE t2.ID IS NULL AND p.Cheater=0 AND Maps.Name='%s' AND mc.Name='%s' AND t.ModeID=%d AND t.StyleIDFlags=0
+        INNER JOIN Players p ON p.SteamID64=pb.SteamID64 
+        WHERE p.Cheater=0 AND Maps.Name='%s' AND mc.Name='%s' 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=0 
         ORDER BY PBTime ASC
         LIMIT %d
         OFFSET %d
 )";
 
 constexpr char sql_getcoursetoppro[] = R"(
-    SELECT t.ID, t.SteamID64, p.Alias, t.RunTime AS PBTime, t.Teleports 
-        FROM Times t 
-        INNER JOIN MapCourses mc ON mc.ID=t.MapCourseID 
+    SELECT pb.TimeID, pb.SteamID64, p.Alias, pb.RunTime AS PBTime, pb.Teleports 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses mc ON mc.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = mc.MapID
-        INNER JOIN Players p ON p.SteamID64=t.SteamID64 
-        LEFT OUTER JOIN Times t2 ON t2.SteamID64=t.SteamID64 AND t2.MapCourseID=t.MapCourseID 
-        AND t2.ModeID=t.ModeID AND t2.StyleIDFlags=t.StyleIDFlags 
-        AND t2.RunTime<t.RunTime AND t.Teleports=0 AND t2.Teleports=0 
-        WHERE t2.ID IS NULL AND p.Cheater=0 AND Maps.Name='%s'
-        AND mc.Name='%s' AND t.ModeID=%d AND t.Teleports=0 AND t.StyleIDFlags=0 
+        INNER JOIN Players p ON p.SteamID64=pb.SteamID64 
+        WHERE p.Cheater=0 AND Maps.Name='%s' AND mc.Name='%s' 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=1 
         ORDER BY PBTime ASC
         LIMIT %d
         OFFSET %d
 )";
 
+// Every unstyled personal best of the map, used to build the in memory leaderboards.
+constexpr char sql_getmapleaderboards[] = R"(
+    SELECT pb.TimeID, pb.SteamID64, p.Alias, pb.MapCourseID, pb.ModeID, pb.RunTime, pb.Teleports 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses mc ON mc.ID=pb.MapCourseID 
+        INNER JOIN Players p ON p.SteamID64=pb.SteamID64 
+        WHERE p.Cheater=0 AND mc.MapID=%d AND pb.StyleIDFlags=0 
+        ORDER BY pb.RunTime ASC, pb.TimeID ASC
+)";
+
 // Caching PBs
 
 constexpr char sql_getsrs[] = R"(
-    SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
+    SELECT pb.RunTime, pb.MapCourseID, pb.ModeID, t.Metadata
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.TimeID
+        INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
         INNER JOIN Maps m ON m.ID = mc.MapID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s'
+            SELECT MIN(pb.RunTime) AS RunTime, pb.MapCourseID, pb.ModeID
+                FROM PersonalBests pb
+                INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
+                INNER JOIN Maps m ON m.ID = mc.MapID
+                WHERE pb.Pro=0 AND m.Name = '%s'
+                GROUP BY pb.MapCourseID, pb.ModeID
+        ) x ON x.RunTime = pb.RunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
+        WHERE pb.Pro=0
 )";
 
 constexpr char sql_getsrspro[] = R"(
-    SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
+    SELECT pb.RunTime, pb.MapCourseID, pb.ModeID, t.Metadata
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.TimeID
+        INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
         INNER JOIN Maps m ON m.ID = mc.MapID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                WHERE t.Teleports=0 
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s' 
+            SELECT MIN(pb.RunTime) AS RunTime, pb.MapCourseID, pb.ModeID
+                FROM PersonalBests pb
+                INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
+                INNER JOIN Maps m ON m.ID = mc.MapID
+                WHERE pb.Pro=1 AND m.Name = '%s'
+                GROUP BY pb.MapCourseID, pb.ModeID
+        ) x ON x.RunTime = pb.RunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
+        WHERE pb.Pro=1
 )";
@@ -40,6 +40,16 @@ constexpr char mysql_jumpstats_create[] = R"(
         ON UPDATE CASCADE ON DELETE CASCADE)
 )";
 
+constexpr char sqlite_jumpstats_create_index_player[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Jumpstats_Player 
+        ON Jumpstats (SteamID64, JumpType, Mode, IsBlockJump, Block, Distance)
+)";
+
+constexpr char mysql_jumpstats_create_index_player[] = R"(
+    CREATE INDEX IX_Jumpstats_Player 
+        ON Jumpstats (SteamID64, JumpType, Mode, IsBlockJump, Block, Distance)
+)";
+
 constexpr char sql_jumpstats_insert[] = R"(
     INSERT INTO Jumpstats (SteamID64, JumpType, Mode, Distance, IsBlockJump, Block, Strafes, Sync, Pre, Max, Airtime) 
         VALUES (%d, %d, %d, %d, %d, %d, %d, %d, %d, %d, %d)
@@ -27,91 +27,85 @@ constexpr char sql_getpbpro[] = R"(
 // The following queries should have no style!
 
 constexpr char sql_getmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) + 1 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
         WHERE Players.Cheater=0 AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.RunTime < 
-            (SELECT MIN(Times.RunTime) 
-            FROM Times 
-            INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=0 AND pb.RunTime < 
+            (SELECT pb.RunTime 
+            FROM PersonalBests pb 
+            INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
             INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-            INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-            WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Maps.Name='%s'
-            AND MapCourses.Name='%s' AND Times.ModeID=%d AND Times.StyleIDFlags=0) 
-    + 1
+            WHERE pb.SteamID64=%llu AND Maps.Name='%s' AND MapCourses.Name='%s' 
+            AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=0)
 )";
 
 constexpr char sql_getmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) + 1 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
         WHERE Players.Cheater=0 AND Maps.Name='%s' AND MapCourses.Name='%s' 
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.Teleports=0 
-        AND Times.RunTime < 
-            (SELECT MIN(Times.RunTime) 
-            FROM Times 
-            INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=1 AND pb.RunTime < 
+            (SELECT pb.RunTime 
+            FROM PersonalBests pb 
+            INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
             INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-            INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-            WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Maps.Name='%s' 
-            AND MapCourses.Name='%s' AND Times.ModeID=%d 
-            AND Times.StyleIDFlags=0 AND Times.Teleports=0) 
-    + 1
+            WHERE pb.SteamID64=%llu AND Maps.Name='%s' AND MapCourses.Name='%s' 
+            AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=1)
 )";
 
 constexpr char sql_getlowestmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s' 
-        AND MapCourses.Name='%s' AND Times.ModeID=%d 
-        AND Times.StyleIDFlags=0 AND Times.StyleIDFlags=0
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
+        WHERE Players.Cheater=0 AND Maps.Name='%s' AND MapCourses.Name='%s' 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=0
 )";
 
 constexpr char sql_getlowestmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN MapCourses ON MapCourses.ID=Times.MapCourseID 
+    SELECT COUNT(*) 
+        FROM PersonalBests pb 
+        INNER JOIN MapCourses ON MapCourses.ID=pb.MapCourseID 
         INNER JOIN Maps ON Maps.ID = MapCourses.MapID
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Maps.Name='%s'
-        AND MapCourses.Name='%s' AND Times.ModeID=%d 
-        AND Times.StyleIDFlags=0 AND Times.Teleports=0
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
+        WHERE Players.Cheater=0 AND Maps.Name='%s' AND MapCourses.Name='%s' 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=1
 )";
 
 // Caching PBs
 
 constexpr char sql_getpbs[] = R"(
-    SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
+    SELECT pb.RunTime, pb.MapCourseID, pb.ModeID, t.Metadata
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.TimeID
+        INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
         INNER JOIN Maps m ON m.ID = mc.MapID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                WHERE t.SteamID64=%llu
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s'
+            SELECT MIN(RunTime) AS RunTime, MapCourseID, ModeID
+                FROM PersonalBests
+                WHERE SteamID64=%llu AND Pro=0
+                GROUP BY MapCourseID, ModeID
+        ) x ON x.RunTime = pb.RunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
+        WHERE pb.SteamID64=%llu AND pb.Pro=0 AND m.Name = '%s'
 )";
 
 constexpr char sql_getpbspro[] = R"(
-    SELECT x.RunTime, x.MapCourseID, x.ModeID, t.Metadata
-        FROM Times t
-        INNER JOIN MapCourses mc ON mc.ID = t.MapCourseID
+    SELECT pb.RunTime, pb.MapCourseID, pb.ModeID, t.Metadata
+        FROM PersonalBests pb
+        INNER JOIN Times t ON t.ID = pb.TimeID
+        INNER JOIN MapCourses mc ON mc.ID = pb.MapCourseID
         INNER JOIN Maps m ON m.ID = mc.MapID
         INNER JOIN (
-            SELECT MIN(t.RunTime) AS RunTime, t.MapCourseID, t.ModeID
-                FROM Times t
-                WHERE t.SteamID64=%llu AND t.Teleports=0 
-                GROUP BY t.MapCourseID, t.ModeID
-        ) x ON x.RunTime = t.RunTime AND x.MapCourseID = t.MapCourseID AND x.ModeID = t.ModeID
-        WHERE m.Name = '%s'
+            SELECT MIN(RunTime) AS RunTime, MapCourseID, ModeID
+                FROM PersonalBests
+                WHERE SteamID64=%llu AND Pro=1
+                GROUP BY MapCourseID, ModeID
+        ) x ON x.RunTime = pb.RunTime AND x.MapCourseID = pb.MapCourseID AND x.ModeID = pb.ModeID
+        WHERE pb.SteamID64=%llu AND pb.Pro=1 AND m.Name = '%s'
 )";
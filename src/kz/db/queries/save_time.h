@@ -23,47 +23,41 @@ constexpr char sql_getpbpro[] = R"(
 // The following queries should have no style!
 
 constexpr char sql_getmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.RunTime < 
-        (SELECT MIN(Times.RunTime) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.SteamID64=%llu AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0) 
-    + 1
+    SELECT COUNT(*) + 1 
+        FROM PersonalBests pb 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
+        WHERE Players.Cheater=0 AND pb.MapCourseID=%d 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=0 AND pb.RunTime < 
+        (SELECT RunTime 
+        FROM PersonalBests 
+        WHERE SteamID64=%llu AND MapCourseID=%d 
+        AND ModeID=%d AND StyleIDFlags=0 AND Pro=0)
 )";
 
 constexpr char sql_getmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.Teleports=0 
-        AND Times.RunTime < 
-        (SELECT MIN(Times.RunTime) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.SteamID64=%llu 
-        AND Times.MapCourseID=%d AND Times.ModeID=%d 
-        AND Times.StyleIDFlags=0 AND Times.Teleports=0) 
-    + 1
+    SELECT COUNT(*) + 1 
+        FROM PersonalBests pb 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
+        WHERE Players.Cheater=0 AND pb.MapCourseID=%d 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=1 AND pb.RunTime < 
+        (SELECT RunTime 
+        FROM PersonalBests 
+        WHERE SteamID64=%llu AND MapCourseID=%d 
+        AND ModeID=%d AND StyleIDFlags=0 AND Pro=1)
 )";
 
 constexpr char sql_getlowestmaprank[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0
+    SELECT COUNT(*) 
+        FROM PersonalBests pb 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
+        WHERE Players.Cheater=0 AND pb.MapCourseID=%d 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=0
 )";
 
 constexpr char sql_getlowestmaprankpro[] = R"(
-    SELECT COUNT(DISTINCT Times.SteamID64) 
-        FROM Times 
-        INNER JOIN Players ON Players.SteamID64=Times.SteamID64 
-        WHERE Players.Cheater=0 AND Times.MapCourseID=%d
-        AND Times.ModeID=%d AND Times.StyleIDFlags=0 AND Times.Teleports=0
+    SELECT COUNT(*) 
+        FROM PersonalBests pb 
+        INNER JOIN Players ON Players.SteamID64=pb.SteamID64 
+        WHERE Players.Cheater=0 AND pb.MapCourseID=%d 
+        AND pb.ModeID=%d AND pb.StyleIDFlags=0 AND pb.Pro=1
 )";
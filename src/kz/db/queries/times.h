@@ -41,12 +41,161 @@ constexpr char mysql_times_create[] = R"(
         ON UPDATE CASCADE ON DELETE CASCADE)
 )";
 
+// Personal best lookups filter on the player first, ranks, records and course tops on the course.
+// Both indexes contain every column those queries read, so they never have to touch the table itself.
+
+constexpr char sqlite_times_create_index_player[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Times_Player 
+        ON Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports)
+)";
+
+constexpr char mysql_times_create_index_player[] = R"(
+    CREATE INDEX IX_Times_Player 
+        ON Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports)
+)";
+
+constexpr char sqlite_times_create_index_course[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_Times_Course 
+        ON Times (MapCourseID, ModeID, StyleIDFlags, RunTime, SteamID64, Teleports)
+)";
+
+constexpr char mysql_times_create_index_course[] = R"(
+    CREATE INDEX IX_Times_Course 
+        ON Times (MapCourseID, ModeID, StyleIDFlags, RunTime, SteamID64, Teleports)
+)";
+
 constexpr char sql_times_insert[] = R"(
     INSERT INTO Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports, Metadata) 
         VALUES (%llu, %d, %d, %llu, %.7f, %llu, '%s')
 )";
 
+// Batched inserts are built from the insert head followed by one comma separated row per time.
+constexpr char sql_times_insert_batch[] = R"(
+    INSERT INTO Times (SteamID64, MapCourseID, ModeID, StyleIDFlags, RunTime, Teleports, Metadata) 
+        VALUES )";
+
+constexpr char sql_times_insert_batch_row[] = R"((%llu, %d, %d, %llu, %.7f, %llu, '%s'))";
+
+constexpr char sql_times_findid[] = R"(
+    SELECT MAX(ID) 
+        FROM Times 
+        WHERE SteamID64=%llu AND MapCourseID=%d AND ModeID=%d AND StyleIDFlags=0 AND RunTime=%.7f
+)";
+
 constexpr char sql_times_delete[] = R"(
     DELETE FROM Times 
         WHERE ID=%d
 )";
+
+// =====[ PERSONAL BESTS ]=====
+
+// Best time of every player per course, mode and style, once overall (Pro=0) and once without teleports (Pro=1).
+// Updated together with every insert into Times, so that reads don't need to reduce the whole history.
+
+constexpr char sqlite_pbs_create[] = R"(
+    CREATE TABLE IF NOT EXISTS PersonalBests ( 
+        SteamID64 INTEGER NOT NULL, 
+        MapCourseID INTEGER NOT NULL, 
+        ModeID INTEGER NOT NULL, 
+        StyleIDFlags INTEGER NOT NULL, 
+        Pro INTEGER NOT NULL, 
+        TimeID INTEGER NOT NULL, 
+        RunTime REAL NOT NULL, 
+        Teleports INTEGER NOT NULL, 
+        CONSTRAINT PK_PersonalBests PRIMARY KEY (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro), 
+        CONSTRAINT FK_PersonalBests_TimeID FOREIGN KEY (TimeID) REFERENCES Times(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE)
+)";
+
+constexpr char mysql_pbs_create[] = R"(
+    CREATE TABLE IF NOT EXISTS PersonalBests ( 
+        SteamID64 BIGINT UNSIGNED NOT NULL, 
+        MapCourseID INTEGER UNSIGNED NOT NULL, 
+        ModeID INTEGER UNSIGNED NOT NULL, 
+        StyleIDFlags INTEGER UNSIGNED NOT NULL, 
+        Pro TINYINT UNSIGNED NOT NULL, 
+        TimeID INTEGER UNSIGNED NOT NULL, 
+        RunTime DOUBLE UNSIGNED NOT NULL, 
+        Teleports SMALLINT UNSIGNED NOT NULL, 
+        CONSTRAINT PK_PersonalBests PRIMARY KEY (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro), 
+        CONSTRAINT FK_PersonalBests_TimeID FOREIGN KEY (TimeID) REFERENCES Times(ID) 
+        ON UPDATE CASCADE ON DELETE CASCADE)
+)";
+
+constexpr char sqlite_pbs_create_index_course[] = R"(
+    CREATE INDEX IF NOT EXISTS IX_PersonalBests_Course 
+        ON PersonalBests (MapCourseID, ModeID, StyleIDFlags, Pro, RunTime, SteamID64)
+)";
+
+constexpr char mysql_pbs_create_index_course[] = R"(
+    CREATE INDEX IX_PersonalBests_Course 
+        ON PersonalBests (MapCourseID, ModeID, StyleIDFlags, Pro, RunTime, SteamID64)
+)";
+
+// Fill the table from the times inserted before it existed.
+constexpr char sql_pbs_backfill[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro, TimeID, RunTime, Teleports) 
+        SELECT t.SteamID64, t.MapCourseID, t.ModeID, t.StyleIDFlags, 0, t.ID, t.RunTime, t.Teleports 
+            FROM Times t 
+            WHERE NOT EXISTS (
+                SELECT 1 
+                    FROM Times t2 
+                    WHERE t2.SteamID64=t.SteamID64 AND t2.MapCourseID=t.MapCourseID 
+                    AND t2.ModeID=t.ModeID AND t2.StyleIDFlags=t.StyleIDFlags 
+                    AND (t2.RunTime<t.RunTime OR (t2.RunTime=t.RunTime AND t2.ID<t.ID)))
+)";
+
+constexpr char sql_pbs_backfill_pro[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro, TimeID, RunTime, Teleports) 
+        SELECT t.SteamID64, t.MapCourseID, t.ModeID, t.StyleIDFlags, 1, t.ID, t.RunTime, t.Teleports 
+            FROM Times t 
+            WHERE t.Teleports=0 AND NOT EXISTS (
+                SELECT 1 
+                    FROM Times t2 
+                    WHERE t2.SteamID64=t.SteamID64 AND t2.MapCourseID=t.MapCourseID 
+                    AND t2.ModeID=t.ModeID AND t2.StyleIDFlags=t.StyleIDFlags AND t2.Teleports=0 
+                    AND (t2.RunTime<t.RunTime OR (t2.RunTime=t.RunTime AND t2.ID<t.ID)))
+)";
+
+// Set the personal best of a player to their best time, run right after new times are inserted.
+constexpr char sqlite_pbs_update[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro, TimeID, RunTime, Teleports) 
+        SELECT SteamID64, MapCourseID, ModeID, StyleIDFlags, 0, ID, RunTime, Teleports 
+            FROM Times 
+            WHERE SteamID64=%llu AND MapCourseID=%d AND ModeID=%d AND StyleIDFlags=%llu 
+            ORDER BY RunTime ASC, ID ASC 
+            LIMIT 1 
+        ON CONFLICT (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro) 
+        DO UPDATE SET TimeID=excluded.TimeID, RunTime=excluded.RunTime, Teleports=excluded.Teleports
+)";
+
+constexpr char sqlite_pbs_update_pro[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro, TimeID, RunTime, Teleports) 
+        SELECT SteamID64, MapCourseID, ModeID, StyleIDFlags, 1, ID, RunTime, Teleports 
+            FROM Times 
+            WHERE SteamID64=%llu AND MapCourseID=%d AND ModeID=%d AND StyleIDFlags=%llu AND Teleports=0 
+            ORDER BY RunTime ASC, ID ASC 
+            LIMIT 1 
+        ON CONFLICT (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro) 
+        DO UPDATE SET TimeID=excluded.TimeID, RunTime=excluded.RunTime, Teleports=excluded.Teleports
+)";
+
+constexpr char mysql_pbs_update[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro, TimeID, RunTime, Teleports) 
+        SELECT SteamID64, MapCourseID, ModeID, StyleIDFlags, 0, ID, RunTime, Teleports 
+            FROM Times 
+            WHERE SteamID64=%llu AND MapCourseID=%d AND ModeID=%d AND StyleIDFlags=%llu 
+            ORDER BY RunTime ASC, ID ASC 
+            LIMIT 1 
+        ON DUPLICATE KEY UPDATE TimeID=VALUES(TimeID), RunTime=VALUES(RunTime), Teleports=VALUES(Teleports)
+)";
+
+constexpr char mysql_pbs_update_pro[] = R"(
+    INSERT INTO PersonalBests (SteamID64, MapCourseID, ModeID, StyleIDFlags, Pro, TimeID, RunTime, Teleports) 
+        SELECT SteamID64, MapCourseID, ModeID, StyleIDFlags, 1, ID, RunTime, Teleports 
+            FROM Times 
+            WHERE SteamID64=%llu AND MapCourseID=%d AND ModeID=%d AND StyleIDFlags=%llu AND Teleports=0 
+            ORDER BY RunTime ASC, ID ASC 
+            LIMIT 1 
+        ON DUPLICATE KEY UPDATE TimeID=VALUES(TimeID), RunTime=VALUES(RunTime), Teleports=VALUES(Teleports)
+)";
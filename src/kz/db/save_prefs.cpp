@@ -1,10 +1,13 @@
 #include "kz_db.h"
 #include "kz/option/kz_option.h"
+#include "statement.h"
 
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 #include "queries/players.h"
 
+using namespace KZ::Database;
+
 void KZDatabaseService::SavePrefs(CUtlString prefs)
 {
 	if (!KZDatabaseService::IsReady() || !this->IsSetup())
@@ -12,14 +15,9 @@ void KZDatabaseService::SavePrefs(CUtlString prefs)
 		return;
 	}
 	u64 steamID64 = this->player->GetSteamId64();
-	std::string cleanedPrefs = KZDatabaseService::GetDatabaseConnection()->Escape(prefs);
 
 	Transaction txn;
+	txn.queries.push_back(Statement(sql_players_set_prefs).Bind(prefs.Get()).Bind(steamID64).Get());
 
-	CUtlString query;
-	query.Format(sql_players_set_prefs, prefs.Get(), steamID64);
-
-	txn.queries.push_back(query.Get());
-
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, OnGenericTxnSuccess, OnGenericTxnFailure);
+	KZDatabaseService::ExecuteTransaction(txn, OnGenericTxnSuccess, OnGenericTxnFailure);
 }
@@ -1,29 +1,59 @@
 #include "kz_db.h"
+#include "leaderboard.h"
 #include "kz/course/kz_course.h"
 #include "kz/mode/kz_mode.h"
+#include "kz/option/kz_option.h"
 #include "kz/style/kz_style.h"
 #include "kz/timer/kz_timer.h"
 #include "queries/save_time.h"
 #include "queries/times.h"
+#include "statement.h"
+#include "utils/ctimer.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
+#include <vector>
+
 using namespace KZ::Database;
 
+struct PendingTime
+{
+	u32 id;
+	CPlayerUserId userID;
+	u64 steamID;
+	u32 courseID;
+	u32 modeID;
+	u64 styleIDs;
+	f64 time;
+	u64 teleportsUsed;
+	std::string metadata;
+	// Whether the rank was already taken from the in memory leaderboards.
+	bool ranked;
+	KZ::timer::LocalRankData rankData;
+	// Index of the first rank query of this time in the transaction, only used for unstyled runs.
+	u32 rankQueryIndex;
+	// Index of the query fetching the ID of a new leaderboard entry, 0 if there is none.
+	u32 runIDQueryIndex;
+};
+
+static_global std::vector<PendingTime> pendingTimes;
+static_global CTimerBase *flushTimer;
+static_global u32 maxBatchSize = KZ_DB_DEFAULT_WRITE_BATCH_SIZE;
+static_global f64 batchInterval = KZ_DB_DEFAULT_WRITE_BATCH_INTERVAL;
+
+static_function void ExecuteTimeBatch(std::vector<PendingTime> times);
+
 void KZDatabaseService::SaveTime(u32 id, KZPlayer *player, CUtlString courseName, f64 time, u64 teleportsUsed, CUtlString metadata)
 {
 	if (!KZDatabaseService::IsReady())
 	{
 		return;
 	}
-	std::string cleanedCourseName = KZDatabaseService::GetDatabaseConnection()->Escape(courseName);
-
 	const KZCourse *course = KZ::course::GetCourse(courseName.Get());
 	if (!course || !course->localDatabaseID)
 	{
 		META_CONPRINTF("%s: Failed to find course or course does not have a valid database ID!\n", __func__);
 		return;
 	}
-	char query[1024];
 	CPlayerUserId userID = player->GetClient()->GetUserID();
 	u64 steamID = player->GetSteamId64();
 	u32 modeID = KZ::mode::GetModeInfo(player->modeService).databaseID;
@@ -38,100 +68,273 @@ void KZDatabaseService::SaveTime(u32 id, KZPlayer *player, CUtlString courseName
 		}
 		styleIDs |= (1ull << styleDatabaseID);
 	}
+	KZ::timer::LocalRankData rankData;
+	bool ranked = styleIDs == 0 && !player->databaseService->isCheater
+				  && KZ::Database::SubmitTime(course->localDatabaseID, modeID, steamID, player->GetName(), time, teleportsUsed, rankData);
+	pendingTimes.push_back(
+		{id, userID, steamID, course->localDatabaseID, modeID, styleIDs, time, teleportsUsed, metadata.Get(), ranked, rankData, 0, 0});
+	if (pendingTimes.size() >= maxBatchSize)
+	{
+		KZDatabaseService::FlushTimes();
+	}
+}
+
+static_function KZ::timer::LocalRankData ReadRankData(const PendingTime &pending, std::vector<ISQLQuery *> &queries)
+{
+	u32 index = pending.rankQueryIndex;
+	f64 time = pending.time;
+	KZ::timer::LocalRankData data;
+	ISQLResult *result = queries[index]->GetResultSet();
+	data.firstTime = result->GetRowCount() == 1;
+	if (!data.firstTime)
+	{
+		result->FetchRow();
+		f32 pb = result->GetFloat(0);
+		// Close enough. New time is new PB.
+		if (fabs(pb - time) < EPSILON)
+		{
+			result->FetchRow();
+			f32 oldPB = result->GetFloat(0);
+			data.pbDiff = time - oldPB;
+		}
+		else // Didn't beat PB
+		{
+			data.pbDiff = time - pb;
+		}
+	}
+	// Get NUB Rank
+	result = queries[index + 1]->GetResultSet();
+	result->FetchRow();
+	data.rank = result->GetInt(0);
+	result = queries[index + 2]->GetResultSet();
+	result->FetchRow();
+	data.maxRank = result->GetInt(0);
+
+	if (pending.teleportsUsed == 0)
+	{
+		ISQLResult *result = queries[index + 3]->GetResultSet();
+		data.firstTimePro = result->GetRowCount() == 1;
+		if (!data.firstTimePro)
+		{
+			result->FetchRow();
+			f32 pb = result->GetFloat(0);
+			// Close enough. New time is new PB.
+			if (fabs(pb - time) < EPSILON)
+			{
+				result->FetchRow();
+				f32 oldPB = result->GetFloat(0);
+				data.pbDiffPro = time - oldPB;
+			}
+			else // Didn't beat PB
+			{
+				data.pbDiffPro = time - pb;
+			}
+		}
+		// Get PRO rank
+		result = queries[index + 4]->GetResultSet();
+		result->FetchRow();
+		data.rankPro = result->GetInt(0);
+		result = queries[index + 5]->GetResultSet();
+		result->FetchRow();
+		data.maxRankPro = result->GetInt(0);
+	}
+	return data;
+}
+
+static_function void ProcessTimeResults(const PendingTime &pending, std::vector<ISQLQuery *> &queries)
+{
+	if (pending.runIDQueryIndex)
+	{
+		ISQLResult *result = queries[pending.runIDQueryIndex]->GetResultSet();
+		if (result->FetchRow())
+		{
+			KZ::Database::SetRunID(pending.courseID, pending.modeID, pending.steamID, pending.time, result->GetInt64(0));
+		}
+	}
+	KZ::timer::UpdateLocalRankData(pending.id, pending.ranked ? pending.rankData : ReadRankData(pending, queries));
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(pending.userID);
+	if (player)
+	{
+		player->timerService->UpdateLocalPBCache();
+	}
+}
+
+static_function void AddPersonalBestUpdates(Transaction &txn, const PendingTime &pending)
+{
+	bool mysql = KZDatabaseService::GetDatabaseType() == DatabaseType::MySQL;
+	txn.queries.push_back(Statement(mysql ? mysql_pbs_update : sqlite_pbs_update)
+							  .Bind(pending.steamID)
+							  .Bind(pending.courseID)
+							  .Bind(pending.modeID)
+							  .Bind(pending.styleIDs)
+							  .Get());
+	if (pending.teleportsUsed == 0)
+	{
+		txn.queries.push_back(Statement(mysql ? mysql_pbs_update_pro : sqlite_pbs_update_pro)
+								  .Bind(pending.steamID)
+								  .Bind(pending.courseID)
+								  .Bind(pending.modeID)
+								  .Bind(pending.styleIDs)
+								  .Get());
+	}
+}
+
+static_function void ExecuteTimeBatch(std::vector<PendingTime> times)
+{
+	if (!KZDatabaseService::IsReady())
+	{
+		return;
+	}
+	// All times go into a single insert followed by the personal best updates,
+	// the queries of every unstyled run come last so they already see every new time.
+	// Runs already ranked by the in memory leaderboards only need the ID of their time if it is a new personal best.
 	Transaction txn;
-	V_snprintf(query, sizeof(query), sql_times_insert, steamID, course->localDatabaseID, modeID, styleIDs, time, teleportsUsed, metadata.Get());
-	txn.queries.push_back(query);
-	if (styleIDs != 0)
+	std::string insert = sql_times_insert_batch;
+	for (size_t i = 0; i < times.size(); i++)
 	{
-		KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(txn, OnGenericTxnSuccess, OnGenericTxnFailure);
+		const PendingTime &pending = times[i];
+		if (i != 0)
+		{
+			insert += ", ";
+		}
+		Statement row = Statement(sql_times_insert_batch_row)
+							.Bind(pending.steamID)
+							.Bind(pending.courseID)
+							.Bind(pending.modeID)
+							.Bind(pending.styleIDs)
+							.Bind(pending.time)
+							.Bind(pending.teleportsUsed)
+							.Bind(pending.metadata);
+		const std::string &values = row.Get();
+		if (!row.IsValid())
+		{
+			// Leave the insert empty so the whole transaction is refused, the failure callback retries every time on its own.
+			insert.clear();
+			break;
+		}
+		insert += values;
 	}
-	else
+	txn.queries.push_back(insert);
+	for (const PendingTime &pending : times)
 	{
-		// Get Top 2 PRO PBs
-		V_snprintf(query, sizeof(query), sql_getpb, course->localDatabaseID, steamID, modeID, styleIDs, 2);
-		txn.queries.push_back(query);
+		AddPersonalBestUpdates(txn, pending);
+	}
+
+	bool hasUnstyledTimes = false;
+	for (PendingTime &pending : times)
+	{
+		if (pending.styleIDs != 0)
+		{
+			continue;
+		}
+		hasUnstyledTimes = true;
+		if (pending.ranked)
+		{
+			const KZ::timer::LocalRankData &data = pending.rankData;
+			if (data.firstTime || data.pbDiff < 0 || (pending.teleportsUsed == 0 && (data.firstTimePro || data.pbDiffPro < 0)))
+			{
+				pending.runIDQueryIndex = txn.queries.size();
+				txn.queries.push_back(
+					Statement(sql_times_findid).Bind(pending.steamID).Bind(pending.courseID).Bind(pending.modeID).Bind(pending.time).Get());
+			}
+			continue;
+		}
+		pending.rankQueryIndex = txn.queries.size();
+		// Get Top 2 PBs
+		txn.queries.push_back(
+			Statement(sql_getpb).Bind(pending.courseID).Bind(pending.steamID).Bind(pending.modeID).Bind(pending.styleIDs).Bind(2).Get());
 		// Get Rank
-		V_snprintf(query, sizeof(query), sql_getmaprank, course->localDatabaseID, modeID, steamID, course->localDatabaseID, modeID);
-		txn.queries.push_back(query);
+		txn.queries.push_back(Statement(sql_getmaprank)
+								  .Bind(pending.courseID)
+								  .Bind(pending.modeID)
+								  .Bind(pending.steamID)
+								  .Bind(pending.courseID)
+								  .Bind(pending.modeID)
+								  .Get());
 		// Get Number of Players with Times
-		V_snprintf(query, sizeof(query), sql_getlowestmaprank, course->localDatabaseID, modeID);
-		txn.queries.push_back(query);
-		if (teleportsUsed == 0)
+		txn.queries.push_back(Statement(sql_getlowestmaprank).Bind(pending.courseID).Bind(pending.modeID).Get());
+		if (pending.teleportsUsed == 0)
 		{
 			// Get Top 2 PRO PBs
-			V_snprintf(query, sizeof(query), sql_getpbpro, course->localDatabaseID, steamID, modeID, styleIDs, 2);
-			txn.queries.push_back(query);
+			txn.queries.push_back(
+				Statement(sql_getpbpro).Bind(pending.courseID).Bind(pending.steamID).Bind(pending.modeID).Bind(pending.styleIDs).Bind(2).Get());
 			// Get PRO Rank
-			V_snprintf(query, sizeof(query), sql_getmaprankpro, course->localDatabaseID, modeID, steamID, course->localDatabaseID, modeID);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement(sql_getmaprankpro)
+									  .Bind(pending.courseID)
+									  .Bind(pending.modeID)
+									  .Bind(pending.steamID)
+									  .Bind(pending.courseID)
+									  .Bind(pending.modeID)
+									  .Get());
 			// Get Number of Players with Times
-			V_snprintf(query, sizeof(query), sql_getlowestmaprankpro, course->localDatabaseID, modeID);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement(sql_getlowestmaprankpro).Bind(pending.courseID).Bind(pending.modeID).Get());
 		}
-		KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
-			txn,
-			[=](std::vector<ISQLQuery *> queries)
+	}
+
+	// clang-format off
+	KZDatabaseService::ExecuteTransaction(
+		txn,
+		[times, hasUnstyledTimes](std::vector<ISQLQuery *> queries)
+		{
+			if (!hasUnstyledTimes)
 			{
-				KZPlayer *player = g_pKZPlayerManager->ToPlayer(userID);
-				KZ::timer::LocalRankData data;
-				ISQLResult *result = queries[1]->GetResultSet();
-				data.firstTime = result->GetRowCount() == 1;
-				if (!data.firstTime)
+				KZDatabaseService::OnGenericTxnSuccess(queries);
+				return;
+			}
+			for (const PendingTime &pending : times)
+			{
+				if (pending.styleIDs == 0)
 				{
-					result->FetchRow();
-					f32 pb = result->GetFloat(0);
-					// Close enough. New time is new PB.
-					if (fabs(pb - time) < EPSILON)
-					{
-						result->FetchRow();
-						f32 oldPB = result->GetFloat(0);
-						data.pbDiff = time - oldPB;
-					}
-					else // Didn't beat PB
-					{
-						data.pbDiff = time - pb;
-					}
+					ProcessTimeResults(pending, queries);
 				}
-				// Get NUB Rank
-				result = queries[2]->GetResultSet();
-				result->FetchRow();
-				data.rank = result->GetInt(0);
-				result = queries[3]->GetResultSet();
-				result->FetchRow();
-				data.maxRank = result->GetInt(0);
-
-				if (teleportsUsed == 0)
+			}
+			KZTimerService::UpdateLocalRecordCache();
+		},
+		[times](std::string error, int failIndex)
+		{
+			KZDatabaseService::OnGenericTxnFailure(error, failIndex);
+			// Don't let one bad row throw away every other time of the batch.
+			if (times.size() > 1)
+			{
+				for (const PendingTime &pending : times)
 				{
-					ISQLResult *result = queries[4]->GetResultSet();
-					data.firstTimePro = result->GetRowCount() == 1;
-					if (!data.firstTimePro)
-					{
-						result->FetchRow();
-						f32 pb = result->GetFloat(0);
-						// Close enough. New time is new PB.
-						if (fabs(pb - time) < EPSILON)
-						{
-							result->FetchRow();
-							f32 oldPB = result->GetFloat(0);
-							data.pbDiffPro = time - oldPB;
-						}
-						else // Didn't beat PB
-						{
-							data.pbDiffPro = time - pb;
-						}
-					}
-					// Get PRO rank
-					result = queries[5]->GetResultSet();
-					result->FetchRow();
-					data.rankPro = result->GetInt(0);
-					result = queries[6]->GetResultSet();
-					result->FetchRow();
-					data.maxRankPro = result->GetInt(0);
+					ExecuteTimeBatch({pending});
 				}
-				KZ::timer::UpdateLocalRankData(id, data);
-				player->timerService->UpdateLocalPBCache();
-				KZTimerService::UpdateLocalRecordCache();
-			},
-			OnGenericTxnFailure);
+				return;
+			}
+			// The time is lost for good, it can't stay in the leaderboards either.
+			const PendingTime &pending = times[0];
+			if (pending.styleIDs == 0)
+			{
+				KZ::Database::RevokeTime(pending.courseID, pending.modeID, pending.steamID, pending.time);
+			}
+		});
+	// clang-format on
+}
+
+void KZDatabaseService::FlushTimes()
+{
+	if (pendingTimes.empty())
+	{
+		return;
+	}
+	std::vector<PendingTime> times;
+	times.swap(pendingTimes);
+	ExecuteTimeBatch(std::move(times));
+}
+
+static_function f64 FlushTimesTimer()
+{
+	KZDatabaseService::FlushTimes();
+	return batchInterval;
+}
+
+void KZDatabaseService::InitTimeBatching()
+{
+	maxBatchSize = (u32)MAX(KZOptionService::GetOptionInt("dbWriteBatchSize", KZ_DB_DEFAULT_WRITE_BATCH_SIZE), 1);
+	batchInterval = MAX(KZOptionService::GetOptionFloat("dbWriteBatchInterval", KZ_DB_DEFAULT_WRITE_BATCH_INTERVAL), 0.01);
+	if (!flushTimer)
+	{
+		flushTimer = StartTimer(FlushTimesTimer, batchInterval, true, true);
 	}
 }
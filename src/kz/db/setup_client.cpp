@@ -1,5 +1,6 @@
 #include "kz_db.h"
 #include "kz/option/kz_option.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 #include "queries/players.h"
@@ -17,11 +18,9 @@ void KZDatabaseService::SetupClient()
 		return;
 	}
 	// Setup Client Step 1 - Upsert them into Players Table
-	char query[1024];
 
 	// Note: The player must have been authenticated and have a valid steamID at this point.
 	const char *clientName = this->player->GetName();
-	std::string escapedName = GetDatabaseConnection()->Escape(clientName);
 	u64 steamID64 = this->player->GetClient()->GetClientSteamID()->ConvertToUint64();
 	const char *clientIP = this->player->GetIpAddress();
 
@@ -32,27 +31,23 @@ void KZDatabaseService::SetupClient()
 		case DatabaseType::SQLite:
 		{
 			// UPDATE OR IGNORE
-			V_snprintf(query, sizeof(query), sqlite_players_update, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement(sqlite_players_update).Bind(clientName).Bind(clientIP).Bind(steamID64).Get());
 			// INSERT OR IGNORE
-			V_snprintf(query, sizeof(query), sqlite_players_insert, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement(sqlite_players_insert).Bind(clientName).Bind(clientIP).Bind(steamID64).Get());
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
 			// INSERT ... ON DUPLICATE KEY ...
-			V_snprintf(query, sizeof(query), mysql_players_upsert, escapedName.c_str(), clientIP, steamID64);
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement(mysql_players_upsert).Bind(clientName).Bind(clientIP).Bind(steamID64).Get());
 			break;
 		}
 	}
 
-	V_snprintf(query, sizeof(query), sql_players_get_infos, steamID64);
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement(sql_players_get_infos).Bind(steamID64).Get());
 	CPlayerUserId userID = this->player->GetClient()->GetUserID();
 
-	GetDatabaseConnection()->ExecuteTransaction(
+	ExecuteTransaction(
 		txn,
 		[&, userID, steamID64](std::vector<ISQLQuery *> queries)
 		{
@@ -1,5 +1,7 @@
 #include "kz_db.h"
+#include "leaderboard.h"
 #include "queries/maps.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 /*
@@ -20,6 +22,7 @@ bool KZDatabaseService::IsMapSetUp()
 void KZDatabaseService::SetupMap()
 {
 	mapSetUp = false;
+	KZ::Database::ResetLeaderboards();
 	if (!KZDatabaseService::IsReady())
 	{
 		META_CONPRINTF("[KZ::DB] Warning: SetupMap called too early.\n");
@@ -27,38 +30,31 @@ void KZDatabaseService::SetupMap()
 	}
 
 	Transaction txn;
-	char query[1024];
 	CUtlString mapName = g_pKZUtils->GetServerGlobals()->mapname.ToCStr();
-	auto escapedMapName = KZDatabaseService::GetDatabaseConnection()->Escape(mapName.Get());
 	auto databaseType = KZDatabaseService::GetDatabaseType();
 	switch (databaseType)
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_maps_insert, escapedMapName.c_str());
-			txn.queries.push_back(query);
-			V_snprintf(query, sizeof(query), sqlite_maps_update, escapedMapName.c_str());
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement(sqlite_maps_insert).Bind(mapName.Get()).Get());
+			txn.queries.push_back(Statement(sqlite_maps_update).Bind(mapName.Get()).Get());
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_maps_upsert, escapedMapName.c_str());
-			txn.queries.push_back(query);
+			txn.queries.push_back(Statement(mysql_maps_upsert).Bind(mapName.Get()).Get());
 			break;
 		}
 		default:
 		{
 			// This shouldn't happen.
-			query[0] = 0;
 			break;
 		}
 	}
 
-	V_snprintf(query, sizeof(query), sql_maps_findid, escapedMapName.c_str(), escapedMapName.c_str());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement(sql_maps_findid).Bind(mapName.Get()).Bind(mapName.Get()).Get());
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
+	KZDatabaseService::ExecuteTransaction(
 		txn, 
 		[databaseType, mapName](std::vector<ISQLQuery *> queries) 
 		{
@@ -97,6 +93,7 @@ void KZDatabaseService::SetupMap()
 			mapSetUp = true;
 			META_CONPRINTF("[KZ::DB] Map setup successful for %s, current map ID: %i\n", currentMapName, KZDatabaseService::currentMapID);
 			CALL_FORWARD(eventListeners, OnMapSetup);
+			KZDatabaseService::LoadLeaderboards();
 		},
 		OnGenericTxnFailure);
 	// clang-format on
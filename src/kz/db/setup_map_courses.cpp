@@ -3,6 +3,7 @@
 
 #include "queries/courses.h"
 
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 using namespace KZ::Database;
@@ -16,38 +17,40 @@ bool KZDatabaseService::AreCoursesSetUp()
 
 void KZDatabaseService::SetupCourses(CUtlVector<KZCourse> &courses)
 {
-	char query[1024];
 	Transaction txn;
 	FOR_EACH_VEC(courses, i)
 	{
 		KZCourse &course = courses[i];
-		std::string cleanCourseName = KZDatabaseService::GetDatabaseConnection()->Escape(course.GetName());
 		switch (databaseType)
 		{
 			case DatabaseType::SQLite:
 			{
-				V_snprintf(query, sizeof(query), sqlite_mapcourses_insert, KZDatabaseService::GetMapID(), cleanCourseName.c_str(), course.id);
-				txn.queries.push_back(query);
+				txn.queries.push_back(Statement(sqlite_mapcourses_insert)
+									  .Bind(KZDatabaseService::GetMapID())
+									  .Bind(course.GetName())
+									  .Bind(course.id)
+									  .Get());
 				break;
 			}
 			case DatabaseType::MySQL:
 			{
-				V_snprintf(query, sizeof(query), mysql_mapcourses_insert, KZDatabaseService::GetMapID(), cleanCourseName.c_str(), course.id);
-				txn.queries.push_back(query);
+				txn.queries.push_back(Statement(mysql_mapcourses_insert)
+									  .Bind(KZDatabaseService::GetMapID())
+									  .Bind(course.GetName())
+									  .Bind(course.id)
+									  .Get());
 				break;
 			}
 			default:
 			{
 				// This shouldn't happen.
-				query[0] = 0;
 				break;
 			}
 		}
 	}
-	V_snprintf(query, sizeof(query), sql_mapcourses_findall, KZDatabaseService::GetMapID());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement(sql_mapcourses_findall).Bind(KZDatabaseService::GetMapID()).Get());
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
+	KZDatabaseService::ExecuteTransaction(
 		txn,
 		[](std::vector<ISQLQuery *> queries) 
 		{
@@ -1,6 +1,7 @@
 #include "kz_db.h"
 #include "kz/mode/kz_mode.h"
 #include "queries/modes.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 using namespace KZ::Database;
@@ -31,31 +32,28 @@ void KZDatabaseService::InsertAndUpdateModeIDs(CUtlString modeName, CUtlString s
 		return;
 	}
 	Transaction txn;
-	char query[1024];
 	switch (KZDatabaseService::GetDatabaseType())
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_modes_insert, modeName.Get(), shortName.Get());
+			txn.queries.push_back(Statement(sqlite_modes_insert).Bind(modeName.Get()).Bind(shortName.Get()).Get());
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_modes_insert, modeName.Get(), shortName.Get());
+			txn.queries.push_back(Statement(mysql_modes_insert).Bind(modeName.Get()).Bind(shortName.Get()).Get());
 			break;
 		}
 		default:
 		{
 			// Should never happen.
-			query[0] = 0;
+			txn.queries.push_back("");
 		}
 	}
-	txn.queries.push_back(query);
 
-	V_snprintf(query, sizeof(query), sql_modes_findid, modeName.Get());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement(sql_modes_findid).Bind(modeName.Get()).Get());
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
+	KZDatabaseService::ExecuteTransaction(
 		txn, 
 		[modeName](std::vector<ISQLQuery *> queries) 
 		{
@@ -1,6 +1,7 @@
 #include "kz_db.h"
 #include "kz/style/kz_style.h"
 #include "queries/styles.h"
+#include "statement.h"
 #include "vendor/sql_mm/src/public/sql_mm.h"
 
 using namespace KZ::Database;
@@ -31,31 +32,28 @@ void KZDatabaseService::InsertAndUpdateStyleIDs(CUtlString styleName, CUtlString
 		return;
 	}
 	Transaction txn;
-	char query[1024];
 	switch (KZDatabaseService::GetDatabaseType())
 	{
 		case DatabaseType::SQLite:
 		{
-			V_snprintf(query, sizeof(query), sqlite_styles_insert, styleName.Get(), shortName.Get());
+			txn.queries.push_back(Statement(sqlite_styles_insert).Bind(styleName.Get()).Bind(shortName.Get()).Get());
 			break;
 		}
 		case DatabaseType::MySQL:
 		{
-			V_snprintf(query, sizeof(query), mysql_styles_insert, styleName.Get(), shortName.Get());
+			txn.queries.push_back(Statement(mysql_styles_insert).Bind(styleName.Get()).Bind(shortName.Get()).Get());
 			break;
 		}
 		default:
 		{
 			// Should never happen.
-			query[0] = 0;
+			txn.queries.push_back("");
 		}
 	}
-	txn.queries.push_back(query);
 
-	V_snprintf(query, sizeof(query), sql_styles_findid, styleName.Get());
-	txn.queries.push_back(query);
+	txn.queries.push_back(Statement(sql_styles_findid).Bind(styleName.Get()).Get());
 	// clang-format off
-	KZDatabaseService::GetDatabaseConnection()->ExecuteTransaction(
+	KZDatabaseService::ExecuteTransaction(
 		txn, 
 		[styleName](std::vector<ISQLQuery *> queries) 
 		{
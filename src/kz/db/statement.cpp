@@ -0,0 +1,213 @@
+#include "kz_db.h"
+#include "statement.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include <unordered_map>
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::Database;
+
+#define DEFAULT_FLOAT_PRECISION 6
+
+struct Segment
+{
+	// Literal text in front of the parameter.
+	std::string literal;
+	ParamType type;
+	u8 precision;
+};
+
+struct KZ::Database::CompiledStatement
+{
+	const char *source;
+	CUtlVector<Segment> segments;
+	size_t literalLength;
+	// The template has a format specifier that can't be bound.
+	bool invalid;
+};
+
+// Keyed by the address of the constexpr query template.
+static_global std::unordered_map<const char *, CompiledStatement *> statementCache;
+
+static_function CompiledStatement *Compile(const char *queryTemplate)
+{
+	CompiledStatement *compiled = new CompiledStatement();
+	compiled->source = queryTemplate;
+	compiled->literalLength = 0;
+	compiled->invalid = false;
+
+	Segment segment {"", ParamType::End, 0};
+	for (const char *c = queryTemplate; *c; c++)
+	{
+		if (*c != '%')
+		{
+			segment.literal += *c;
+			continue;
+		}
+		if (c[1] == '%')
+		{
+			segment.literal += '%';
+			c++;
+			continue;
+		}
+
+		const char *start = c++;
+		u8 precision = DEFAULT_FLOAT_PRECISION;
+		if (*c == '.')
+		{
+			precision = (u8)strtoul(c + 1, (char **)&c, 10);
+		}
+		u32 longs = 0;
+		while (*c == 'l')
+		{
+			longs++;
+			c++;
+		}
+		switch (*c)
+		{
+			case 'd':
+			case 'i':
+				segment.type = longs >= 2 ? ParamType::Int64 : ParamType::Int;
+				break;
+			case 'u':
+				segment.type = longs >= 2 ? ParamType::UInt64 : ParamType::UInt;
+				break;
+			case 'f':
+				segment.type = ParamType::Float;
+				segment.precision = precision;
+				break;
+			case 's':
+				segment.type = ParamType::String;
+				break;
+			default:
+			{
+				META_CONPRINTF("[KZ::DB] Unsupported format specifier at offset %i of query: %s\n", (i32)(start - queryTemplate), queryTemplate);
+				compiled->invalid = true;
+				segment.literal.append(start, c - start + (*c ? 1 : 0));
+				if (!*c)
+				{
+					c--;
+				}
+				continue;
+			}
+		}
+		compiled->literalLength += segment.literal.length();
+		compiled->segments.AddToTail(segment);
+		segment = {"", ParamType::End, 0};
+	}
+	compiled->literalLength += segment.literal.length();
+	compiled->segments.AddToTail(segment);
+	return compiled;
+}
+
+void KZ::Database::ClearStatementCache()
+{
+	for (auto &entry : statementCache)
+	{
+		delete entry.second;
+	}
+	statementCache.clear();
+}
+
+Statement::Statement(const char *queryTemplate)
+{
+	auto it = statementCache.find(queryTemplate);
+	if (it == statementCache.end())
+	{
+		it = statementCache.emplace(queryTemplate, Compile(queryTemplate)).first;
+	}
+	this->compiled = it->second;
+	this->valid = !this->compiled->invalid;
+	// Most parameters are short numbers, leave some room for them.
+	this->query.reserve(this->compiled->literalLength + 16 * this->compiled->segments.Count());
+}
+
+void Statement::Invalidate()
+{
+	this->valid = false;
+	this->query.clear();
+}
+
+bool Statement::NextParam(bool (*matches)(ParamType), const char *typeName)
+{
+	if (!this->valid)
+	{
+		return false;
+	}
+	if (this->nextParam + 1 >= (u32)this->compiled->segments.Count())
+	{
+		META_CONPRINTF("[KZ::DB] Too many parameters bound to query: %s\n", this->compiled->source);
+		this->Invalidate();
+		return false;
+	}
+	const Segment &segment = this->compiled->segments[this->nextParam++];
+	if (!matches(segment.type))
+	{
+		META_CONPRINTF("[KZ::DB] Parameter %u bound as %s does not match query: %s\n", this->nextParam, typeName, this->compiled->source);
+		this->Invalidate();
+		return false;
+	}
+	this->query += segment.literal;
+	return true;
+}
+
+Statement &Statement::BindSigned(i64 value)
+{
+	if (this->NextParam([](ParamType type) { return type != ParamType::Float && type != ParamType::String; }, "integer"))
+	{
+		this->query += std::to_string(value);
+	}
+	return *this;
+}
+
+Statement &Statement::BindUnsigned(u64 value)
+{
+	if (this->NextParam([](ParamType type) { return type != ParamType::Float && type != ParamType::String; }, "integer"))
+	{
+		this->query += std::to_string(value);
+	}
+	return *this;
+}
+
+Statement &Statement::Bind(f64 value)
+{
+	if (this->NextParam([](ParamType type) { return type == ParamType::Float; }, "float"))
+	{
+		char buffer[64];
+		V_snprintf(buffer, sizeof(buffer), "%.*f", this->compiled->segments[this->nextParam - 1].precision, value);
+		this->query += buffer;
+	}
+	return *this;
+}
+
+Statement &Statement::Bind(const char *value)
+{
+	if (this->NextParam([](ParamType type) { return type == ParamType::String; }, "string"))
+	{
+		this->query += KZDatabaseService::GetDatabaseConnection()->Escape(value ? value : "");
+	}
+	return *this;
+}
+
+const std::string &Statement::Get()
+{
+	if (!this->valid)
+	{
+		return this->query;
+	}
+	// Only append the last literal once, Get can be called several times.
+	u32 count = this->compiled->segments.Count();
+	if (this->nextParam < count)
+	{
+		if (this->nextParam + 1 != count)
+		{
+			META_CONPRINTF("[KZ::DB] Query expects %u parameters but %u were bound: %s\n", count - 1, this->nextParam, this->compiled->source);
+			this->Invalidate();
+			return this->query;
+		}
+		this->query += this->compiled->segments.Tail().literal;
+		this->nextParam = count;
+	}
+	return this->query;
+}
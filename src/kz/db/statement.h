@@ -0,0 +1,80 @@
+// Query templates in queries/*.h are printf style format strings. Instead of running them through V_snprintf every time,
+// every template is compiled once into literal segments and typed parameters, and values are bound by type.
+// String parameters are always escaped with the current connection.
+// A statement whose bound values don't match its template is invalid, Get returns an empty query for it and
+// KZDatabaseService::ExecuteTransaction refuses to run a transaction containing one.
+
+#pragma once
+#include "common.h"
+#include <string>
+#include <type_traits>
+
+namespace KZ
+{
+	namespace Database
+	{
+		enum class ParamType : u8
+		{
+			Int,      // %d %i
+			UInt,     // %u %lu
+			Int64,    // %lld
+			UInt64,   // %llu
+			Float,    // %f %.Nf
+			String,   // %s
+			End       // No parameter, last literal segment of the query.
+		};
+
+		struct CompiledStatement;
+
+		class Statement
+		{
+		public:
+			Statement(const char *queryTemplate);
+
+			template<typename T>
+			std::enable_if_t<std::is_integral_v<T>, Statement &> Bind(T value)
+			{
+				if constexpr (std::is_signed_v<T>)
+				{
+					return this->BindSigned(value);
+				}
+				else
+				{
+					return this->BindUnsigned(value);
+				}
+			}
+
+			Statement &Bind(f64 value);
+			Statement &Bind(const char *value);
+
+			Statement &Bind(const std::string &value)
+			{
+				return this->Bind(value.c_str());
+			}
+
+			// Returns the final query, every parameter must have been bound. Empty if the statement is invalid.
+			const std::string &Get();
+
+			bool IsValid() const
+			{
+				return this->valid;
+			}
+
+		private:
+			const CompiledStatement *compiled;
+			u32 nextParam {};
+			bool valid = true;
+			std::string query;
+
+			void Invalidate();
+
+			Statement &BindSigned(i64 value);
+			Statement &BindUnsigned(u64 value);
+			// Append the literal in front of the next parameter and check that it has the expected type.
+			bool NextParam(bool (*matches)(ParamType), const char *typeName);
+		};
+
+		// Free every compiled template, called when the database is shut down.
+		void ClearStatementCache();
+	} // namespace Database
+} // namespace KZ
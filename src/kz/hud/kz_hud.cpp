@@ -4,11 +4,13 @@
 #include "sdk/datatypes.h"
 #include "utils/utils.h"
 #include "utils/simplecmds.h"
+#include "utils/perf.h"
 
 #include "kz/option/kz_option.h"
 #include "kz/timer/kz_timer.h"
 #include "kz/language/kz_language.h"
 #include "kz/checkpoint/kz_checkpoint.h"
+#include "kz/replays/kz_replays.h"
 
 #include "tier0/memdbgon.h"
 
@@ -39,74 +41,148 @@ void KZHUDService::Reset()
 	this->showPanel = this->player->optionService->GetPreferenceBool("showPanel", true);
 	this->timerStoppedTime = {};
 	this->currentTimeWhenTimerStopped = {};
+	this->InvalidatePanel();
 }
 
-std::string KZHUDService::GetSpeedText(const char *language)
+#define HUD_KEY_LEFT    (1 << 0)
+#define HUD_KEY_FORWARD (1 << 1)
+#define HUD_KEY_BACK    (1 << 2)
+#define HUD_KEY_RIGHT   (1 << 3)
+#define HUD_KEY_DUCK    (1 << 4)
+#define HUD_KEY_JUMP    (1 << 5)
+
+void KZHUDService::GetPanelInputs(const char *language, PanelInputs &inputs)
 {
+	V_memset(&inputs, 0, sizeof(inputs));
+	inputs.source = this->player;
+	V_strncpy(inputs.language, language, sizeof(inputs.language));
+
+	inputs.keys |= this->player->IsButtonPressed(IN_MOVELEFT) ? HUD_KEY_LEFT : 0;
+	inputs.keys |= this->player->IsButtonPressed(IN_FORWARD) ? HUD_KEY_FORWARD : 0;
+	inputs.keys |= this->player->IsButtonPressed(IN_BACK) ? HUD_KEY_BACK : 0;
+	inputs.keys |= this->player->IsButtonPressed(IN_MOVERIGHT) ? HUD_KEY_RIGHT : 0;
+	inputs.keys |= this->player->IsButtonPressed(IN_DUCK) ? HUD_KEY_DUCK : 0;
+	inputs.keys |= this->player->IsButtonPressed(IN_JUMP) ? HUD_KEY_JUMP : 0;
+
+	inputs.currentCpIndex = this->player->checkpointService->GetCurrentCpIndex();
+	inputs.checkpointCount = this->player->checkpointService->GetCheckpointCount();
+	inputs.teleportCount = this->player->checkpointService->GetTeleportCount();
+
+	inputs.timerRunning = this->player->timerService->GetTimerRunning();
+	inputs.showTimer = inputs.timerRunning || this->ShouldShowTimerAfterStop();
+	if (inputs.showTimer)
+	{
+		f64 time = inputs.timerRunning ? this->player->timerService->GetTime() : this->currentTimeWhenTimerStopped;
+		// Compare the formatted time rather than the raw one, the text only changes once per displayed millisecond.
+		KZTimerService::FormatTime(time, inputs.timeText, sizeof(inputs.timeText));
+		inputs.paused = this->player->timerService->GetPaused();
+		f64 ghostDelta;
+		if (inputs.timerRunning && this->player->replayService->GetGhostDelta(ghostDelta))
+		{
+			KZTimerService::FormatDiffTime(ghostDelta, inputs.ghostDeltaText, sizeof(inputs.ghostDeltaText));
+		}
+	}
+
 	Vector velocity;
 	this->player->GetVelocity(&velocity);
+	inputs.speed = RoundFloatToInt(velocity.Length2D());
 	// Keep the takeoff velocity on for a while after landing so the speed values flicker less.
-	if ((this->player->GetPlayerPawn()->m_fFlags & FL_ONGROUND
-		 && g_pKZUtils->GetServerGlobals()->curtime - this->player->landingTime > HUD_ON_GROUND_THRESHOLD)
-		|| (this->player->GetPlayerPawn()->m_MoveType == MOVETYPE_LADDER && !player->IsButtonPressed(IN_JUMP)))
+	inputs.showTakeoff = !((this->player->GetPlayerPawn()->m_fFlags & FL_ONGROUND
+							&& g_pKZUtils->GetServerGlobals()->curtime - this->player->landingTime > HUD_ON_GROUND_THRESHOLD)
+						   || (this->player->GetPlayerPawn()->m_MoveType == MOVETYPE_LADDER && !this->player->IsButtonPressed(IN_JUMP)));
+	if (inputs.showTakeoff)
 	{
-		return KZLanguageService::PrepareMessageWithLang(language, "HUD - Speed Text", velocity.Length2D());
+		inputs.takeoffSpeed = RoundFloatToInt(this->player->takeoffVelocity.Length2D());
 	}
-	return KZLanguageService::PrepareMessageWithLang(language, "HUD - Speed Text (Takeoff)", velocity.Length2D(),
-													 this->player->takeoffVelocity.Length2D());
 }
 
-std::string KZHUDService::GetKeyText(const char *language)
+void KZHUDService::GetSpeedText(const PanelInputs &inputs, char *buffer, u32 size)
+{
+	if (!inputs.showTakeoff)
+	{
+		KZLanguageService::FormatMessageWithLang(buffer, size, inputs.language, "HUD - Speed Text", (f32)inputs.speed);
+		return;
+	}
+	KZLanguageService::FormatMessageWithLang(buffer, size, inputs.language, "HUD - Speed Text (Takeoff)", (f32)inputs.speed,
+		(f32)inputs.takeoffSpeed);
+}
+
+void KZHUDService::GetKeyText(const PanelInputs &inputs, char *buffer, u32 size)
 {
 	// clang-format off
 
-	return KZLanguageService::PrepareMessageWithLang(language, "HUD - Key Text",
-		this->player->IsButtonPressed(IN_MOVELEFT) ? 'A' : '_',
-		this->player->IsButtonPressed(IN_FORWARD) ? 'W' : '_',
-		this->player->IsButtonPressed(IN_BACK) ? 'S' : '_',
-		this->player->IsButtonPressed(IN_MOVERIGHT) ? 'D' : '_',
-		this->player->IsButtonPressed(IN_DUCK) ? 'C' : '_',
-		this->player->IsButtonPressed(IN_JUMP) ? 'J' : '_'
+	KZLanguageService::FormatMessageWithLang(buffer, size, inputs.language, "HUD - Key Text",
+		inputs.keys & HUD_KEY_LEFT ? 'A' : '_',
+		inputs.keys & HUD_KEY_FORWARD ? 'W' : '_',
+		inputs.keys & HUD_KEY_BACK ? 'S' : '_',
+		inputs.keys & HUD_KEY_RIGHT ? 'D' : '_',
+		inputs.keys & HUD_KEY_DUCK ? 'C' : '_',
+		inputs.keys & HUD_KEY_JUMP ? 'J' : '_'
 	);
 
 	// clang-format on
 }
 
-std::string KZHUDService::GetCheckpointText(const char *language)
+void KZHUDService::GetCheckpointText(const PanelInputs &inputs, char *buffer, u32 size)
 {
 	// clang-format off
 
-	return KZLanguageService::PrepareMessageWithLang(language, "HUD - Checkpoint Text",
-		this->player->checkpointService->GetCurrentCpIndex(),
-		this->player->checkpointService->GetCheckpointCount(),
-		this->player->checkpointService->GetTeleportCount()
+	KZLanguageService::FormatMessageWithLang(buffer, size, inputs.language, "HUD - Checkpoint Text",
+		inputs.currentCpIndex,
+		inputs.checkpointCount,
+		inputs.teleportCount
 	);
 
 	// clang-format on
 }
 
-std::string KZHUDService::GetTimerText(const char *language)
+void KZHUDService::GetTimerText(const PanelInputs &inputs, char *buffer, u32 size)
 {
-	if (this->player->timerService->GetTimerRunning() || this->ShouldShowTimerAfterStop())
+	if (!inputs.showTimer)
 	{
-		char timeText[128];
-
-		// clang-format off
-
-		f64 time = this->player->timerService->GetTimerRunning()
-			? player->timerService->GetTime()
-			: this->currentTimeWhenTimerStopped;
-
+		buffer[0] = '\0';
+		return;
+	}
+	char timeText[128];
+	V_strncpy(timeText, inputs.timeText, sizeof(timeText));
+	if (inputs.ghostDeltaText[0])
+	{
+		char deltaText[64];
+		KZLanguageService::FormatMessageWithLang(deltaText, sizeof(deltaText), inputs.language, "HUD - Ghost Delta Text",
+												 inputs.ghostDeltaText);
+		V_strncat(timeText, deltaText, sizeof(timeText));
+	}
+	char stoppedText[64] {};
+	if (!inputs.timerRunning)
+	{
+		KZLanguageService::FormatMessageWithLang(stoppedText, sizeof(stoppedText), inputs.language, "HUD - Stopped Text");
+	}
+	char pausedText[64] {};
+	if (inputs.paused)
+	{
+		KZLanguageService::FormatMessageWithLang(pausedText, sizeof(pausedText), inputs.language, "HUD - Paused Text");
+	}
+	KZLanguageService::FormatMessageWithLang(buffer, size, inputs.language, "HUD - Timer Text", timeText, stoppedText, pausedText);
+}
 
-		KZTimerService::FormatTime(time, timeText, sizeof(timeText));
-		return KZLanguageService::PrepareMessageWithLang(language, "HUD - Timer Text",
-			timeText,
-			player->timerService->GetTimerRunning() ? "" : KZLanguageService::PrepareMessageWithLang(language, "HUD - Stopped Text").c_str(),
-			player->timerService->GetPaused() ? KZLanguageService::PrepareMessageWithLang(language, "HUD - Paused Text").c_str() : ""
-		);
-		// clang-format on
+// Renders one panel template over the cached text, returns whether the text changed.
+static_function bool UpdatePanelText(char *buffer, u32 size, const char *language, const char *message, const char *keyText,
+									 const char *checkpointText, const char *timerText, const char *speedText)
+{
+	char newText[KZ_HUD_PANEL_TEXT_SIZE];
+	u32 length = KZLanguageService::FormatMessageWithLang(newText, sizeof(newText), language, message, keyText, checkpointText, timerText,
+														  speedText);
+	// Remove trailing newlines just in case a line is empty.
+	for (length = MIN(length, sizeof(newText) - 1); length > 0 && newText[length - 1] == '\n'; length--)
+	{
+		newText[length - 1] = '\0';
 	}
-	return std::string("");
+	if (!V_strcmp(buffer, newText))
+	{
+		return false;
+	}
+	V_strncpy(buffer, newText, size);
+	return true;
 }
 
 void KZHUDService::DrawPanels(KZPlayer *player, KZPlayer *target)
@@ -115,42 +191,65 @@ void KZHUDService::DrawPanels(KZPlayer *player, KZPlayer *target)
 	{
 		return;
 	}
-	const char *language = target->languageService->GetLanguage();
+	KZ_PROFILE(__func__);
+	PanelCache &cache = target->hudService->panelCache;
 
-	std::string keyText = player->hudService->GetKeyText(language);
-	std::string checkpointText = player->hudService->GetCheckpointText(language);
-	std::string timerText = player->hudService->GetTimerText(language);
-	std::string speedText = player->hudService->GetSpeedText(language);
+	PanelInputs inputs;
+	player->hudService->GetPanelInputs(target->languageService->GetLanguage(), inputs);
 
-	// clang-format off
-	std::string centerText = KZLanguageService::PrepareMessageWithLang(language, "HUD - Center Text", 
-		keyText.c_str(), checkpointText.c_str(), timerText.c_str(), speedText.c_str());
-	std::string alertText = KZLanguageService::PrepareMessageWithLang(language, "HUD - Alert Text", 
-		keyText.c_str(), checkpointText.c_str(), timerText.c_str(), speedText.c_str());
-	std::string htmlText = KZLanguageService::PrepareMessageWithLang(language, "HUD - Html Center Text",
-		keyText.c_str(), checkpointText.c_str(), timerText.c_str(), speedText.c_str());
+	bool centerChanged = false;
+	bool alertChanged = false;
+	bool htmlChanged = false;
+	if (!cache.valid || V_memcmp(&inputs, &cache.inputs, sizeof(inputs)))
+	{
+		char keyText[128];
+		char checkpointText[128];
+		char timerText[256];
+		char speedText[128];
+		GetKeyText(inputs, keyText, sizeof(keyText));
+		GetCheckpointText(inputs, checkpointText, sizeof(checkpointText));
+		GetTimerText(inputs, timerText, sizeof(timerText));
+		GetSpeedText(inputs, speedText, sizeof(speedText));
 
-	// clang-format on
+		// clang-format off
+		centerChanged = UpdatePanelText(cache.centerText, sizeof(cache.centerText), inputs.language, "HUD - Center Text",
+			keyText, checkpointText, timerText, speedText);
+		alertChanged = UpdatePanelText(cache.alertText, sizeof(cache.alertText), inputs.language, "HUD - Alert Text",
+			keyText, checkpointText, timerText, speedText);
+		htmlChanged = UpdatePanelText(cache.htmlText, sizeof(cache.htmlText), inputs.language, "HUD - Html Center Text",
+			keyText, checkpointText, timerText, speedText);
+		// clang-format on
 
-	centerText = centerText.substr(0, centerText.find_last_not_of('\n') + 1);
-	alertText = alertText.substr(0, alertText.find_last_not_of('\n') + 1);
-	htmlText = htmlText.substr(0, htmlText.find_last_not_of('\n') + 1);
+		V_memcpy(&cache.inputs, &inputs, sizeof(inputs));
+	}
 
-	// Remove trailing newlines just in case a line is empty.
-	if (!centerText.empty())
+	f64 curtime = g_pKZUtils->GetServerGlobals()->curtime;
+	bool keepalive = !cache.valid || curtime - cache.lastSendTime >= KZ_HUD_PANEL_KEEPALIVE_INTERVAL;
+	if (keepalive)
+	{
+		cache.lastSendTime = curtime;
+	}
+	cache.valid = true;
+
+	if (cache.centerText[0] && (centerChanged || keepalive))
 	{
-		target->PrintCentre(false, false, centerText.c_str());
+		target->PrintCentre(false, false, cache.centerText);
 	}
-	if (!alertText.empty())
+	if (cache.alertText[0] && (alertChanged || keepalive))
 	{
-		target->PrintAlert(false, false, alertText.c_str());
+		target->PrintAlert(false, false, cache.alertText);
 	}
-	if (!htmlText.empty())
+	if (cache.htmlText[0] && (htmlChanged || keepalive))
 	{
-		target->PrintHTMLCentre(false, false, htmlText.c_str());
+		target->PrintHTMLCentre(false, false, cache.htmlText);
 	}
 }
 
+void KZHUDService::InvalidatePanel()
+{
+	V_memset(&this->panelCache, 0, sizeof(this->panelCache));
+}
+
 void KZHUDService::ResetShowPanel()
 {
 	this->showPanel = this->player->optionService->GetPreferenceBool("showPanel", true);
@@ -160,6 +259,7 @@ void KZHUDService::TogglePanel()
 {
 	this->showPanel = !this->showPanel;
 	this->player->optionService->SetPreferenceBool("showPanel", this->showPanel);
+	this->InvalidatePanel();
 	if (!this->showPanel)
 	{
 		utils::PrintAlert(this->player->GetController(), "#SFUI_EmptyString");
@@ -3,6 +3,9 @@
 #include "../timer/kz_timer.h"
 
 #define KZ_HUD_TIMER_STOPPED_GRACE_TIME 3.0f
+// Unchanged panels are still sent this often, the html panel disappears on its own after a second.
+#define KZ_HUD_PANEL_KEEPALIVE_INTERVAL 0.5f
+#define KZ_HUD_PANEL_TEXT_SIZE          1024
 
 class KZHUDService : public KZBaseService
 {
@@ -13,6 +16,37 @@ private:
 	f64 timerStoppedTime {};
 	f64 currentTimeWhenTimerStopped {};
 
+	// Everything the panel text depends on, stored the way it's displayed so values that round to the same text compare equal.
+	// Compared and copied with memcmp/memcpy, so it has to be zeroed before it's filled.
+	struct PanelInputs
+	{
+		KZPlayer *source;
+		char language[32];
+		u8 keys;
+		i32 currentCpIndex;
+		i32 checkpointCount;
+		u32 teleportCount;
+		bool showTimer;
+		bool timerRunning;
+		bool paused;
+		char timeText[32];
+		char ghostDeltaText[32];
+		bool showTakeoff;
+		i32 speed;
+		i32 takeoffSpeed;
+	};
+
+	// What this player was last sent, only kept on the service of the player viewing the panel.
+	struct PanelCache
+	{
+		bool valid;
+		f64 lastSendTime;
+		PanelInputs inputs;
+		char centerText[KZ_HUD_PANEL_TEXT_SIZE];
+		char alertText[KZ_HUD_PANEL_TEXT_SIZE];
+		char htmlText[KZ_HUD_PANEL_TEXT_SIZE];
+	} panelCache {};
+
 public:
 	virtual void Reset() override;
 	static void Init();
@@ -21,6 +55,9 @@ public:
 	// Draw the panel from a player to a specific target.
 	static void DrawPanels(KZPlayer *player, KZPlayer *target);
 
+	// Forget what was last drawn, the next draw sends the whole panel again.
+	void InvalidatePanel();
+
 	void ResetShowPanel();
 	void TogglePanel();
 
@@ -38,8 +75,10 @@ public:
 	}
 
 private:
-	std::string GetSpeedText(const char *language = KZ_DEFAULT_LANGUAGE);
-	std::string GetKeyText(const char *language = KZ_DEFAULT_LANGUAGE);
-	std::string GetCheckpointText(const char *language = KZ_DEFAULT_LANGUAGE);
-	std::string GetTimerText(const char *language = KZ_DEFAULT_LANGUAGE);
+	void GetPanelInputs(const char *language, PanelInputs &inputs);
+
+	static void GetSpeedText(const PanelInputs &inputs, char *buffer, u32 size);
+	static void GetKeyText(const PanelInputs &inputs, char *buffer, u32 size);
+	static void GetCheckpointText(const PanelInputs &inputs, char *buffer, u32 size);
+	static void GetTimerText(const PanelInputs &inputs, char *buffer, u32 size);
 };
@@ -436,7 +436,7 @@ void Jump::Update()
 	{
 		return;
 	}
-	this->totalDistance += (this->player->currentMoveData->m_vecAbsOrigin - this->player->moveDataPre.m_vecAbsOrigin).Length2D();
+	this->totalDistance += (this->player->currentMoveData->m_vecAbsOrigin - this->player->moveDataPre.absOrigin).Length2D();
 	this->currentMaxSpeed = MAX(this->player->currentMoveData->m_vecVelocity.Length2D(), this->currentMaxSpeed);
 	this->currentMaxHeight = MAX(this->player->currentMoveData->m_vecAbsOrigin.z, this->currentMaxHeight);
 
@@ -771,7 +771,7 @@ void KZJumpstatsService::OnAirMove()
 	this->player->GetVelocity(&call.velocityPre);
 
 	// moveDataPost is still the movedata from last tick.
-	call.externalSpeedDiff = call.velocityPre.Length2D() - this->player->moveDataPost.m_vecVelocity.Length2D();
+	call.externalSpeedDiff = call.velocityPre.Length2D() - this->player->moveDataPost.velocity.Length2D();
 	call.prevYaw = this->player->oldAngles.y;
 	call.curtime = g_pKZUtils->GetGlobals()->curtime;
 	call.tickcount = g_pKZUtils->GetGlobals()->tickcount;
@@ -1008,7 +1008,7 @@ void KZJumpstatsService::DetectInvalidCollisions()
 		{
 			this->InvalidateJumpstats("Invalid collisions");
 		}
-		if (this->player->moveDataPre.m_vecVelocity.z > 0.0f)
+		if (this->player->moveDataPre.velocity.z > 0.0f)
 		{
 			this->jumps.Tail().MarkHitHead();
 		}
@@ -1026,7 +1026,7 @@ void KZJumpstatsService::DetectInvalidGains()
 	// clang-format off
 
 	f32 speed = this->player->currentMoveData->m_vecVelocity.Length2D();
-	f32 actualSpeed = (this->player->currentMoveData->m_vecAbsOrigin - this->player->moveDataPre.m_vecAbsOrigin).Length2D();
+	f32 actualSpeed = (this->player->currentMoveData->m_vecAbsOrigin - this->player->moveDataPre.absOrigin).Length2D();
 
 	if (this->player->GetPlayerPawn()->m_vecBaseVelocity().Length() > 0.0f || this->player->GetPlayerPawn()->m_fFlags() & FL_BASEVELOCITY)
 	{
@@ -1043,7 +1043,7 @@ void KZJumpstatsService::DetectInvalidGains()
 
 void KZJumpstatsService::DetectExternalModifications()
 {
-	if ((this->player->currentMoveData->m_vecAbsOrigin - this->player->moveDataPost.m_vecAbsOrigin).LengthSqr() > JS_TELEPORT_DISTANCE_SQUARED)
+	if ((this->player->currentMoveData->m_vecAbsOrigin - this->player->moveDataPost.absOrigin).LengthSqr() > JS_TELEPORT_DISTANCE_SQUARED)
 	{
 		this->InvalidateJumpstats("Externally modified");
 	}
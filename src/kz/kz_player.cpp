@@ -10,6 +10,7 @@
 #include "noclip/kz_noclip.h"
 #include "option/kz_option.h"
 #include "quiet/kz_quiet.h"
+#include "replays/kz_replays.h"
 #include "spec/kz_spec.h"
 #include "goto/kz_goto.h"
 #include "style/kz_style.h"
@@ -20,7 +21,7 @@
 
 #include "sdk/datatypes.h"
 #include "sdk/entity/cbasetrigger.h"
-#include "vprof.h"
+#include "utils/perf.h"
 #include "steam/isteamgameserver.h"
 #include "tier0/memdbgon.h"
 
@@ -39,6 +40,7 @@ void KZPlayer::Init()
 	delete this->languageService;
 	delete this->databaseService;
 	delete this->quietService;
+	delete this->replayService;
 	delete this->hudService;
 	delete this->specService;
 	delete this->timerService;
@@ -54,6 +56,7 @@ void KZPlayer::Init()
 	this->languageService = new KZLanguageService(this);
 	this->noclipService = new KZNoclipService(this);
 	this->quietService = new KZQuietService(this);
+	this->replayService = new KZReplayService(this);
 	this->hudService = new KZHUDService(this);
 	this->specService = new KZSpecService(this);
 	this->gotoService = new KZGotoService(this);
@@ -78,6 +81,7 @@ void KZPlayer::Reset()
 	this->checkpointService->Reset();
 	this->noclipService->Reset();
 	this->quietService->Reset();
+	this->replayService->Reset();
 	this->jumpstatsService->Reset();
 	this->hudService->Reset();
 	this->timerService->Reset();
@@ -95,7 +99,7 @@ void KZPlayer::Reset()
 
 void KZPlayer::OnPlayerActive()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	// Mode/Styles stuff must be here for convars to be properly replicated.
 	g_pKZModeManager->SwitchToMode(this, this->modeService->GetModeName(), true, true);
 	g_pKZStyleManager->RefreshStyles(this);
@@ -105,20 +109,20 @@ void KZPlayer::OnPlayerActive()
 
 void KZPlayer::OnAuthorized()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	MovementPlayer::OnAuthorized();
 	this->databaseService->SetupClient();
 }
 
 META_RES KZPlayer::GetPlayerMaxSpeed(f32 &maxSpeed)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	return this->modeService->GetPlayerMaxSpeed(maxSpeed);
 }
 
 void KZPlayer::OnPhysicsSimulate()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	MovementPlayer::OnPhysicsSimulate();
 	this->triggerService->OnPhysicsSimulate();
 	this->modeService->OnPhysicsSimulate();
@@ -133,7 +137,7 @@ void KZPlayer::OnPhysicsSimulate()
 
 void KZPlayer::OnPhysicsSimulatePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	MovementPlayer::OnPhysicsSimulatePost();
 	this->triggerService->OnPhysicsSimulatePost();
 	this->telemetryService->OnPhysicsSimulatePost();
@@ -143,6 +147,7 @@ void KZPlayer::OnPhysicsSimulatePost()
 		this->styleServices[i]->OnPhysicsSimulatePost();
 	}
 	this->timerService->OnPhysicsSimulatePost();
+	this->replayService->OnPhysicsSimulatePost();
 	if (this->specService->GetSpectatedPlayer())
 	{
 		KZHUDService::DrawPanels(this->specService->GetSpectatedPlayer(), this);
@@ -155,7 +160,7 @@ void KZPlayer::OnPhysicsSimulatePost()
 
 void KZPlayer::OnProcessUsercmds(void *cmds, int numcmds)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnProcessUsercmds(cmds, numcmds);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -165,7 +170,7 @@ void KZPlayer::OnProcessUsercmds(void *cmds, int numcmds)
 
 void KZPlayer::OnProcessUsercmdsPost(void *cmds, int numcmds)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnProcessUsercmdsPost(cmds, numcmds);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -175,7 +180,8 @@ void KZPlayer::OnProcessUsercmdsPost(void *cmds, int numcmds)
 
 void KZPlayer::OnSetupMove(PlayerCommand *pc)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
+	this->replayService->OnSetupMove(pc);
 	this->modeService->OnSetupMove(pc);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -185,7 +191,7 @@ void KZPlayer::OnSetupMove(PlayerCommand *pc)
 
 void KZPlayer::OnSetupMovePost(PlayerCommand *pc)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnSetupMovePost(pc);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -195,7 +201,9 @@ void KZPlayer::OnSetupMovePost(PlayerCommand *pc)
 
 void KZPlayer::OnProcessMovement()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
+	// Capture the move data before anything gets to change it.
+	this->replayService->OnProcessMovement();
 	MovementPlayer::OnProcessMovement();
 	KZ::mode::ApplyModeSettings(this);
 
@@ -213,7 +221,8 @@ void KZPlayer::OnProcessMovement()
 
 void KZPlayer::OnProcessMovementPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
+	this->replayService->OnProcessMovementPost();
 	this->triggerService->OnProcessMovementPost();
 
 	this->jumpstatsService->UpdateJump();
@@ -228,7 +237,7 @@ void KZPlayer::OnProcessMovementPost()
 
 void KZPlayer::OnPlayerMove()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnPlayerMove();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -238,7 +247,7 @@ void KZPlayer::OnPlayerMove()
 
 void KZPlayer::OnPlayerMovePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnPlayerMovePost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -248,7 +257,7 @@ void KZPlayer::OnPlayerMovePost()
 
 void KZPlayer::OnCheckParameters()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckParameters();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -258,7 +267,7 @@ void KZPlayer::OnCheckParameters()
 
 void KZPlayer::OnCheckParametersPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckParametersPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -268,7 +277,7 @@ void KZPlayer::OnCheckParametersPost()
 
 void KZPlayer::OnCanMove()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCanMove();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -278,7 +287,7 @@ void KZPlayer::OnCanMove()
 
 void KZPlayer::OnCanMovePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCanMovePost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -288,7 +297,7 @@ void KZPlayer::OnCanMovePost()
 
 void KZPlayer::OnFullWalkMove(bool &ground)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnFullWalkMove(ground);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -298,7 +307,7 @@ void KZPlayer::OnFullWalkMove(bool &ground)
 
 void KZPlayer::OnFullWalkMovePost(bool ground)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnFullWalkMovePost(ground);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -308,7 +317,7 @@ void KZPlayer::OnFullWalkMovePost(bool ground)
 
 void KZPlayer::OnMoveInit()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnMoveInit();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -318,7 +327,7 @@ void KZPlayer::OnMoveInit()
 
 void KZPlayer::OnMoveInitPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnMoveInitPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -328,7 +337,7 @@ void KZPlayer::OnMoveInitPost()
 
 void KZPlayer::OnCheckWater()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckWater();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -338,7 +347,7 @@ void KZPlayer::OnCheckWater()
 
 void KZPlayer::OnWaterMove()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnWaterMove();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -348,7 +357,7 @@ void KZPlayer::OnWaterMove()
 
 void KZPlayer::OnWaterMovePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnWaterMovePost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -358,7 +367,7 @@ void KZPlayer::OnWaterMovePost()
 
 void KZPlayer::OnCheckWaterPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckWaterPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -368,7 +377,7 @@ void KZPlayer::OnCheckWaterPost()
 
 void KZPlayer::OnCheckVelocity(const char *a3)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckVelocity(a3);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -378,7 +387,7 @@ void KZPlayer::OnCheckVelocity(const char *a3)
 
 void KZPlayer::OnCheckVelocityPost(const char *a3)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckVelocityPost(a3);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -388,7 +397,7 @@ void KZPlayer::OnCheckVelocityPost(const char *a3)
 
 void KZPlayer::OnDuck()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnDuck();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -398,7 +407,7 @@ void KZPlayer::OnDuck()
 
 void KZPlayer::OnDuckPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnDuckPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -408,7 +417,7 @@ void KZPlayer::OnDuckPost()
 
 void KZPlayer::OnCanUnduck()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCanUnduck();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -418,7 +427,7 @@ void KZPlayer::OnCanUnduck()
 
 void KZPlayer::OnCanUnduckPost(bool &ret)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCanUnduckPost(ret);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -428,7 +437,7 @@ void KZPlayer::OnCanUnduckPost(bool &ret)
 
 void KZPlayer::OnLadderMove()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnLadderMove();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -438,7 +447,7 @@ void KZPlayer::OnLadderMove()
 
 void KZPlayer::OnLadderMovePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnLadderMovePost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -448,7 +457,7 @@ void KZPlayer::OnLadderMovePost()
 
 void KZPlayer::OnCheckJumpButton()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckJumpButton();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -458,7 +467,7 @@ void KZPlayer::OnCheckJumpButton()
 
 void KZPlayer::OnCheckJumpButtonPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckJumpButtonPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -468,7 +477,7 @@ void KZPlayer::OnCheckJumpButtonPost()
 
 void KZPlayer::OnJump()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnJump();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -478,7 +487,7 @@ void KZPlayer::OnJump()
 
 void KZPlayer::OnJumpPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnJumpPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -488,7 +497,7 @@ void KZPlayer::OnJumpPost()
 
 void KZPlayer::OnAirMove()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnAirMove();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -499,7 +508,7 @@ void KZPlayer::OnAirMove()
 
 void KZPlayer::OnAirMovePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnAirMovePost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -510,7 +519,7 @@ void KZPlayer::OnAirMovePost()
 
 void KZPlayer::OnFriction()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnFriction();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -520,7 +529,7 @@ void KZPlayer::OnFriction()
 
 void KZPlayer::OnFrictionPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnFrictionPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -530,7 +539,7 @@ void KZPlayer::OnFrictionPost()
 
 void KZPlayer::OnWalkMove()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnWalkMove();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -540,7 +549,7 @@ void KZPlayer::OnWalkMove()
 
 void KZPlayer::OnWalkMovePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnWalkMovePost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -550,7 +559,7 @@ void KZPlayer::OnWalkMovePost()
 
 void KZPlayer::OnTryPlayerMove(Vector *pFirstDest, trace_t *pFirstTrace)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnTryPlayerMove(pFirstDest, pFirstTrace);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -561,7 +570,7 @@ void KZPlayer::OnTryPlayerMove(Vector *pFirstDest, trace_t *pFirstTrace)
 
 void KZPlayer::OnTryPlayerMovePost(Vector *pFirstDest, trace_t *pFirstTrace)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnTryPlayerMovePost(pFirstDest, pFirstTrace);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -572,7 +581,7 @@ void KZPlayer::OnTryPlayerMovePost(Vector *pFirstDest, trace_t *pFirstTrace)
 
 void KZPlayer::OnCategorizePosition(bool bStayOnGround)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCategorizePosition(bStayOnGround);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -582,7 +591,7 @@ void KZPlayer::OnCategorizePosition(bool bStayOnGround)
 
 void KZPlayer::OnCategorizePositionPost(bool bStayOnGround)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCategorizePositionPost(bStayOnGround);
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -592,7 +601,7 @@ void KZPlayer::OnCategorizePositionPost(bool bStayOnGround)
 
 void KZPlayer::OnFinishGravity()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnFinishGravity();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -602,7 +611,7 @@ void KZPlayer::OnFinishGravity()
 
 void KZPlayer::OnFinishGravityPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnFinishGravityPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -612,7 +621,7 @@ void KZPlayer::OnFinishGravityPost()
 
 void KZPlayer::OnCheckFalling()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckFalling();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -622,7 +631,7 @@ void KZPlayer::OnCheckFalling()
 
 void KZPlayer::OnCheckFallingPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnCheckFallingPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -632,7 +641,7 @@ void KZPlayer::OnCheckFallingPost()
 
 void KZPlayer::OnPostPlayerMove()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnPostPlayerMove();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -642,7 +651,7 @@ void KZPlayer::OnPostPlayerMove()
 
 void KZPlayer::OnPostPlayerMovePost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnPostPlayerMovePost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -652,7 +661,7 @@ void KZPlayer::OnPostPlayerMovePost()
 
 void KZPlayer::OnPostThink()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnPostThink();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -663,7 +672,7 @@ void KZPlayer::OnPostThink()
 
 void KZPlayer::OnPostThinkPost()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->modeService->OnPostThinkPost();
 	FOR_EACH_VEC(this->styleServices, i)
 	{
@@ -673,7 +682,7 @@ void KZPlayer::OnPostThinkPost()
 
 void KZPlayer::OnStartTouchGround()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->jumpstatsService->EndJump();
 	this->timerService->OnStartTouchGround();
 	this->modeService->OnStartTouchGround();
@@ -685,7 +694,7 @@ void KZPlayer::OnStartTouchGround()
 
 void KZPlayer::OnStopTouchGround()
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->triggerService->OnStopTouchGround();
 	this->timerService->OnStopTouchGround();
 	this->modeService->OnStopTouchGround();
@@ -698,7 +707,7 @@ void KZPlayer::OnStopTouchGround()
 
 void KZPlayer::OnChangeMoveType(MoveType_t oldMoveType)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->jumpstatsService->OnChangeMoveType(oldMoveType);
 	this->timerService->OnChangeMoveType(oldMoveType);
 	this->modeService->OnChangeMoveType(oldMoveType);
@@ -710,7 +719,7 @@ void KZPlayer::OnChangeMoveType(MoveType_t oldMoveType)
 
 void KZPlayer::OnTeleport(const Vector *origin, const QAngle *angles, const Vector *velocity)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE_PLAYER(__func__, this->GetPlayerSlot().Get());
 	this->lastTeleportTime = g_pKZUtils->GetServerGlobals()->curtime;
 	this->jumpstatsService->InvalidateJumpstats("Teleported");
 	this->modeService->OnTeleport(origin, angles, velocity);
@@ -6,6 +6,7 @@
 #include "filesystem.h"
 #include "utils/ctimer.h"
 #include "kz/option/kz_option.h"
+#include "kz_language_table.h"
 
 #include <vendor/ClientCvarValue/public/iclientcvarvalue.h>
 
@@ -18,6 +19,9 @@ void KZLanguageService::Init()
 {
 	if (translationKV)
 	{
+		// The compiled translations and the phrase table point into the phrases.
+		KZ::language::ClearCompiledTranslations();
+		KZ::language::ClearPhraseTable();
 		delete translationKV;
 	}
 	if (languagesKV)
@@ -63,6 +67,8 @@ void KZLanguageService::LoadTranslations()
 		} while (fileName);
 		g_pFullFileSystem->FindClose(findHandle);
 	}
+	KZ::language::BuildPhraseTable(translationKV, KZ_DEFAULT_LANGUAGE);
+	KZ::language::CompileTranslations(translationKV);
 }
 
 const char *KZLanguageService::GetLanguage()
@@ -86,23 +92,7 @@ const char *KZLanguageService::GetLanguage()
 
 const char *KZLanguageService::GetTranslatedFormat(const char *language, const char *phrase)
 {
-	if (!translationKV->FindKey(phrase))
-	{
-		// META_CONPRINTF("Warning: Phrase '%s' not found, returning orignal message!\n", phrase);
-		return phrase;
-	}
-	const char *outFormat = translationKV->FindKey(phrase)->GetString(language);
-	if (outFormat[0] == '\0')
-	{
-		if (!V_stricmp(language, "#format"))
-		{
-			// It is fine to have no format.
-			return NULL;
-		}
-		// META_CONPRINTF("Warning: Phrase '%s' not found for language %s!\n", phrase, language);
-		return translationKV->FindKey(phrase)->GetString(KZ_DEFAULT_LANGUAGE);
-	}
-	return outFormat;
+	return KZ::language::GetTranslatedFormat(language, phrase);
 }
 
 static_function SCMD_CALLBACK(Command_KzSetLanguage)
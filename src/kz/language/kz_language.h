@@ -1,5 +1,6 @@
 #pragma once
 #include "vendor/tinyformat.h"
+#include "kz_language_template.h"
 
 #include "../kz.h"
 #include "../spec/kz_spec.h"
@@ -75,17 +76,42 @@ private:
 	}
 
 public:
+	// Format a message into the buffer, returns the length of the full message like snprintf does.
 	template<typename... Args>
-	static std::string PrepareMessageWithLang(const char *language, const char *message, Args &&...args)
+	static u32 FormatMessageWithLang(char *buffer, u32 size, const char *language, const char *message, Args &&...args)
 	{
 		const char *paramFormat = GetTranslatedFormat("#format", message);
 		const char *msgFormat = GetTranslatedFormat(language, message);
 		if (!paramFormat)
 		{
 			// Just return the raw unformatted message if format can't be found.
-			return std::string(msgFormat);
+			V_strncpy(buffer, msgFormat, size);
+			return V_strlen(msgFormat);
+		}
+		KZ::language::MessageArg messageArgs[sizeof...(Args) + 1] = {KZ::language::MakeMessageArg(args)..., {}};
+		i32 length = KZ::language::FormatCompiledMessage(msgFormat, buffer, size, messageArgs, sizeof...(Args));
+		if (length >= 0)
+		{
+			return length;
+		}
+		// Not compiled, let tinyformat deal with it.
+		std::string msg = GetFormattedMessage(msgFormat, paramFormat, args...);
+		V_strncpy(buffer, msg.c_str(), size);
+		return msg.length();
+	}
+
+	template<typename... Args>
+	static std::string PrepareMessageWithLang(const char *language, const char *message, Args &&...args)
+	{
+		char buffer[1024];
+		u32 length = FormatMessageWithLang(buffer, sizeof(buffer), language, message, args...);
+		if (length < sizeof(buffer))
+		{
+			return std::string(buffer, length);
 		}
-		return GetFormattedMessage(msgFormat, paramFormat, args...);
+		std::string msg(length, '\0');
+		FormatMessageWithLang(msg.data(), length + 1, language, message, args...);
+		return msg;
 	}
 
 	template<typename... Args>
@@ -0,0 +1,140 @@
+// Looks up the format and every translation of every phrase through the phrase table and through the KeyValues lookup the table
+// replaced, prints the cost per lookup of both and checks that they return the same strings.
+//
+//   cs2kz-bench-language [-n iterations] <file.phrases.txt>...
+//
+// The tool links tier0 like the plugin does, run it with the game's bin directory in the library path.
+
+#include "kz_language_table.h"
+#include "KeyValues.h"
+
+#include <stdio.h>
+
+#include "tier0/memdbgon.h"
+
+#define BENCH_DEFAULT_ITERATIONS 100
+// Same as KZ_DEFAULT_LANGUAGE, kz.h pulls in the whole plugin.
+#define BENCH_DEFAULT_LANGUAGE   "en"
+
+static_global KeyValues *translations;
+
+// The lookup GetTranslatedFormat did before the phrase table.
+static_function const char *GetTranslatedFormatKV(const char *language, const char *phrase)
+{
+	if (!translations->FindKey(phrase))
+	{
+		return phrase;
+	}
+	const char *outFormat = translations->FindKey(phrase)->GetString(language);
+	if (outFormat[0] == '\0')
+	{
+		if (!V_stricmp(language, "#format"))
+		{
+			return NULL;
+		}
+		return translations->FindKey(phrase)->GetString(BENCH_DEFAULT_LANGUAGE);
+	}
+	return outFormat;
+}
+
+static_function bool LoadPhrases(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	CUtlVector<char> buffer;
+	buffer.SetCount(MAX(size, 0) + 1);
+	bool success = size > 0 && fread(buffer.Base(), 1, size, file) == (size_t)size;
+	fclose(file);
+	if (!success)
+	{
+		return false;
+	}
+	buffer[size] = '\0';
+	// Same as KZLanguageService::LoadTranslations, every file is merged into the same KeyValues.
+	return translations->LoadFromBuffer(path, buffer.Base());
+}
+
+int main(int argc, char *argv[])
+{
+	i32 iterations = BENCH_DEFAULT_ITERATIONS;
+	translations = new KeyValues("Phrases");
+	translations->UsesEscapeSequences(true);
+	i32 fileCount = 0;
+	for (i32 i = 1; i < argc; i++)
+	{
+		if (KZ_STREQ(argv[i], "-n") && i + 1 < argc)
+		{
+			iterations = V_StringToInt32(argv[++i], BENCH_DEFAULT_ITERATIONS);
+			iterations = MAX(iterations, 1);
+			continue;
+		}
+		if (!LoadPhrases(argv[i]))
+		{
+			printf("Failed to load %s\n", argv[i]);
+			return 1;
+		}
+		fileCount++;
+	}
+	if (fileCount == 0)
+	{
+		printf("Usage: %s [-n iterations] <file.phrases.txt>...\n", argv[0]);
+		return 1;
+	}
+
+	KZ::language::BuildPhraseTable(translations, BENCH_DEFAULT_LANGUAGE);
+	i32 phraseCount = KZ::language::GetPhraseCount();
+	i32 languageCount = KZ::language::GetLanguageCount();
+	if (phraseCount == 0)
+	{
+		printf("No phrases found\n");
+		return 1;
+	}
+
+	u64 lookups = (u64)iterations * phraseCount * languageCount;
+	// Sum up the results so the lookups can't be optimized out, both paths should return the same strings.
+	uintptr_t tableSum = 0;
+	f64 start = Plat_FloatTime();
+	for (i32 i = 0; i < iterations; i++)
+	{
+		for (i32 row = 0; row < phraseCount; row++)
+		{
+			for (i32 column = 0; column < languageCount; column++)
+			{
+				tableSum += (uintptr_t)KZ::language::GetTranslatedFormat(KZ::language::GetLanguageName(column), KZ::language::GetPhraseName(row));
+			}
+		}
+	}
+	f64 tableTime = Plat_FloatTime() - start;
+
+	uintptr_t kvSum = 0;
+	start = Plat_FloatTime();
+	for (i32 i = 0; i < iterations; i++)
+	{
+		for (i32 row = 0; row < phraseCount; row++)
+		{
+			for (i32 column = 0; column < languageCount; column++)
+			{
+				kvSum += (uintptr_t)GetTranslatedFormatKV(KZ::language::GetLanguageName(column), KZ::language::GetPhraseName(row));
+			}
+		}
+	}
+	f64 kvTime = Plat_FloatTime() - start;
+
+	printf("%llu lookups (%i phrases, %i languages)\n", (unsigned long long)lookups, phraseCount, languageCount);
+	printf("  Phrase table: %.1f ns/lookup\n", tableTime * 1e9 / lookups);
+	printf("  KeyValues:    %.1f ns/lookup\n", kvTime * 1e9 / lookups);
+	KZ::language::ClearPhraseTable();
+	delete translations;
+	if (tableSum != kvSum)
+	{
+		printf("  Warning: the two lookups returned different translations!\n");
+		return 1;
+	}
+	return 0;
+}
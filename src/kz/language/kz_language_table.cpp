@@ -0,0 +1,190 @@
+#include "kz_language_table.h"
+#include "utils/utils.h"
+#include "KeyValues.h"
+
+#include "tier0/memdbgon.h"
+
+struct PhraseSlot
+{
+	u32 hash;
+	// -1 for empty slots.
+	i32 row;
+};
+
+struct PhraseLanguage
+{
+	u32 hash;
+	const char *name;
+};
+
+static_global CUtlVector<PhraseSlot> phraseSlots;
+static_global CUtlVector<const char *> phraseNames;
+// Column 0 is always #format.
+static_global CUtlVector<PhraseLanguage> phraseLanguages;
+// phraseNames.Count() rows of phraseLanguages.Count() translations, nullptr if the phrase has no translation for that language.
+static_global CUtlVector<const char *> phraseCells;
+static_global i32 defaultLanguageColumn = -1;
+
+static_function i32 FindLanguageColumn(const char *language)
+{
+	u32 hash = utils::HashStringCaseless(language);
+	FOR_EACH_VEC(phraseLanguages, i)
+	{
+		if (phraseLanguages[i].hash == hash && !V_stricmp(phraseLanguages[i].name, language))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+static_function i32 FindPhraseRow(const char *phrase)
+{
+	if (phraseSlots.Count() == 0)
+	{
+		return -1;
+	}
+	u32 hash = utils::HashStringCaseless(phrase);
+	u32 mask = phraseSlots.Count() - 1;
+	for (u32 i = hash & mask;; i = (i + 1) & mask)
+	{
+		const PhraseSlot &slot = phraseSlots[i];
+		if (slot.row == -1)
+		{
+			return -1;
+		}
+		if (slot.hash == hash && !V_stricmp(phraseNames[slot.row], phrase))
+		{
+			return slot.row;
+		}
+	}
+}
+
+static_function const char *GetPhraseCell(i32 row, i32 column)
+{
+	if (column == -1)
+	{
+		return nullptr;
+	}
+	return phraseCells[row * phraseLanguages.Count() + column];
+}
+
+void KZ::language::ClearPhraseTable()
+{
+	phraseSlots.Purge();
+	phraseNames.Purge();
+	phraseLanguages.Purge();
+	phraseCells.Purge();
+	defaultLanguageColumn = -1;
+}
+
+void KZ::language::BuildPhraseTable(KeyValues *translations, const char *defaultLanguage)
+{
+	ClearPhraseTable();
+	phraseLanguages.AddToTail({utils::HashStringCaseless("#format"), "#format"});
+
+	// Duplicate phrases and translations are skipped, FindKey would have returned the first one as well.
+	FOR_EACH_TRUE_SUBKEY(translations, phrase)
+	{
+		if (FindPhraseRow(phrase->GetName()) != -1)
+		{
+			continue;
+		}
+		FOR_EACH_VALUE(phrase, translation)
+		{
+			if (FindLanguageColumn(translation->GetName()) == -1)
+			{
+				phraseLanguages.AddToTail({utils::HashStringCaseless(translation->GetName()), translation->GetName()});
+			}
+		}
+		phraseNames.AddToTail(phrase->GetName());
+	}
+
+	// Keep the table at most half full so probe sequences stay short.
+	i32 slotCount = 16;
+	while (slotCount < phraseNames.Count() * 2)
+	{
+		slotCount *= 2;
+	}
+	phraseSlots.SetCount(slotCount);
+	FOR_EACH_VEC(phraseSlots, i)
+	{
+		phraseSlots[i].row = -1;
+	}
+	FOR_EACH_VEC(phraseNames, row)
+	{
+		u32 hash = utils::HashStringCaseless(phraseNames[row]);
+		u32 i = hash & (slotCount - 1);
+		while (phraseSlots[i].row != -1)
+		{
+			i = (i + 1) & (slotCount - 1);
+		}
+		phraseSlots[i] = {hash, row};
+	}
+
+	phraseCells.SetCount(phraseNames.Count() * phraseLanguages.Count());
+	FOR_EACH_VEC(phraseCells, i)
+	{
+		phraseCells[i] = nullptr;
+	}
+	FOR_EACH_TRUE_SUBKEY(translations, phrase)
+	{
+		i32 row = FindPhraseRow(phrase->GetName());
+		if (phrase != translations->FindKey(phraseNames[row]))
+		{
+			continue;
+		}
+		FOR_EACH_VALUE(phrase, translation)
+		{
+			const char **cell = &phraseCells[row * phraseLanguages.Count() + FindLanguageColumn(translation->GetName())];
+			if (!*cell)
+			{
+				*cell = translation->GetString();
+			}
+		}
+	}
+	defaultLanguageColumn = FindLanguageColumn(defaultLanguage);
+}
+
+const char *KZ::language::GetTranslatedFormat(const char *language, const char *phrase)
+{
+	i32 row = FindPhraseRow(phrase);
+	if (row == -1)
+	{
+		// META_CONPRINTF("Warning: Phrase '%s' not found, returning orignal message!\n", phrase);
+		return phrase;
+	}
+	const char *outFormat = GetPhraseCell(row, FindLanguageColumn(language));
+	if (!outFormat || outFormat[0] == '\0')
+	{
+		if (!V_stricmp(language, "#format"))
+		{
+			// It is fine to have no format.
+			return NULL;
+		}
+		// META_CONPRINTF("Warning: Phrase '%s' not found for language %s!\n", phrase, language);
+		outFormat = GetPhraseCell(row, defaultLanguageColumn);
+		return outFormat ? outFormat : "";
+	}
+	return outFormat;
+}
+
+i32 KZ::language::GetPhraseCount()
+{
+	return phraseNames.Count();
+}
+
+const char *KZ::language::GetPhraseName(i32 row)
+{
+	return phraseNames[row];
+}
+
+i32 KZ::language::GetLanguageCount()
+{
+	return phraseLanguages.Count();
+}
+
+const char *KZ::language::GetLanguageName(i32 column)
+{
+	return phraseLanguages[column].name;
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "common.h"
+
+class KeyValues;
+
+/*
+	Flat copy of the translation KeyValues for GetTranslatedFormat, so that looking up a phrase doesn't walk the KeyValues tree twice.
+	Phrases are found through an open addressing table of name hashes, each phrase is a row of translations with one column per
+	language. Cells point to the strings owned by the KeyValues, so the table is rebuilt whenever the phrases are loaded.
+*/
+
+namespace KZ::language
+{
+	void BuildPhraseTable(KeyValues *translations, const char *defaultLanguage);
+	void ClearPhraseTable();
+
+	// Same result as looking the phrase up in the KeyValues: the phrase itself if it doesn't exist, NULL if the format is asked
+	// for and there is none, otherwise the translation or the default language's translation ("" if neither exists).
+	const char *GetTranslatedFormat(const char *language, const char *phrase);
+
+	i32 GetPhraseCount();
+	const char *GetPhraseName(i32 row);
+	// Column 0 is always #format.
+	i32 GetLanguageCount();
+	const char *GetLanguageName(i32 column);
+} // namespace KZ::language
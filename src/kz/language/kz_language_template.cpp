@@ -0,0 +1,310 @@
+#include "kz_language_template.h"
+#include "KeyValues.h"
+
+#include <unordered_map>
+
+#include "tier0/memdbgon.h"
+
+#define MESSAGE_MAX_ARGS      32
+#define MESSAGE_MAX_SPEC_SIZE 16
+
+struct MessageToken
+{
+	// -1 for literal text.
+	i32 argIndex;
+	u32 literalOffset;
+	u32 literalLength;
+	// Full printf style spec including the conversion, e.g. "%.2f".
+	char spec[MESSAGE_MAX_SPEC_SIZE];
+	u32 specLength;
+};
+
+struct MessageTemplate
+{
+	u32 firstToken;
+	u32 tokenCount;
+};
+
+static_global CUtlVector<MessageToken> tokens;
+static_global CUtlVector<char> literals;
+// Keyed by the translation string owned by the translation KeyValues, which is what GetTranslatedFormat hands out.
+static_global std::unordered_map<const char *, MessageTemplate> compiledTemplates;
+
+struct FormatArgName
+{
+	const char *name;
+	u32 nameLength;
+	char spec[MESSAGE_MAX_SPEC_SIZE];
+	u32 specLength;
+};
+
+// Only the subset of printf specs that snprintf and tinyformat agree on: flags, width, precision and one of d, i, f, s, c.
+static_function bool ParseSpec(const char *start, const char *end, FormatArgName &out)
+{
+	if (end - start + 2 > MESSAGE_MAX_SPEC_SIZE)
+	{
+		return false;
+	}
+	const char *c = start;
+	while (c < end && (*c == '-' || *c == '+' || *c == ' ' || *c == '0'))
+	{
+		c++;
+	}
+	while (c < end && *c >= '0' && *c <= '9')
+	{
+		c++;
+	}
+	if (c < end && *c == '.')
+	{
+		c++;
+		while (c < end && *c >= '0' && *c <= '9')
+		{
+			c++;
+		}
+	}
+	if (c + 1 != end || !V_strchr("difsc", *c))
+	{
+		return false;
+	}
+	out.spec[0] = '%';
+	V_memcpy(out.spec + 1, start, end - start);
+	out.specLength = (u32)(end - start) + 1;
+	out.spec[out.specLength] = '\0';
+	return true;
+}
+
+// Same parsing as the old placeholder replacement: "name:spec,name:spec", the argument number is the position in the list.
+static_function bool ParseFormat(const char *format, FormatArgName *names, u32 &nameCount)
+{
+	nameCount = 0;
+	const char *tokenStart = format;
+	while (true)
+	{
+		const char *tokenEnd = strstr(tokenStart, ":");
+		if (!tokenEnd)
+		{
+			return true;
+		}
+		if (nameCount == MESSAGE_MAX_ARGS)
+		{
+			return false;
+		}
+		const char *replaceStart = tokenEnd + 1;
+		const char *replaceEnd = strstr(replaceStart, ",");
+		bool last = !replaceEnd;
+		if (last)
+		{
+			replaceEnd = format + strlen(format);
+		}
+		FormatArgName &name = names[nameCount++];
+		name.name = tokenStart;
+		name.nameLength = (u32)(tokenEnd - tokenStart);
+		if (!ParseSpec(replaceStart, replaceEnd, name))
+		{
+			return false;
+		}
+		if (last)
+		{
+			return true;
+		}
+		tokenStart = replaceEnd + 1;
+	}
+}
+
+static_function void AddLiteral(const char *text, u32 length)
+{
+	if (tokens.Count() > 0 && tokens.Tail().argIndex == -1
+		&& tokens.Tail().literalOffset + tokens.Tail().literalLength == (u32)literals.Count())
+	{
+		tokens.Tail().literalLength += length;
+	}
+	else
+	{
+		MessageToken *token = tokens.AddToTailGetPtr();
+		token->argIndex = -1;
+		token->literalOffset = literals.Count();
+		token->literalLength = length;
+		token->specLength = 0;
+	}
+	literals.AddMultipleToTail(length, text);
+}
+
+static_function bool CompileTemplate(const char *text, const FormatArgName *names, u32 nameCount, MessageTemplate &out)
+{
+	i32 tokenStart = tokens.Count();
+	i32 literalStart = literals.Count();
+	out.firstToken = tokenStart;
+
+	const char *c = text;
+	while (*c)
+	{
+		if (*c == '%')
+		{
+			// "%%" is how tinyformat prints a single '%', anything else would be read as a conversion.
+			if (c[1] != '%')
+			{
+				tokens.RemoveMultipleFromTail(tokens.Count() - tokenStart);
+				literals.RemoveMultipleFromTail(literals.Count() - literalStart);
+				return false;
+			}
+			AddLiteral(c, 1);
+			c += 2;
+			continue;
+		}
+		if (*c == '{')
+		{
+			u32 argIndex = 0;
+			for (; argIndex < nameCount; argIndex++)
+			{
+				const FormatArgName &name = names[argIndex];
+				if (!V_strncmp(c + 1, name.name, name.nameLength) && c[name.nameLength + 1] == '}')
+				{
+					break;
+				}
+			}
+			if (argIndex < nameCount)
+			{
+				MessageToken *token = tokens.AddToTailGetPtr();
+				token->argIndex = argIndex;
+				token->literalOffset = 0;
+				token->literalLength = 0;
+				V_memcpy(token->spec, names[argIndex].spec, sizeof(token->spec));
+				token->specLength = names[argIndex].specLength;
+				c += names[argIndex].nameLength + 2;
+				continue;
+			}
+		}
+		// Unknown placeholders are left as they are.
+		AddLiteral(c, 1);
+		c++;
+	}
+	out.tokenCount = tokens.Count() - tokenStart;
+	return true;
+}
+
+void KZ::language::ClearCompiledTranslations()
+{
+	tokens.Purge();
+	literals.Purge();
+	compiledTemplates.clear();
+}
+
+void KZ::language::CompileTranslations(KeyValues *translations)
+{
+	ClearCompiledTranslations();
+	u32 phraseCount = 0;
+	u32 skippedCount = 0;
+	FOR_EACH_TRUE_SUBKEY(translations, phrase)
+	{
+		const char *format = phrase->GetString("#format", NULL);
+		if (!format || !format[0])
+		{
+			// Phrases without a format are printed as they are.
+			continue;
+		}
+		FormatArgName names[MESSAGE_MAX_ARGS];
+		u32 nameCount;
+		bool formatValid = ParseFormat(format, names, nameCount);
+		FOR_EACH_VALUE(phrase, translation)
+		{
+			if (!V_stricmp(translation->GetName(), "#format"))
+			{
+				continue;
+			}
+			const char *text = translation->GetString();
+			MessageTemplate compiled;
+			if (formatValid && CompileTemplate(text, names, nameCount, compiled))
+			{
+				compiledTemplates[text] = compiled;
+				phraseCount++;
+			}
+			else
+			{
+				skippedCount++;
+			}
+		}
+	}
+	META_CONPRINTF("[KZ::Language] Compiled %u translations, %u left to tinyformat.\n", phraseCount, skippedCount);
+}
+
+static_function void Append(char *buffer, u32 size, u32 &length, const char *text, u32 textLength)
+{
+	u32 capacity = size > 0 ? size - 1 : 0;
+	if (length < capacity)
+	{
+		V_memcpy(buffer + length, text, MIN(textLength, capacity - length));
+	}
+	length += textLength;
+}
+
+static_function void FormatArg(char *buffer, u32 size, u32 &length, const MessageToken &token, const KZ::language::MessageArg &arg)
+{
+	using namespace KZ::language;
+
+	char conversion = token.spec[token.specLength - 1];
+	bool integer = conversion == 'd' || conversion == 'i';
+	bool matches = (integer && (arg.kind == MESSAGE_ARG_INT || arg.kind == MESSAGE_ARG_UINT))
+				   || (conversion == 'f' && arg.kind == MESSAGE_ARG_FLOAT) || (conversion == 's' && arg.kind == MESSAGE_ARG_STRING)
+				   || (conversion == 'c' && arg.kind == MESSAGE_ARG_CHAR);
+	if (!matches)
+	{
+		std::string text = arg.fallback(token.spec, arg);
+		Append(buffer, size, length, text.c_str(), (u32)text.length());
+		return;
+	}
+
+	char *out = length < size ? buffer + length : NULL;
+	u32 remaining = length < size ? size - length : 0;
+	i32 written = 0;
+	if (integer)
+	{
+		// Integers of any size are printed as 64 bit, insert the length modifier before the conversion.
+		char spec[MESSAGE_MAX_SPEC_SIZE + 2];
+		V_memcpy(spec, token.spec, token.specLength - 1);
+		V_strncpy(spec + token.specLength - 1, arg.kind == MESSAGE_ARG_INT ? "lld" : "llu", 4);
+		written = arg.kind == MESSAGE_ARG_INT ? snprintf(out, remaining, spec, (long long)arg.i)
+											  : snprintf(out, remaining, spec, (unsigned long long)arg.u);
+	}
+	else if (conversion == 'f')
+	{
+		written = snprintf(out, remaining, token.spec, arg.f);
+	}
+	else if (conversion == 's')
+	{
+		written = snprintf(out, remaining, token.spec, arg.s ? arg.s : "");
+	}
+	else
+	{
+		written = snprintf(out, remaining, token.spec, arg.c);
+	}
+	length += MAX(written, 0);
+}
+
+i32 KZ::language::FormatCompiledMessage(const char *translation, char *buffer, u32 size, const MessageArg *args, u32 argCount)
+{
+	auto it = compiledTemplates.find(translation);
+	if (it == compiledTemplates.end())
+	{
+		return -1;
+	}
+	const MessageTemplate &compiled = it->second;
+	u32 length = 0;
+	for (u32 i = compiled.firstToken; i < compiled.firstToken + compiled.tokenCount; i++)
+	{
+		const MessageToken &token = tokens[i];
+		if (token.argIndex == -1)
+		{
+			Append(buffer, size, length, literals.Base() + token.literalOffset, token.literalLength);
+		}
+		// Arguments missing from the call print nothing.
+		else if ((u32)token.argIndex < argCount)
+		{
+			FormatArg(buffer, size, length, token, args[token.argIndex]);
+		}
+	}
+	if (size > 0)
+	{
+		buffer[MIN(length, size - 1)] = '\0';
+	}
+	return length;
+}
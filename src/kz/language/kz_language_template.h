@@ -0,0 +1,122 @@
+#pragma once
+#include "common.h"
+#include "vendor/tinyformat.h"
+
+#include <string>
+#include <type_traits>
+
+class KeyValues;
+
+/*
+	Translations compiled into token programs when they are loaded.
+	A phrase like "Speed: {speed}" with the format "speed:.0f" becomes the literal "Speed: " followed by a slot that prints the first
+	argument with "%.0f". Formatting a message is then one pass over the tokens into a caller provided buffer, instead of rewriting
+	the placeholders into a printf format string and handing that to tinyformat for every message.
+
+	The output is the same as tinyformat's. Arguments that match the conversion of their slot (integers for d/i, floats for f,
+	strings for s, char for c) are printed with snprintf, anything else is handed to tinyformat with its original type.
+	Translations using something the compiler doesn't understand are not compiled and keep going through tinyformat.
+*/
+
+namespace KZ::language
+{
+	enum MessageArgKind : u8
+	{
+		MESSAGE_ARG_OTHER,
+		MESSAGE_ARG_INT,
+		MESSAGE_ARG_UINT,
+		MESSAGE_ARG_FLOAT,
+		MESSAGE_ARG_STRING,
+		MESSAGE_ARG_CHAR,
+	};
+
+	struct MessageArg;
+	using MessageArgFallback = std::string (*)(const char *spec, const MessageArg &arg);
+
+	// Type erased message argument, only valid for as long as the argument it was made from.
+	struct MessageArg
+	{
+		MessageArgKind kind;
+
+		union
+		{
+			i64 i;
+			u64 u;
+			f64 f;
+			const char *s;
+			char c;
+		};
+
+		const void *value;
+		MessageArgFallback fallback;
+	};
+
+	template<typename T>
+	std::string FormatArgFallback(const char *spec, const MessageArg &arg)
+	{
+		return tfm::format(spec, *static_cast<const T *>(arg.value));
+	}
+
+	inline std::string FormatStringArgFallback(const char *spec, const MessageArg &arg)
+	{
+		return tfm::format(spec, arg.s);
+	}
+
+	template<typename T>
+	MessageArg MakeMessageArg(const T &value)
+	{
+		using Type = std::remove_cv_t<T>;
+		MessageArg arg {};
+		arg.value = &value;
+		arg.fallback = FormatArgFallback<T>;
+		// bool, signed char and unsigned char print differently from other integers in tinyformat, they always take the fallback.
+		if constexpr (std::is_same_v<Type, char>)
+		{
+			arg.kind = MESSAGE_ARG_CHAR;
+			arg.c = value;
+		}
+		else if constexpr (std::is_same_v<Type, bool> || std::is_same_v<Type, signed char> || std::is_same_v<Type, unsigned char>)
+		{
+			arg.kind = MESSAGE_ARG_OTHER;
+		}
+		else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+		{
+			arg.kind = MESSAGE_ARG_INT;
+			arg.i = value;
+		}
+		else if constexpr (std::is_integral_v<Type>)
+		{
+			arg.kind = MESSAGE_ARG_UINT;
+			arg.u = value;
+		}
+		else if constexpr (std::is_floating_point_v<Type>)
+		{
+			arg.kind = MESSAGE_ARG_FLOAT;
+			arg.f = value;
+		}
+		else if constexpr (std::is_array_v<Type> || std::is_same_v<Type, const char *> || std::is_same_v<Type, char *>)
+		{
+			arg.kind = MESSAGE_ARG_STRING;
+			arg.s = value;
+			arg.fallback = FormatStringArgFallback;
+		}
+		else if constexpr (std::is_same_v<Type, std::string>)
+		{
+			arg.kind = MESSAGE_ARG_STRING;
+			arg.s = value.c_str();
+		}
+		else
+		{
+			arg.kind = MESSAGE_ARG_OTHER;
+		}
+		return arg;
+	}
+
+	// Compile every translation of every phrase that has a format. Called after all phrase files are loaded.
+	void CompileTranslations(KeyValues *translations);
+	void ClearCompiledTranslations();
+
+	// Format a translation returned by GetTranslatedFormat into the buffer, always null terminated if size isn't 0.
+	// Returns the length of the full message like snprintf does, or -1 if the translation isn't compiled.
+	i32 FormatCompiledMessage(const char *translation, char *buffer, u32 size, const MessageArg *args, u32 argCount);
+} // namespace KZ::language
@@ -6,12 +6,15 @@
 #include "kz/course/kz_course.h"
 #include "kz/mode/kz_mode.h"
 #include "kz/trigger/kz_trigger.h"
+#include "kz/trigger/trigger_table.h"
 #include "movement/movement.h"
 #include "kz_mappingapi.h"
 #include "entity2/entitykeyvalues.h"
 #include "sdk/entity/cbasetrigger.h"
 #include "utils/ctimer.h"
 
+#include <unordered_map>
+
 #include "tier0/memdbgon.h"
 
 #define KEY_TRIGGER_TYPE         "timer_trigger_type"
@@ -31,6 +34,9 @@ static_global struct
 	bool fatalFailure;
 
 	CUtlVectorFixed<KzTrigger, 2048> triggers;
+	// Touch callbacks look triggers and courses up on every tick, these map entity handles and targetname hashes to indices.
+	std::unordered_map<u32, i32> triggerIndices;
+	std::unordered_map<u32, i32> courseIndices;
 	bool roundIsStarting;
 	i32 errorFlags;
 	i32 errorCount;
@@ -51,6 +57,16 @@ static_function MappingInterface g_mappingInterface;
 
 MappingInterface *g_pMappingApi = &g_mappingInterface;
 
+static_function void Mapi_RebuildCourseIndices()
+{
+	g_mappingApi.courseIndices.clear();
+	FOR_EACH_VEC(g_mappingApi.courseDescriptors, i)
+	{
+		// Keep the first course on a collision, same as the order of a linear search.
+		g_mappingApi.courseIndices.emplace(utils::HashStringCaseless(g_mappingApi.courseDescriptors[i].entityTargetname), i);
+	}
+}
+
 // TODO: add error check to make sure a course has at least 1 start zone and 1 end zone
 
 static_function void Mapi_Error(const char *format, ...)
@@ -140,6 +156,7 @@ static_function bool Mapi_CreateCourse(i32 courseNumber = 1, const char *courseN
 	}
 	i32 index = g_mappingApi.courseDescriptors.AddToTail({course, hammerId, targetName, disableCheckpoints});
 	course->descriptor = &g_mappingApi.courseDescriptors[index];
+	g_mappingApi.courseIndices.emplace(utils::HashStringCaseless(g_mappingApi.courseDescriptors[index].entityTargetname), index);
 	return true;
 }
 
@@ -334,7 +351,9 @@ static_function void Mapi_OnTriggerMultipleSpawn(const EntitySpawnInfo_t *info)
 		break;
 	}
 
-	g_mappingApi.triggers.AddToTail(trigger);
+	i32 index = g_mappingApi.triggers.AddToTail(trigger);
+	g_mappingApi.triggerIndices[trigger.entity.ToInt()] = index;
+	KZ::trigger::SetKzTrigger(trigger.entity, &g_mappingApi.triggers[index]);
 }
 
 static_function void Mapi_OnInfoTargetSpawn(const CEntityKeyValues *ekv)
@@ -393,15 +412,12 @@ static_function KzTrigger *Mapi_FindKzTrigger(CBaseTrigger *trigger)
 		return nullptr;
 	}
 
-	FOR_EACH_VEC(g_mappingApi.triggers, i)
+	auto it = g_mappingApi.triggerIndices.find(triggerHandle.ToInt());
+	if (it == g_mappingApi.triggerIndices.end())
 	{
-		if (triggerHandle == g_mappingApi.triggers[i].entity)
-		{
-			return &g_mappingApi.triggers[i];
-		}
+		return nullptr;
 	}
-
-	return nullptr;
+	return &g_mappingApi.triggers[it->second];
 }
 
 static_function KZCourseDescriptor *Mapi_FindCourse(const char *targetname)
@@ -412,6 +428,17 @@ static_function KZCourseDescriptor *Mapi_FindCourse(const char *targetname)
 		return result;
 	}
 
+	auto it = g_mappingApi.courseIndices.find(utils::HashStringCaseless(targetname));
+	if (it == g_mappingApi.courseIndices.end())
+	{
+		return result;
+	}
+	if (KZ_STREQI(g_mappingApi.courseDescriptors[it->second].entityTargetname, targetname))
+	{
+		return &g_mappingApi.courseDescriptors[it->second];
+	}
+
+	// Another targetname with the same hash, only then fall back to searching every course.
 	FOR_EACH_VEC(g_mappingApi.courseDescriptors, i)
 	{
 		if (KZ_STREQI(g_mappingApi.courseDescriptors[i].entityTargetname, targetname))
@@ -598,13 +625,18 @@ void KZ::mapapi::OnSpawn(int count, const EntitySpawnInfo_t *info)
 	if (g_mappingApi.fatalFailure)
 	{
 		g_mappingApi.triggers.RemoveAll();
+		g_mappingApi.triggerIndices.clear();
+		KZ::trigger::ClearKzTriggers();
 		g_mappingApi.courseDescriptors.RemoveAll();
+		g_mappingApi.courseIndices.clear();
 	}
 }
 
 void KZ::mapapi::OnRoundPreStart()
 {
 	g_mappingApi.triggers.RemoveAll();
+	g_mappingApi.triggerIndices.clear();
+	KZ::trigger::ClearKzTriggers();
 	g_mappingApi.roundIsStarting = true;
 }
 
@@ -698,6 +730,8 @@ void KZ::mapapi::OnRoundStart()
 		courseDescriptor->checkpointCount = cpCount;
 		courseDescriptor->stageCount = stageCount;
 	}
+	// Invalid courses were swapped with the last one, which moves indices around.
+	Mapi_RebuildCourseIndices();
 }
 
 void KZ::mapapi::CheckEndTimerTrigger(CBaseTrigger *trigger)
@@ -16,6 +16,7 @@
 #include "kz/option/kz_option.h"
 #include "kz/spec/kz_spec.h"
 #include "kz/goto/kz_goto.h"
+#include "kz/replays/kz_replays.h"
 #include "kz/telemetry/kz_telemetry.h"
 #include "kz/timer/kz_timer.h"
 #include "kz/tip/kz_tip.h"
@@ -360,6 +361,7 @@ void KZ::misc::RegisterCommands()
 	scmd::RegisterCmd("switchhandsright", Command_KzSwitchHands, true);
 	// TODO: Fullupdate spectators on spec_mode/spec_next/spec_player/spec_prev
 	KZGotoService::RegisterCommands();
+	KZReplayService::RegisterCommands();
 	KZCheckpointService::RegisterCommands();
 	KZJumpstatsService::RegisterCommands();
 	KZTimerService::RegisterCommands();
@@ -2,12 +2,14 @@
 #include "common.h"
 #include "kz/kz.h"
 #include "kz/option/kz_option.h"
+#include "utils/perf.h"
 // Make sure that the server can't run for too long.
 static_global ConVar *mp_roundtime {};
 static_global ConVar *mp_timelimit {};
 
 void KZ::misc::EnforceTimeLimit()
 {
+	KZ_PROFILE(__func__);
 	if (!mp_roundtime)
 	{
 		mp_roundtime = g_pCVar->GetConVar(g_pCVar->FindConVar("mp_roundtime"));
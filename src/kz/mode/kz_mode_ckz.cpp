@@ -141,10 +141,8 @@ void KZClassicModeService::Reset()
 	this->forcedUnduck = {};
 	this->postProcessMovementZSpeed = {};
 
-	this->angleHistory.RemoveAll();
-	this->leftPreRatio = {};
-	this->rightPreRatio = {};
-	this->bonusSpeed = {};
+	this->angleHistory.Clear();
+	this->prestrafe = {};
 	this->maxPre = {};
 
 	this->didTPM = {};
@@ -383,7 +381,7 @@ void KZClassicModeService::InterpolateViewAngles()
 
 	// First half of the movement, tweak the angle to be the middle of the desired angle and the last angle
 	QAngle newAngles = player->currentMoveData->m_vecViewAngles;
-	QAngle oldAngles = this->hasValidDesiredViewAngle ? this->lastValidDesiredViewAngle : this->player->moveDataPost.m_vecViewAngles;
+	QAngle oldAngles = this->hasValidDesiredViewAngle ? this->lastValidDesiredViewAngle : this->player->moveDataPost.viewAngles;
 	if (newAngles[YAW] - oldAngles[YAW] > 180)
 	{
 		newAngles[YAW] -= 360.0f;
@@ -403,7 +401,7 @@ void KZClassicModeService::InterpolateViewAngles()
 
 void KZClassicModeService::RestoreInterpolatedViewAngles()
 {
-	player->currentMoveData->m_vecViewAngles = player->moveDataPre.m_vecViewAngles;
+	player->currentMoveData->m_vecViewAngles = player->moveDataPre.viewAngles;
 	if (g_pKZUtils->GetGlobals()->frametime > 0.0f)
 	{
 		this->hasValidDesiredViewAngle = true;
@@ -440,148 +438,35 @@ void KZClassicModeService::ReduceDuckSlowdown()
 void KZClassicModeService::UpdateAngleHistory()
 {
 	CMoveData *mv = this->player->currentMoveData;
-	u32 oldEntries = 0;
-	FOR_EACH_VEC(this->angleHistory, i)
-	{
-		if (this->angleHistory[i].when + PS_TURN_RATE_WINDOW < g_pKZUtils->GetGlobals()->curtime)
-		{
-			oldEntries++;
-			continue;
-		}
-		break;
-	}
-	this->angleHistory.RemoveMultipleFromHead(oldEntries);
+	this->angleHistory.Expire(g_pKZUtils->GetGlobals()->curtime);
 	if ((this->player->GetPlayerPawn()->m_fFlags & FL_ONGROUND) == 0)
 	{
 		return;
 	}
 
-	AngleHistory *angHist = this->angleHistory.AddToTailGetPtr();
-	angHist->when = g_pKZUtils->GetGlobals()->curtime;
-	angHist->duration = g_pKZUtils->GetGlobals()->frametime;
-
-	// Not turning if velocity is null.
-	if (mv->m_vecVelocity.Length2D() == 0)
-	{
-		angHist->rate = 0;
-		return;
-	}
-
-	// Copying from WalkMove
-	Vector forward, right, up;
-	AngleVectors(mv->m_vecViewAngles, &forward, &right, &up);
-
-	f32 fmove = mv->m_flForwardMove;
-	f32 smove = -mv->m_flSideMove;
-
-	if (forward[2] != 0)
+	f32 rate = 0;
+	f32 velocityYaw, wishYaw;
+	if (KZ::ckz::GetPrestrafeYaws(mv->m_vecVelocity, mv->m_vecViewAngles, mv->m_flForwardMove, mv->m_flSideMove, velocityYaw, wishYaw))
 	{
-		forward[2] = 0;
-		VectorNormalize(forward);
+		rate = KZ::ckz::GetPrestrafeTurnRate(velocityYaw, wishYaw);
 	}
-
-	if (right[2] != 0)
-	{
-		right[2] = 0;
-		VectorNormalize(right);
-	}
-
-	Vector wishdir;
-	for (int i = 0; i < 2; i++)
-	{
-		wishdir[i] = forward[i] * fmove + right[i] * smove;
-	}
-	wishdir[2] = 0;
-
-	VectorNormalize(wishdir);
-
-	if (wishdir.Length() == 0)
-	{
-		angHist->rate = 0;
-		return;
-	}
-
-	Vector velocity = mv->m_vecVelocity;
-	velocity[2] = 0;
-	VectorNormalize(velocity);
-	QAngle accelAngle;
-	QAngle velAngle;
-	VectorAngles(wishdir, accelAngle);
-	VectorAngles(velocity, velAngle);
-	accelAngle.y = g_pKZUtils->NormalizeDeg(accelAngle.y);
-	velAngle.y = g_pKZUtils->NormalizeDeg(velAngle.y);
-	angHist->rate = g_pKZUtils->GetAngleDifference(velAngle.y, accelAngle.y, 180.0, true);
+	this->angleHistory.Add(rate, g_pKZUtils->GetGlobals()->curtime, g_pKZUtils->GetGlobals()->frametime);
 }
 
 void KZClassicModeService::CalcPrestrafe()
 {
-	f32 totalDuration = 0;
-	f32 sumWeightedAngles = 0;
-	FOR_EACH_VEC(this->angleHistory, i)
-	{
-		sumWeightedAngles += this->angleHistory[i].rate * this->angleHistory[i].duration;
-		totalDuration += this->angleHistory[i].duration;
-	}
-	f32 averageRate;
-	if (totalDuration == 0)
-	{
-		averageRate = 0;
-	}
-	else
-	{
-		averageRate = sumWeightedAngles / totalDuration;
-	}
-
-	f32 rewardRate = Clamp(fabs(averageRate) / PS_MAX_REWARD_RATE, 0.0f, 1.0f) * g_pKZUtils->GetGlobals()->frametime;
-	f32 punishRate = 0.0f;
-	if (this->player->landingTime + PS_LANDING_GRACE_PERIOD < g_pKZUtils->GetGlobals()->curtime)
-	{
-		punishRate = g_pKZUtils->GetGlobals()->frametime * PS_DECREMENT_RATIO;
-	}
-
-	if (this->player->GetPlayerPawn()->m_fFlags & FL_ONGROUND)
-	{
-		// Prevent instant full pre from crouched prestrafe.
-		Vector velocity;
-		this->player->GetVelocity(&velocity);
-
-		f32 currentPreRatio;
-		if (velocity.Length2D() <= 0.0f)
-		{
-			currentPreRatio = 0.0f;
-		}
-		else
-		{
-			currentPreRatio = pow(this->bonusSpeed / PS_SPEED_MAX * SPEED_NORMAL / velocity.Length2D(), 1 / PS_RATIO_TO_SPEED) * PS_MAX_PS_TIME;
-		}
-
-		this->leftPreRatio = MIN(this->leftPreRatio, currentPreRatio);
-		this->rightPreRatio = MIN(this->rightPreRatio, currentPreRatio);
+	f32 averageRate = this->angleHistory.GetAverageRate();
 
-		this->leftPreRatio += averageRate > PS_MIN_REWARD_RATE ? rewardRate : -punishRate;
-		this->rightPreRatio += averageRate < -PS_MIN_REWARD_RATE ? rewardRate : -punishRate;
-		this->leftPreRatio = Clamp(leftPreRatio, 0.0f, PS_MAX_PS_TIME);
-		this->rightPreRatio = Clamp(rightPreRatio, 0.0f, PS_MAX_PS_TIME);
-		this->bonusSpeed = this->GetPrestrafeGain() / SPEED_NORMAL * velocity.Length2D();
-	}
-	else
-	{
-		rewardRate = g_pKZUtils->GetGlobals()->frametime;
-		// Raise both left and right pre to the same value as the player is in the air.
-		if (this->leftPreRatio < this->rightPreRatio)
-		{
-			this->leftPreRatio = Clamp(this->leftPreRatio + rewardRate, 0.0f, rightPreRatio);
-		}
-		else
-		{
-			this->rightPreRatio = Clamp(this->rightPreRatio + rewardRate, 0.0f, leftPreRatio);
-		}
-	}
+	bool punish = this->player->landingTime + PS_LANDING_GRACE_PERIOD < g_pKZUtils->GetGlobals()->curtime;
+	Vector velocity;
+	this->player->GetVelocity(&velocity);
+	KZ::ckz::UpdatePrestrafe(this->prestrafe, averageRate, g_pKZUtils->GetGlobals()->frametime, this->player->GetPlayerPawn()->m_fFlags & FL_ONGROUND,
+							 punish, velocity.Length2D());
 }
 
 f32 KZClassicModeService::GetPrestrafeGain()
 {
-	return PS_SPEED_MAX * pow(MAX(this->leftPreRatio, this->rightPreRatio) / PS_MAX_PS_TIME, PS_RATIO_TO_SPEED);
+	return KZ::ckz::GetPrestrafeGain(this->prestrafe);
 }
 
 void KZClassicModeService::CheckVelocityQuantization()
@@ -608,8 +493,6 @@ void KZClassicModeService::SlopeFix()
 	Vector ground = this->player->currentMoveData->m_vecAbsOrigin;
 	ground.z -= 2;
 
-	f32 standableZ = 0.7f; // Equal to the mode's cvar.
-
 	bbox_t bounds;
 	this->player->GetBBoxBounds(&bounds);
 	trace_t trace;
@@ -622,29 +505,10 @@ void KZClassicModeService::SlopeFix()
 	{
 		return;
 	}
-	// TODO: Unhardcode sv_standable_normal
-	if (standableZ <= trace.m_vHitNormal.z && trace.m_vHitNormal.z < 1.0f)
+	if (KZ::ckz::IsSlopeFixNormal(trace.m_vHitNormal))
 	{
-		// Copy the ClipVelocity function from sdk2013
-		float backoff;
-		float change;
 		Vector newVelocity;
-
-		backoff = DotProduct(this->player->landingVelocity, trace.m_vHitNormal) * 1;
-
-		for (u32 i = 0; i < 3; i++)
-		{
-			change = trace.m_vHitNormal[i] * backoff;
-			newVelocity[i] = this->player->landingVelocity[i] - change;
-		}
-
-		f32 adjust = DotProduct(newVelocity, trace.m_vHitNormal);
-		if (adjust < 0.0f)
-		{
-			newVelocity -= (trace.m_vHitNormal * adjust);
-		}
-		// Make sure the player is going down a ramp by checking if they actually will gain speed from the boost.
-		if (newVelocity.Length2D() >= this->player->landingVelocity.Length2D())
+		if (KZ::ckz::ClipLandingVelocity(this->player->landingVelocity, trace.m_vHitNormal, newVelocity))
 		{
 			this->player->currentMoveData->m_vecVelocity.x = newVelocity.x;
 			this->player->currentMoveData->m_vecVelocity.y = newVelocity.y;
@@ -654,15 +518,6 @@ void KZClassicModeService::SlopeFix()
 	}
 }
 
-// 1:1 with CS2.
-static_function void ClipVelocity(Vector &in, Vector &normal, Vector &out)
-{
-	f32 backoff = -((in.x * normal.x) + ((normal.z * in.z) + (in.y * normal.y))) * 1;
-	backoff = fmaxf(backoff, 0.0) + 0.03125;
-
-	out = normal * backoff + in;
-}
-
 static_function bool IsValidMovementTrace(trace_t &tr, bbox_t bounds, CTraceFilterPlayerMovementCS *filter)
 {
 	trace_t stuck;
@@ -888,59 +743,11 @@ void KZClassicModeService::OnTryPlayerMove(Vector *pFirstDest, trace_t *pFirstTr
 
 		if (numPlanes == 1 && pawn->m_MoveType() == MOVETYPE_WALK && pawn->m_hGroundEntity().Get() == nullptr)
 		{
-			ClipVelocity(velocity, planes[0], velocity);
+			KZ::ckz::ClipVelocity(velocity, planes[0], velocity);
 		}
-		else
+		else if (!KZ::ckz::ClipVelocityToPlanes(velocity, primalVelocity, planes, numPlanes))
 		{
-			u32 i, j;
-			for (i = 0; i < numPlanes; i++)
-			{
-				ClipVelocity(velocity, planes[i], velocity);
-				for (j = 0; j < numPlanes; j++)
-				{
-					if (j != i)
-					{
-						// Are we now moving against this plane?
-						if (velocity.Dot(planes[j]) < 0)
-						{
-							break; // not ok
-						}
-					}
-				}
-
-				if (j == numPlanes) // Didn't have to clip, so we're ok
-				{
-					break;
-				}
-			}
-			// Did we go all the way through plane set
-			if (i != numPlanes)
-			{ // go along this plane
-				// pmove.velocity is set in clipping call, no need to set again.
-				;
-			}
-			else
-			{ // go along the crease
-				if (numPlanes != 2)
-				{
-					VectorCopy(vec3_origin, velocity);
-					break;
-				}
-				Vector dir;
-				f32 d;
-				CrossProduct(planes[0], planes[1], dir);
-				// Yes, that's right, you need to do this twice because running it once won't ensure that this will be fully normalized.
-				dir.NormalizeInPlace();
-				dir.NormalizeInPlace();
-				d = dir.Dot(velocity);
-				VectorScale(dir, d, velocity);
-
-				if (velocity.Dot(primalVelocity) <= 0)
-				{
-					velocity = vec3_origin;
-					break;
-				}
-			}
+			break;
 		}
 	}
 	this->tpmOrigin = pm.m_vEndPos;
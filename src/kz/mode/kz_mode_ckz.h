@@ -1,6 +1,7 @@
 #pragma once
 
 #include "kz_mode.h"
+#include "kz_mode_ckz_prestrafe.h"
 #include "sdk/datatypes.h"
 
 #define MODE_NAME_SHORT "CKZ"
@@ -11,19 +12,6 @@
 #define RAMP_BUG_THRESHOLD          0.98f
 #define RAMP_BUG_VELOCITY_THRESHOLD 0.95f
 #define NEW_RAMP_THRESHOLD          0.95f
-
-#define SPEED_NORMAL 250.0f
-// Prestrafe related
-#define PS_SPEED_MAX        26.0f
-#define PS_MIN_REWARD_RATE  7.0f  // Minimum computed turn rate for any prestrafe reward
-#define PS_MAX_REWARD_RATE  16.0f // Ideal computed turn rate for maximum prestrafe reward
-#define PS_MAX_PS_TIME      0.55f // Time to reach maximum prestrafe speed with optimal turning
-#define PS_TURN_RATE_WINDOW 0.02f // Turn rate will be computed over this amount of time
-#define PS_DECREMENT_RATIO  3.0f  // Prestrafe will lose this fast compared to gaining
-#define PS_RATIO_TO_SPEED   0.5f
-// Prestrafe ratio will be not go down after landing for this amount of time - helps with small movements after landing
-// Ideally should be much higher than the perf window!
-#define PS_LANDING_GRACE_PERIOD 0.25f
 // Bhop related
 #define BH_PERF_WINDOW                  0.02f // Any jump performed after landing will be a perf for this much time
 #define BH_BASE_MULTIPLIER              51.5f // Multiplier for how much speed would a perf gain in ideal scenario
@@ -107,17 +95,8 @@ class KZClassicModeService : public KZModeService
 	bool forcedUnduck {};
 	f32 postProcessMovementZSpeed {};
 
-	struct AngleHistory
-	{
-		f32 rate;
-		f32 when;
-		f32 duration;
-	};
-
-	CUtlVector<AngleHistory> angleHistory;
-	f32 leftPreRatio {};
-	f32 rightPreRatio {};
-	f32 bonusSpeed {};
+	KZ::ckz::AngleHistory angleHistory;
+	KZ::ckz::PrestrafeState prestrafe {};
 	f32 maxPre {};
 	f32 originalMaxSpeed {};
 	f32 tweakedMaxSpeed {};
@@ -0,0 +1,332 @@
+#pragma once
+
+#include "common.h"
+#include "mathlib/mathlib.h"
+
+#define SPEED_NORMAL 250.0f
+// Prestrafe related
+#define PS_SPEED_MAX        26.0f
+#define PS_MIN_REWARD_RATE  7.0f  // Minimum computed turn rate for any prestrafe reward
+#define PS_MAX_REWARD_RATE  16.0f // Ideal computed turn rate for maximum prestrafe reward
+#define PS_MAX_PS_TIME      0.55f // Time to reach maximum prestrafe speed with optimal turning
+#define PS_TURN_RATE_WINDOW 0.02f // Turn rate will be computed over this amount of time
+#define PS_DECREMENT_RATIO  3.0f  // Prestrafe will lose this fast compared to gaining
+#define PS_RATIO_TO_SPEED   0.5f
+// Prestrafe ratio will be not go down after landing for this amount of time - helps with small movements after landing
+// Ideally should be much higher than the perf window!
+#define PS_LANDING_GRACE_PERIOD 0.25f
+// Angle history entries stay for PS_TURN_RATE_WINDOW, which spans this many ticks.
+#define PS_ANGLE_HISTORY_TICKS ((u32)(PS_TURN_RATE_WINDOW / ENGINE_FIXED_TICK_INTERVAL) + 2)
+// Leaves room for a burst of commands processed within one tick, the oldest entry is dropped past this.
+#define PS_ANGLE_HISTORY_SIZE (PS_ANGLE_HISTORY_TICKS * 8)
+// Equal to the sv_standable_normal value the mode sets.
+#define STANDABLE_NORMAL 0.7f
+
+/*
+	Movement math of the classic mode that doesn't depend on the engine, the mode service only gathers the inputs
+	(move data, globals, traces) and applies the results. Keeping it free of entity and interface access means
+	the per-tick cost can be measured and the output compared bit for bit outside of a running server, which
+	kz_mode_ckz_prestrafe_bench.cpp does with usercmd captures. The traces themselves (ramp piercing in
+	TryPlayerMove, the ground trace of SlopeFix) need the collision of the map and stay in the mode service.
+*/
+
+namespace KZ
+{
+	namespace ckz
+	{
+		// Yaw of the horizontal wish direction and velocity, as used to compute the turn rate of the player.
+		// Returns false if either of them is null, the player isn't turning then.
+		inline bool GetPrestrafeYaws(const Vector &velocity, const QAngle &viewAngles, f32 forwardMove, f32 sideMove, f32 &velocityYaw,
+									 f32 &wishYaw)
+		{
+			if (velocity.Length2D() == 0)
+			{
+				return false;
+			}
+
+			// Copying from WalkMove
+			Vector forward, right, up;
+			AngleVectors(viewAngles, &forward, &right, &up);
+
+			f32 fmove = forwardMove;
+			f32 smove = -sideMove;
+
+			if (forward[2] != 0)
+			{
+				forward[2] = 0;
+				VectorNormalize(forward);
+			}
+
+			if (right[2] != 0)
+			{
+				right[2] = 0;
+				VectorNormalize(right);
+			}
+
+			Vector wishdir;
+			for (int i = 0; i < 2; i++)
+			{
+				wishdir[i] = forward[i] * fmove + right[i] * smove;
+			}
+			wishdir[2] = 0;
+
+			VectorNormalize(wishdir);
+
+			if (wishdir.Length() == 0)
+			{
+				return false;
+			}
+
+			Vector horizontalVelocity = velocity;
+			horizontalVelocity[2] = 0;
+			VectorNormalize(horizontalVelocity);
+			QAngle accelAngle;
+			QAngle velAngle;
+			VectorAngles(wishdir, accelAngle);
+			VectorAngles(horizontalVelocity, velAngle);
+			velocityYaw = velAngle.y;
+			wishYaw = accelAngle.y;
+			return true;
+		}
+
+		// Same as utils::NormalizeDeg.
+		inline f32 NormalizeYaw(f32 a)
+		{
+			a = fmod(a, 360.0);
+			if (a >= 180.0)
+			{
+				a -= 360.0;
+			}
+			else if (a < -180.0)
+			{
+				a += 360.0;
+			}
+			return a;
+		}
+
+		// Signed turn rate from the yaws returned by GetPrestrafeYaws, same as utils::GetAngleDifference(velocityYaw, wishYaw, 180.0, true).
+		inline f32 GetPrestrafeTurnRate(f32 velocityYaw, f32 wishYaw)
+		{
+			const f32 c = 180.0;
+			f32 source = NormalizeYaw(velocityYaw);
+			f32 target = NormalizeYaw(wishYaw);
+			return fmod((fmod(target - source, 2 * c) + 3 * c), 2 * c) - c;
+		}
+
+		// Turn rates of the last PS_TURN_RATE_WINDOW seconds on the ground, oldest first.
+		class AngleHistory
+		{
+		public:
+			void Clear()
+			{
+				this->head = 0;
+				this->count = 0;
+			}
+
+			// Drop entries from the head until one is still inside the window.
+			void Expire(f32 curtime)
+			{
+				while (this->count > 0 && this->entries[this->head].when + PS_TURN_RATE_WINDOW < curtime)
+				{
+					this->head = (this->head + 1) % PS_ANGLE_HISTORY_SIZE;
+					this->count--;
+				}
+			}
+
+			void Add(f32 rate, f32 when, f32 duration)
+			{
+				if (this->count == PS_ANGLE_HISTORY_SIZE)
+				{
+					this->head = (this->head + 1) % PS_ANGLE_HISTORY_SIZE;
+					this->count--;
+				}
+				this->entries[(this->head + this->count) % PS_ANGLE_HISTORY_SIZE] = {rate, when, duration};
+				this->count++;
+			}
+
+			// Turn rate weighted by the duration of each entry.
+			// Summed oldest first on every call, float sums kept across ticks would drift from this by rounding.
+			f32 GetAverageRate() const
+			{
+				f32 totalDuration = 0;
+				f32 sumWeightedAngles = 0;
+				for (u32 i = 0; i < this->count; i++)
+				{
+					const Entry &entry = this->entries[(this->head + i) % PS_ANGLE_HISTORY_SIZE];
+					sumWeightedAngles += entry.rate * entry.duration;
+					totalDuration += entry.duration;
+				}
+				if (totalDuration == 0)
+				{
+					return 0;
+				}
+				return sumWeightedAngles / totalDuration;
+			}
+
+		private:
+			struct Entry
+			{
+				f32 rate;
+				f32 when;
+				f32 duration;
+			};
+
+			Entry entries[PS_ANGLE_HISTORY_SIZE];
+			u32 head {};
+			u32 count {};
+		};
+
+		struct PrestrafeState
+		{
+			f32 leftPreRatio;
+			f32 rightPreRatio;
+			f32 bonusSpeed;
+		};
+
+		inline f32 GetPrestrafeGain(const PrestrafeState &state)
+		{
+			return PS_SPEED_MAX * pow(MAX(state.leftPreRatio, state.rightPreRatio) / PS_MAX_PS_TIME, PS_RATIO_TO_SPEED);
+		}
+
+		// Advance the prestrafe by one tick, averageRate is the turn rate of the player over the last PS_TURN_RATE_WINDOW seconds.
+		// speed2D is only used on the ground, punish is false during the grace period after landing.
+		inline void UpdatePrestrafe(PrestrafeState &state, f32 averageRate, f32 frametime, bool onGround, bool punish, f32 speed2D)
+		{
+			f32 rewardRate = Clamp(fabs(averageRate) / PS_MAX_REWARD_RATE, 0.0f, 1.0f) * frametime;
+			f32 punishRate = 0.0f;
+			if (punish)
+			{
+				punishRate = frametime * PS_DECREMENT_RATIO;
+			}
+
+			if (onGround)
+			{
+				// Prevent instant full pre from crouched prestrafe.
+				f32 currentPreRatio;
+				if (speed2D <= 0.0f)
+				{
+					currentPreRatio = 0.0f;
+				}
+				else
+				{
+					currentPreRatio = pow(state.bonusSpeed / PS_SPEED_MAX * SPEED_NORMAL / speed2D, 1 / PS_RATIO_TO_SPEED) * PS_MAX_PS_TIME;
+				}
+
+				state.leftPreRatio = MIN(state.leftPreRatio, currentPreRatio);
+				state.rightPreRatio = MIN(state.rightPreRatio, currentPreRatio);
+
+				state.leftPreRatio += averageRate > PS_MIN_REWARD_RATE ? rewardRate : -punishRate;
+				state.rightPreRatio += averageRate < -PS_MIN_REWARD_RATE ? rewardRate : -punishRate;
+				state.leftPreRatio = Clamp(state.leftPreRatio, 0.0f, PS_MAX_PS_TIME);
+				state.rightPreRatio = Clamp(state.rightPreRatio, 0.0f, PS_MAX_PS_TIME);
+				state.bonusSpeed = GetPrestrafeGain(state) / SPEED_NORMAL * speed2D;
+			}
+			else
+			{
+				rewardRate = frametime;
+				// Raise both left and right pre to the same value as the player is in the air.
+				if (state.leftPreRatio < state.rightPreRatio)
+				{
+					state.leftPreRatio = Clamp(state.leftPreRatio + rewardRate, 0.0f, state.rightPreRatio);
+				}
+				else
+				{
+					state.rightPreRatio = Clamp(state.rightPreRatio + rewardRate, 0.0f, state.leftPreRatio);
+				}
+			}
+		}
+
+		// SlopeFix only applies to ground the player can stand on that isn't flat.
+		inline bool IsSlopeFixNormal(const Vector &normal)
+		{
+			return STANDABLE_NORMAL <= normal.z && normal.z < 1.0f;
+		}
+
+		// Collision of the landing velocity with a slope, as done by ClipVelocity in sdk2013.
+		// Returns false if the player wouldn't gain horizontal speed from it.
+		inline bool ClipLandingVelocity(const Vector &landingVelocity, const Vector &normal, Vector &newVelocity)
+		{
+			float backoff;
+			float change;
+
+			backoff = DotProduct(landingVelocity, normal) * 1;
+
+			for (u32 i = 0; i < 3; i++)
+			{
+				change = normal[i] * backoff;
+				newVelocity[i] = landingVelocity[i] - change;
+			}
+
+			f32 adjust = DotProduct(newVelocity, normal);
+			if (adjust < 0.0f)
+			{
+				newVelocity -= (normal * adjust);
+			}
+			// Make sure the player is going down a ramp by checking if they actually will gain speed from the boost.
+			return newVelocity.Length2D() >= landingVelocity.Length2D();
+		}
+
+		// 1:1 with CS2.
+		inline void ClipVelocity(const Vector &in, const Vector &normal, Vector &out)
+		{
+			f32 backoff = -((in.x * normal.x) + ((normal.z * in.z) + (in.y * normal.y))) * 1;
+			backoff = fmaxf(backoff, 0.0) + 0.03125;
+
+			out = normal * backoff + in;
+		}
+
+		// Clip the velocity against every plane hit during TryPlayerMove so far, the player slides along a crease of two planes.
+		// Returns false if the player got stuck and the velocity was zeroed.
+		inline bool ClipVelocityToPlanes(Vector &velocity, const Vector &primalVelocity, const Vector *planes, u32 numPlanes)
+		{
+			u32 i, j;
+			for (i = 0; i < numPlanes; i++)
+			{
+				ClipVelocity(velocity, planes[i], velocity);
+				for (j = 0; j < numPlanes; j++)
+				{
+					if (j != i)
+					{
+						// Are we now moving against this plane?
+						if (velocity.Dot(planes[j]) < 0)
+						{
+							break; // not ok
+						}
+					}
+				}
+
+				if (j == numPlanes) // Didn't have to clip, so we're ok
+				{
+					break;
+				}
+			}
+			// Did we go all the way through plane set
+			if (i != numPlanes)
+			{ // go along this plane
+				// pmove.velocity is set in clipping call, no need to set again.
+				return true;
+			}
+			// go along the crease
+			if (numPlanes != 2)
+			{
+				VectorCopy(vec3_origin, velocity);
+				return false;
+			}
+			Vector dir;
+			f32 d;
+			CrossProduct(planes[0], planes[1], dir);
+			// Yes, that's right, you need to do this twice because running it once won't ensure that this will be fully normalized.
+			dir.NormalizeInPlace();
+			dir.NormalizeInPlace();
+			d = dir.Dot(velocity);
+			VectorScale(dir, d, velocity);
+
+			if (velocity.Dot(primalVelocity) <= 0)
+			{
+				velocity = vec3_origin;
+				return false;
+			}
+			return true;
+		}
+	} // namespace ckz
+} // namespace KZ
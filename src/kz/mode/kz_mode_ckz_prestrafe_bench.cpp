@@ -0,0 +1,202 @@
+// Runs the engine independent movement math of the classic mode (prestrafe, velocity clipping, slope fix) over the move data
+// of a usercmd capture (see usercmd_capture.h) and prints the cost per tick and a checksum of every result. The checksum only
+// changes if a result changes bit for bit, so a capture can be used to check that an optimization of kz_mode_ckz_prestrafe.h
+// keeps the movement the same.
+//
+// Captures don't contain the map's collision, so the traces of TryPlayerMove and SlopeFix aren't run: the planes they would
+// hit are taken from the collision and ground normals the capture recorded, and the landing velocity from the velocity
+// before the tick's movement.
+//
+//   cs2kz-bench-prestrafe <capture.kzuc> [iterations]
+//
+// Captures are recorded into kzcaptures/<map>/ of the game directory when the usercmdCapture server option is set.
+// The tool links tier0 like the plugin does, run it with the game's bin directory in the library path.
+
+#include "kz_mode_ckz_prestrafe.h"
+#include "kz/replays/capture_reader.h"
+
+#include <stdio.h>
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::replays;
+
+#define BENCH_DEFAULT_ITERATIONS 100
+
+// What OnProcessMovement and OnStartTouchGround of the mode see on one tick.
+struct BenchTick
+{
+	f32 curtime;
+	bool onGround;
+	Vector velocity;
+	QAngle viewAngles;
+	f32 forwardMove;
+	f32 sideMove;
+
+	// Plane the player collided with during this tick, null if there was none.
+	Vector collisionNormal;
+
+	// The player touched the ground during this tick.
+	bool landed;
+	Vector landingVelocity;
+	Vector groundNormal;
+};
+
+static_function bool LoadFile(const char *path, CUtlVector<u8> &out)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	out.SetCount(MAX(size, 0));
+	bool success = size > 0 && fread(out.Base(), 1, size, file) == (size_t)size;
+	fclose(file);
+	return success;
+}
+
+// Every tick of the capture becomes one bench tick, decoding is kept out of the measured loop.
+static_function bool LoadTicks(const CUtlVector<u8> &data, CUtlVector<BenchTick> &ticks, f32 &tickInterval)
+{
+	CaptureReplayer replayer;
+	if (!replayer.Init(data.Base(), data.Count()))
+	{
+		return false;
+	}
+	tickInterval = replayer.GetHeader()->tickInterval;
+
+	CaptureTick captured;
+	while (replayer.NextTick(captured))
+	{
+		BenchTick *tick = ticks.AddToTailGetPtr();
+		tick->curtime = captured.pre.tickCount * tickInterval;
+		tick->onGround = (captured.pre.flags & MOVEDATA_IN_AIR) == 0;
+		tick->velocity = captured.pre.velocity;
+		tick->viewAngles = captured.pre.viewAngles;
+		tick->forwardMove = captured.pre.forwardMove;
+		tick->sideMove = captured.pre.sideMove;
+		tick->collisionNormal = captured.post.collisionNormal;
+		// The velocity before the movement code ran is the closest to the landing velocity the capture has.
+		tick->landed = !tick->onGround && (captured.post.flags & MOVEDATA_IN_AIR) == 0;
+		tick->landingVelocity = captured.pre.velocity;
+		tick->groundNormal = captured.post.groundNormal;
+	}
+	return ticks.Count() > 0;
+}
+
+// FNV-1a
+static_function u64 HashBytes(u64 hash, const void *data, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ ((const u8 *)data)[i]) * 0x100000001B3ull;
+	}
+	return hash;
+}
+
+static_function u64 RunTicks(const CUtlVector<BenchTick> &ticks, f32 frametime)
+{
+	u64 checksum = 0xCBF29CE484222325ull;
+	KZ::ckz::AngleHistory angleHistory;
+	angleHistory.Clear();
+	KZ::ckz::PrestrafeState prestrafe {};
+	f32 landingTime = 0.0f;
+	FOR_EACH_VEC(ticks, i)
+	{
+		const BenchTick &tick = ticks[i];
+
+		// KZClassicModeService::UpdateAngleHistory
+		angleHistory.Expire(tick.curtime);
+		if (tick.onGround)
+		{
+			f32 rate = 0;
+			f32 velocityYaw, wishYaw;
+			if (KZ::ckz::GetPrestrafeYaws(tick.velocity, tick.viewAngles, tick.forwardMove, tick.sideMove, velocityYaw, wishYaw))
+			{
+				rate = KZ::ckz::GetPrestrafeTurnRate(velocityYaw, wishYaw);
+			}
+			angleHistory.Add(rate, tick.curtime, frametime);
+		}
+
+		// KZClassicModeService::CalcPrestrafe
+		bool punish = landingTime + PS_LANDING_GRACE_PERIOD < tick.curtime;
+		KZ::ckz::UpdatePrestrafe(prestrafe, angleHistory.GetAverageRate(), frametime, tick.onGround, punish, tick.velocity.Length2D());
+		checksum = HashBytes(checksum, &prestrafe, sizeof(prestrafe));
+
+		// KZClassicModeService::OnTryPlayerMove, only the plane the capture recorded, piercing ramps needs the map's collision.
+		if (tick.collisionNormal != vec3_origin)
+		{
+			Vector velocity = tick.velocity;
+			if (tick.onGround)
+			{
+				KZ::ckz::ClipVelocityToPlanes(velocity, tick.velocity, &tick.collisionNormal, 1);
+			}
+			else
+			{
+				KZ::ckz::ClipVelocity(velocity, tick.collisionNormal, velocity);
+			}
+			checksum = HashBytes(checksum, &velocity, sizeof(velocity));
+		}
+
+		// KZClassicModeService::SlopeFix
+		if (tick.landed)
+		{
+			landingTime = tick.curtime;
+			if (KZ::ckz::IsSlopeFixNormal(tick.groundNormal))
+			{
+				Vector newVelocity;
+				bool clipped = KZ::ckz::ClipLandingVelocity(tick.landingVelocity, tick.groundNormal, newVelocity);
+				checksum = HashBytes(checksum, &clipped, sizeof(clipped));
+				checksum = HashBytes(checksum, &newVelocity, sizeof(newVelocity));
+			}
+		}
+	}
+	return checksum;
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <capture.kzuc> [iterations]\n", argv[0]);
+		return 1;
+	}
+	i32 iterations = argc >= 3 ? V_StringToInt32(argv[2], BENCH_DEFAULT_ITERATIONS) : BENCH_DEFAULT_ITERATIONS;
+	iterations = MAX(iterations, 1);
+
+	CUtlVector<u8> data;
+	if (!LoadFile(argv[1], data))
+	{
+		printf("Failed to read %s\n", argv[1]);
+		return 1;
+	}
+	CUtlVector<BenchTick> ticks;
+	f32 tickInterval;
+	if (!LoadTicks(data, ticks, tickInterval))
+	{
+		printf("%s is not a usercmd capture or has no move data\n", argv[1]);
+		return 1;
+	}
+
+	u64 checksum = RunTicks(ticks, tickInterval);
+	bool deterministic = true;
+	f64 start = Plat_FloatTime();
+	for (i32 i = 0; i < iterations; i++)
+	{
+		deterministic &= RunTicks(ticks, tickInterval) == checksum;
+	}
+	f64 elapsed = Plat_FloatTime() - start;
+
+	printf("%i ticks, %i iterations\n", ticks.Count(), iterations);
+	printf("  %.1f ns/tick\n", elapsed * 1e9 / ((f64)iterations * ticks.Count()));
+	printf("  checksum %016llx\n", (unsigned long long)checksum);
+	if (!deterministic)
+	{
+		printf("  Warning: the iterations returned different results!\n");
+		return 1;
+	}
+	return 0;
+}
@@ -9,6 +9,10 @@
 #include "kz/option/kz_option.h"
 #include "utils/utils.h"
 
+#ifdef _WIN32
+#include <intrin.h>
+#endif
+
 static_global class KZOptionServiceEventListener_Quiet : public KZOptionServiceEventListener
 {
 	virtual void OnPlayerPreferencesLoaded(KZPlayer *player)
@@ -17,12 +21,56 @@ static_global class KZOptionServiceEventListener_Quiet : public KZOptionServiceE
 	}
 } optionEventListener;
 
+// Where the transmit bit of a pawn lives, CBitVec stores its bits in 32-bit words.
+struct PawnTransmitBit
+{
+	u32 word;
+	u32 mask;
+};
+
+static_function PawnTransmitBit GetTransmitBit(CCSPlayerPawn *pawn)
+{
+	return {(u32)pawn->entindex() >> 5, 1u << (pawn->entindex() & 31)};
+}
+
 void KZ::quiet::OnCheckTransmit(CCheckTransmitInfo **pInfo, int infoCount)
 {
+	// Gather every pawn once per frame instead of once per recipient.
+	PawnTransmitBit pawnBits[MAXPLAYERS];
+	u64 pawnSlots = 0;
+	// Pawns without a controller are never transmitted to prevent crashes, they don't belong to any player slot.
+	CUtlVectorFixed<PawnTransmitBit, MAXPLAYERS> orphanPawns;
+
+	EntityInstanceByClassIter_t iter(NULL, "player");
+	// clang-format off
+	for (CCSPlayerPawn *pawn = static_cast<CCSPlayerPawn *>(iter.First());
+		 pawn != NULL;
+		 pawn = pawn->m_pEntity->m_pNextByClass ? static_cast<CCSPlayerPawn *>(pawn->m_pEntity->m_pNextByClass->m_pInstance) : nullptr)
+	// clang-format on
+	{
+		if (!pawn->m_hController().IsValid())
+		{
+			if (orphanPawns.Count() < MAXPLAYERS)
+			{
+				orphanPawns.AddToTail(GetTransmitBit(pawn));
+			}
+			continue;
+		}
+		KZPlayer *player = g_pKZPlayerManager->ToPlayer(pawn);
+		if (!player)
+		{
+			continue;
+		}
+		u32 slot = player->GetPlayerSlot().Get();
+		pawnBits[slot] = GetTransmitBit(pawn);
+		pawnSlots |= 1ull << slot;
+	}
+
 	for (int i = 0; i < infoCount; i++)
 	{
 		// Cast it to our own TransmitInfo struct because CCheckTransmitInfo isn't correct.
 		TransmitInfo *pTransmitInfo = reinterpret_cast<TransmitInfo *>(pInfo[i]);
+		u32 *transmitWords = pTransmitInfo->m_pTransmitEdict->Base();
 
 		// Find out who this info will be sent to.
 		uintptr_t targetAddr = reinterpret_cast<uintptr_t>(pTransmitInfo) + g_pGameConfig->GetOffset("QuietPlayerSlot");
@@ -37,59 +85,44 @@ void KZ::quiet::OnCheckTransmit(CCheckTransmitInfo **pInfo, int infoCount)
 		targetPlayer->quietService->UpdateHideState();
 		CCSPlayerPawn *targetPlayerPawn = targetPlayer->GetPlayerPawn();
 
-		EntityInstanceByClassIter_t iter(NULL, "player");
-		// clang-format off
-		for (CCSPlayerPawn *pawn = static_cast<CCSPlayerPawn *>(iter.First());
-			 pawn != NULL;
-			 pawn = pawn->m_pEntity->m_pNextByClass ? static_cast<CCSPlayerPawn *>(pawn->m_pEntity->m_pNextByClass->m_pInstance) : nullptr)
-		// clang-format on
+		if (targetPlayerPawn)
 		{
-			if (targetPlayerPawn == pawn)
+			for (u32 j = 0; j < 3; j++)
 			{
-				for (u32 j = 0; j < 3; j++)
+				if (!targetPlayerPawn->m_pViewModelServices->m_hViewModel[j].IsValid())
 				{
-					if (!pawn->m_pViewModelServices->m_hViewModel[j].IsValid())
-					{
-						continue;
-					}
-					// Hide weapon stuff.
-					if (targetPlayer->quietService->ShouldHideWeapon(j))
-					{
-						pTransmitInfo->m_pTransmitEdict->Clear(pawn->m_pViewModelServices->m_hViewModel[j].GetEntryIndex());
-					}
+					continue;
+				}
+				// Hide weapon stuff.
+				if (targetPlayer->quietService->ShouldHideWeapon(j))
+				{
+					pTransmitInfo->m_pTransmitEdict->Clear(targetPlayerPawn->m_pViewModelServices->m_hViewModel[j].GetEntryIndex());
 				}
-				continue;
-			}
-			// Bit is not even set, don't bother.
-			if (!pTransmitInfo->m_pTransmitEdict->IsBitSet(pawn->entindex()))
-			{
-				continue;
-			}
-			// Do not transmit a pawn without any controller to prevent crashes.
-			if (!pawn->m_hController().IsValid())
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
-				continue;
-			}
-			// Respawn must be enabled or !hide will cause client crash.
-#if 0
-			// Never send dead players to prevent crashes.
-			if (pawn->m_lifeState() != LIFE_ALIVE)
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
-				continue;
 			}
+		}
+
+		FOR_EACH_VEC(orphanPawns, j)
+		{
+			transmitWords[orphanPawns[j].word] &= ~orphanPawns[j].mask;
+		}
+
+		// Respawn must be enabled or !hide will cause client crash.
+		if (!targetPlayer->quietService->ShouldHide())
+		{
+			continue;
+		}
+		// ShouldHideIndex only keeps the player's own pawn, so everyone else is hidden from them.
+		u64 hiddenSlots = pawnSlots & ~(1ull << targetSlot.Get());
+		while (hiddenSlots)
+		{
+#ifdef _WIN32
+			unsigned long slot;
+			_BitScanForward64(&slot, hiddenSlots);
+#else
+			u32 slot = __builtin_ctzll(hiddenSlots);
 #endif
-			// Finally check if player is using !hide.
-			if (!targetPlayer->quietService->ShouldHide())
-			{
-				continue;
-			}
-			u32 index = g_pKZPlayerManager->ToPlayer(pawn)->index;
-			if (targetPlayer->quietService->ShouldHideIndex(index))
-			{
-				pTransmitInfo->m_pTransmitEdict->Clear(pawn->entindex());
-			}
+			hiddenSlots &= hiddenSlots - 1;
+			transmitWords[pawnBits[slot].word] &= ~pawnBits[slot].mask;
 		}
 	}
 }
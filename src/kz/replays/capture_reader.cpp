@@ -0,0 +1,147 @@
+#include "capture_reader.h"
+#include "utils/varint.h"
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::replays;
+
+bool CaptureReader::Read(void *out, size_t length)
+{
+	if (length > this->size - this->cursor)
+	{
+		return false;
+	}
+	V_memcpy(out, this->data + this->cursor, length);
+	this->cursor += length;
+	return true;
+}
+
+bool CaptureReader::Init(const u8 *data, size_t size)
+{
+	if (size < sizeof(CaptureHeader))
+	{
+		return false;
+	}
+	const CaptureHeader *header = (const CaptureHeader *)data;
+	if (header->magic != KZ_CAPTURE_MAGIC || header->version != KZ_CAPTURE_VERSION)
+	{
+		return false;
+	}
+	this->data = data;
+	this->size = size;
+	this->cursor = sizeof(CaptureHeader);
+	this->header = header;
+	return true;
+}
+
+bool CaptureReader::NextRecord(CaptureRecord &out)
+{
+	u8 type;
+	if (!this->Read(&type, sizeof(type)) || type >= CAPTURE_RECORD_COUNT)
+	{
+		return false;
+	}
+	out.type = (CaptureRecordType)type;
+
+	u64 value;
+	if (out.type == CAPTURE_USERCMD)
+	{
+		if (!varint::Get(this->data, this->size, this->cursor, value))
+		{
+			return false;
+		}
+		out.commandNumber = (i32)(u32)value;
+		for (u32 i = 0; i < 3; i++)
+		{
+			if (!varint::Get(this->data, this->size, this->cursor, out.buttons[i]))
+			{
+				return false;
+			}
+		}
+		if (!varint::Get(this->data, this->size, this->cursor, value) || value > this->size - this->cursor)
+		{
+			return false;
+		}
+		out.command = this->data + this->cursor;
+		out.commandSize = (u32)value;
+		this->cursor += value;
+		return true;
+	}
+
+	if (!this->Read(&out.moveData, sizeof(out.moveData)) || !varint::Get(this->data, this->size, this->cursor, value))
+	{
+		return false;
+	}
+	out.subtickMoves.RemoveAll();
+	for (u64 i = 0; i < value; i++)
+	{
+		SubtickMove move {};
+		if (!this->Read(&move.when, sizeof(move.when)) || !varint::Get(this->data, this->size, this->cursor, move.button))
+		{
+			return false;
+		}
+		bool success;
+		if (move.button == 0)
+		{
+			success = this->Read(&move.analogMove.analog_forward_delta, sizeof(f32)) && this->Read(&move.analogMove.analog_left_delta, sizeof(f32));
+		}
+		else
+		{
+			u8 pressed;
+			success = this->Read(&pressed, sizeof(pressed));
+			move.pressed = pressed != 0;
+		}
+		if (!success)
+		{
+			return false;
+		}
+		out.subtickMoves.AddToTail(move);
+	}
+	return true;
+}
+
+bool CaptureReplayer::Init(const u8 *data, size_t size)
+{
+	this->tick = 0;
+	return this->reader.Init(data, size);
+}
+
+bool CaptureReplayer::NextTick(CaptureTick &out)
+{
+	// CaptureWriter writes the usercmd in SetupMove, then the move data before and after ProcessMovement.
+	// Commands that never reached ProcessMovement are skipped, there is nothing to compare them against.
+	out.hasCommand = false;
+	while (this->reader.NextRecord(this->record))
+	{
+		switch (this->record.type)
+		{
+			case CAPTURE_USERCMD:
+			{
+				out.hasCommand = true;
+				out.commandNumber = this->record.commandNumber;
+				V_memcpy(out.buttons, this->record.buttons, sizeof(out.buttons));
+				out.command = this->record.command;
+				out.commandSize = this->record.commandSize;
+				break;
+			}
+			case CAPTURE_MOVEDATA_PRE:
+			{
+				out.pre = this->record.moveData;
+				out.preSubtickMoves.CopyArray(this->record.subtickMoves.Base(), this->record.subtickMoves.Count());
+				if (!this->reader.NextRecord(this->record) || this->record.type != CAPTURE_MOVEDATA_POST)
+				{
+					return false;
+				}
+				out.post = this->record.moveData;
+				out.index = this->tick++;
+				return true;
+			}
+			default:
+			{
+				// A post record without its pre record, the capture started in the middle of a command.
+				break;
+			}
+		}
+	}
+	return false;
+}
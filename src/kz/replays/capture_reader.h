@@ -0,0 +1,90 @@
+// Reader for the usercmd capture logs written by CaptureWriter, see usercmd_capture.h for the layout.
+// Only used by offline tools, the plugin itself never reads captures back.
+// The movement code of the game can't run outside of the server, so CaptureReplayer hands the recorded ticks to the
+// engine independent parts of the movement code (see kz_mode_ckz_prestrafe.h) and keeps what the game made of them to compare against.
+
+#pragma once
+#include "usercmd_capture.h"
+
+namespace KZ
+{
+	namespace replays
+	{
+		struct CaptureRecord
+		{
+			CaptureRecordType type;
+
+			// CAPTURE_USERCMD
+			i32 commandNumber;
+			u64 buttons[3];
+			// Serialized CSGOUserCmdPB, points into the capture data.
+			const u8 *command;
+			u32 commandSize;
+
+			// CAPTURE_MOVEDATA_PRE/POST
+			MoveDataRecord moveData;
+			CUtlVector<SubtickMove> subtickMoves;
+		};
+
+		// Reads records sequentially straight out of a memory region.
+		class CaptureReader
+		{
+		public:
+			// Returns false if the data does not start with a valid capture header.
+			bool Init(const u8 *data, size_t size);
+
+			const CaptureHeader *GetHeader() const
+			{
+				return header;
+			}
+
+			// Returns false at the end of the data, or if the next record is truncated or corrupt.
+			bool NextRecord(CaptureRecord &out);
+
+		private:
+			const u8 *data {};
+			size_t size {};
+			size_t cursor {};
+			const CaptureHeader *header {};
+
+			bool Read(void *out, size_t length);
+		};
+
+		// One processed command, the move data it was run with and what ProcessMovement left in it.
+		struct CaptureTick
+		{
+			u32 index;
+
+			// The usercmd record preceding the move data, if the capture has one.
+			bool hasCommand;
+			i32 commandNumber;
+			u64 buttons[3];
+			const u8 *command;
+			u32 commandSize;
+
+			MoveDataRecord pre;
+			CUtlVector<SubtickMove> preSubtickMoves;
+			MoveDataRecord post;
+		};
+
+		// Groups the records of a capture back into the ticks they were written on.
+		class CaptureReplayer
+		{
+		public:
+			bool Init(const u8 *data, size_t size);
+
+			const CaptureHeader *GetHeader() const
+			{
+				return reader.GetHeader();
+			}
+
+			// Returns false at the end of the capture, or if the rest of it is truncated or corrupt.
+			bool NextTick(CaptureTick &out);
+
+		private:
+			CaptureReader reader;
+			CaptureRecord record;
+			u32 tick {};
+		};
+	} // namespace replays
+} // namespace KZ
@@ -0,0 +1,162 @@
+#include "ghost.h"
+#include "utils/plat.h"
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::replays;
+
+void Ghost::Clear()
+{
+	this->points.Purge();
+	this->distances.Purge();
+	this->frameCount = 0;
+	this->cursor = 0;
+}
+
+void Ghost::Begin(u32 preRollFrames, f32 tickInterval)
+{
+	this->Clear();
+	this->preRollFrames = preRollFrames;
+	this->tickInterval = tickInterval;
+}
+
+void Ghost::AddFrame(const Frame &frame)
+{
+	if (this->frameCount++ % KZ_GHOST_SAMPLE_INTERVAL != 0)
+	{
+		return;
+	}
+	f32 distance = this->points.Count() == 0 ? 0.0f : this->distances.Tail() + (frame.origin - this->points.Tail()).Length();
+	this->points.AddToTail(frame.origin);
+	this->distances.AddToTail(distance);
+}
+
+bool Ghost::LoadFromFile(const char *path, f64 *time)
+{
+	this->Clear();
+	if (time)
+	{
+		*time = 0.0;
+	}
+	size_t size = 0;
+	void *data = Plat_MapFile(path, &size);
+	if (!data)
+	{
+		return false;
+	}
+
+	ReplayDecoder decoder;
+	if (decoder.Init((const u8 *)data, size))
+	{
+		// The decoder made sure frameCount is backed by the keyframe table inside the file.
+		const Header *header = decoder.GetHeader();
+		if (time)
+		{
+			*time = header->time;
+		}
+		this->Begin(header->preRollFrames, header->tickInterval);
+		u32 sampleCount = header->frameCount / KZ_GHOST_SAMPLE_INTERVAL + 1;
+		this->points.EnsureCapacity(sampleCount);
+		this->distances.EnsureCapacity(sampleCount);
+		Frame frame;
+		while (decoder.NextFrame(frame))
+		{
+			this->AddFrame(frame);
+		}
+	}
+	Plat_UnmapFile(data, size);
+	this->ResetCursor();
+	return this->IsLoaded();
+}
+
+void Ghost::Swap(Ghost &other)
+{
+	this->points.Swap(other.points);
+	this->distances.Swap(other.distances);
+	V_swap(this->frameCount, other.frameCount);
+	V_swap(this->preRollFrames, other.preRollFrames);
+	V_swap(this->tickInterval, other.tickInterval);
+	V_swap(this->cursor, other.cursor);
+	V_swap(this->resyncCooldown, other.resyncCooldown);
+}
+
+void Ghost::ResetCursor()
+{
+	this->resyncCooldown = 0;
+	this->cursor = MIN(this->preRollFrames / KZ_GHOST_SAMPLE_INTERVAL, (u32)MAX(this->points.Count() - 1, 0));
+}
+
+f32 Ghost::ProjectOnSegment(u32 sample, const Vector &origin, f32 &distanceSqr) const
+{
+	const Vector &start = this->points[sample];
+	Vector segment = this->points[sample + 1] - start;
+	f32 lengthSqr = segment.LengthSqr();
+	f32 fraction = lengthSqr > 0.0f ? Clamp((origin - start).Dot(segment) / lengthSqr, 0.0f, 1.0f) : 0.0f;
+	distanceSqr = (start + segment * fraction - origin).LengthSqr();
+	return fraction;
+}
+
+f64 Ghost::GetTimeAt(const Vector &origin)
+{
+	if (!this->IsLoaded())
+	{
+		return 0.0;
+	}
+
+	u32 count = this->points.Count();
+	u32 best = this->cursor;
+	f32 bestDistanceSqr = (this->points[best] - origin).LengthSqr();
+	f32 searchLimit = this->distances[best] + KZ_GHOST_SEARCH_DISTANCE;
+	u32 searchEnd = MIN(count, best + KZ_GHOST_MAX_SEARCH_SAMPLES);
+	for (u32 i = best + 1; i < searchEnd && this->distances[i] <= searchLimit; i++)
+	{
+		f32 distanceSqr = (this->points[i] - origin).LengthSqr();
+		if (distanceSqr < bestDistanceSqr)
+		{
+			best = i;
+			bestDistanceSqr = distanceSqr;
+		}
+	}
+
+	if (this->resyncCooldown > 0)
+	{
+		this->resyncCooldown--;
+	}
+	else if (bestDistanceSqr > KZ_GHOST_RESYNC_DISTANCE * KZ_GHOST_RESYNC_DISTANCE)
+	{
+		this->resyncCooldown = KZ_GHOST_RESYNC_COOLDOWN;
+		for (u32 i = 0; i < count; i++)
+		{
+			f32 distanceSqr = (this->points[i] - origin).LengthSqr();
+			if (distanceSqr < bestDistanceSqr)
+			{
+				best = i;
+				bestDistanceSqr = distanceSqr;
+			}
+		}
+	}
+	this->cursor = best;
+
+	// The closest point can be on either side of the closest sample.
+	f64 time = this->GetSampleTime(best);
+	f32 closestSqr = bestDistanceSqr;
+	f32 distanceSqr;
+	if (best + 1 < count)
+	{
+		f32 fraction = this->ProjectOnSegment(best, origin, distanceSqr);
+		if (distanceSqr < closestSqr)
+		{
+			closestSqr = distanceSqr;
+			time = this->GetSampleTime(best) + fraction * KZ_GHOST_SAMPLE_INTERVAL * this->tickInterval;
+		}
+	}
+	if (best > 0)
+	{
+		f32 fraction = this->ProjectOnSegment(best - 1, origin, distanceSqr);
+		if (distanceSqr < closestSqr)
+		{
+			time = this->GetSampleTime(best - 1) + fraction * KZ_GHOST_SAMPLE_INTERVAL * this->tickInterval;
+		}
+	}
+	return time;
+}
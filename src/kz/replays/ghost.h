@@ -0,0 +1,61 @@
+// Path of a recorded run, used to compare a running timer against it at any point of the run instead of only at zones.
+
+#pragma once
+#include "replay_format.h"
+
+// Only every n-th frame of the replay is kept, positions in between are interpolated.
+#define KZ_GHOST_SAMPLE_INTERVAL 4
+// How far along the ghost path ahead of the cursor the closest point is searched for.
+#define KZ_GHOST_SEARCH_DISTANCE    512.0f
+#define KZ_GHOST_MAX_SEARCH_SAMPLES 256
+// If nothing ahead of the cursor is closer than this, the player most likely teleported and the whole path is searched.
+#define KZ_GHOST_RESYNC_DISTANCE 256.0f
+// Searching the whole path is expensive, don't do it every tick while the player is away from it.
+#define KZ_GHOST_RESYNC_COOLDOWN 64
+
+namespace KZ
+{
+	namespace replays
+	{
+		class Ghost
+		{
+		public:
+			void Clear();
+
+			bool IsLoaded() const
+			{
+				return points.Count() > 1;
+			}
+
+			void Begin(u32 preRollFrames, f32 tickInterval);
+			void AddFrame(const Frame &frame);
+			// Reads the whole replay, keep this off the game thread. time is set to the run time of the replay if it is valid.
+			bool LoadFromFile(const char *path, f64 *time = nullptr);
+			void Swap(Ghost &other);
+
+			// Move the cursor back to the start of the run.
+			void ResetCursor();
+			// Time into the run at which the ghost passed the point of its path closest to origin.
+			// The cursor only moves forward unless the player got far away from the path.
+			f64 GetTimeAt(const Vector &origin);
+
+		private:
+			CUtlVector<Vector> points;
+			// Distance travelled along the path up to each point.
+			CUtlVector<f32> distances;
+			u32 frameCount {};
+			u32 preRollFrames {};
+			f32 tickInterval {};
+			u32 cursor {};
+			u32 resyncCooldown {};
+
+			f64 GetSampleTime(u32 sample) const
+			{
+				return ((f64)sample * KZ_GHOST_SAMPLE_INTERVAL - preRollFrames) * tickInterval;
+			}
+
+			// Fraction of the segment from points[sample] to points[sample + 1] at which origin is closest.
+			f32 ProjectOnSegment(u32 sample, const Vector &origin, f32 &distanceSqr) const;
+		};
+	} // namespace replays
+} // namespace KZ
@@ -1 +1,682 @@
 #include "kz_replays.h"
+#include "kz/course/kz_course.h"
+#include "kz/language/kz_language.h"
+#include "kz/mode/kz_mode.h"
+#include "kz/option/kz_option.h"
+#include "kz/timer/kz_timer.h"
+#include "utils/simplecmds.h"
+#include "utils/utils.h"
+
+#include "filesystem.h"
+#include "utils/perf.h"
+
+#include <climits>
+#include <ctime>
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::replays;
+
+bool KZReplayService::recordingEnabled = true;
+bool KZReplayService::captureEnabled = false;
+u32 KZReplayService::ringCapacity = 0;
+u32 KZReplayService::maxBots = KZ_REPLAY_DEFAULT_MAX_BOTS;
+// Whether kz_replay can play the replays of other players, every player can queue replays on the bots.
+static_global bool replayAnyPlayer;
+
+static_global CUtlVector<CUtlString> pendingPlaybacks;
+static_global f64 lastBotAddTime;
+static_global u32 lastGhostLoadSerial;
+
+static_global class KZTimerServiceEventListener_Replays : public KZTimerServiceEventListener
+{
+	virtual void OnTimerStartPost(KZPlayer *player, u32 courseGUID) override
+	{
+		player->replayService->OnTimerStart();
+	}
+
+	virtual void OnTimerEndPost(KZPlayer *player, u32 courseGUID, f32 time, u32 teleportsUsed) override
+	{
+		player->replayService->OnTimerEnd(time, teleportsUsed);
+	}
+} timerEventListener;
+
+// Replace everything that could escape the replay directory or break the path.
+static_function void SanitizePathComponent(const char *input, char *output, u32 length)
+{
+	V_strncpy(output, input, length);
+	for (char *c = output; *c; c++)
+	{
+		if (!V_isalnum(*c) && *c != '_' && *c != '-')
+		{
+			*c = '_';
+		}
+	}
+}
+
+void KZReplayService::GetReplayPath(char *buffer, u32 size, u64 steamID64, const char *courseName, const char *modeShortName, bool pro)
+{
+	char map[KZ_REPLAY_MAX_NAME_LENGTH];
+	char course[KZ_REPLAY_MAX_NAME_LENGTH];
+	char mode[KZ_REPLAY_MAX_NAME_LENGTH];
+	SanitizePathComponent(g_pKZUtils->GetCurrentMapName().Get(), map, sizeof(map));
+	SanitizePathComponent(courseName, course, sizeof(course));
+	SanitizePathComponent(modeShortName, mode, sizeof(mode));
+	g_SMAPI->PathFormat(buffer, size, "%s/%s/%s/%s/%s/%llu%s.replay", g_SMAPI->GetBaseDir(), KZ_REPLAY_DIRECTORY, map, course, mode, steamID64,
+						pro ? "_pro" : "");
+}
+
+void KZReplayService::Init()
+{
+	KZReplayService::recordingEnabled = KZOptionService::GetOptionInt("replayRecording", true);
+	KZReplayService::captureEnabled = KZOptionService::GetOptionInt("usercmdCapture", false);
+	i64 maxMinutes = KZOptionService::GetOptionInt("replayMaxMinutes", KZ_REPLAY_DEFAULT_MAX_MINUTES);
+	maxMinutes = MAX(maxMinutes, 1);
+	KZReplayService::ringCapacity = (u32)(maxMinutes * 60 * ENGINE_FIXED_TICK_RATE);
+	KZReplayService::maxBots = (u32)MAX(KZOptionService::GetOptionInt("replayMaxBots", KZ_REPLAY_DEFAULT_MAX_BOTS), 0);
+	replayAnyPlayer = KZOptionService::GetOptionInt("replayAnyPlayer", false);
+	KZTimerService::RegisterEventListener(&timerEventListener);
+	StartWriter();
+}
+
+void KZReplayService::Cleanup()
+{
+	// Buffered captures still need the writer.
+	for (u32 i = 0; i < MAXPLAYERS + 1; i++)
+	{
+		g_pKZPlayerManager->ToPlayer(i)->replayService->capture.End();
+	}
+	StopWriter();
+}
+
+void KZReplayService::Reset()
+{
+	// Keep the ring buffer allocated, it will be reused by the next player in this slot.
+	this->totalFrames = 0;
+	this->runStartFrame = 0;
+	this->runPreRollFrames = 0;
+	this->savedReplayTimes.Purge();
+	this->ghost.Clear();
+	this->ghostKeyValid = false;
+	this->ghostLoadSerial = 0;
+	this->hasGhostDelta = false;
+	this->StopPlayback();
+	this->isReplayBot = false;
+	this->idleSince = 0.0;
+	this->capture.End();
+}
+
+bool KZReplayService::ShouldRecord()
+{
+	if (!KZReplayService::recordingEnabled || !this->player->IsAlive() || this->player->IsFakeClient())
+	{
+		return false;
+	}
+	// Paused time is not part of the run time, so keep frames in sync with the timer.
+	return !this->player->timerService->GetPaused() && this->player->GetMoveServices();
+}
+
+void KZReplayService::CaptureFrame(Frame &frame)
+{
+	this->player->GetOrigin(&frame.origin);
+	this->player->GetAngles(&frame.angles);
+	this->player->GetVelocity(&frame.velocity);
+	frame.buttons = this->player->GetMoveServices()->m_nButtons()->m_pButtonStates[0];
+	frame.moveType = this->player->GetMoveType();
+	frame.flags = (u8)this->player->GetPlayerPawn()->m_fFlags();
+}
+
+void KZReplayService::RecordFrame()
+{
+	if (!this->frames)
+	{
+		this->frames = new Frame[KZReplayService::ringCapacity];
+	}
+	this->CaptureFrame(this->frames[this->totalFrames % KZReplayService::ringCapacity]);
+	this->totalFrames++;
+}
+
+void KZReplayService::OnPhysicsSimulatePost()
+{
+	KZ_PROFILE_PLAYER(__func__, this->player->GetPlayerSlot().Get());
+	if (this->player->IsFakeClient())
+	{
+		this->PlaybackFrame();
+	}
+	else if (this->ShouldRecord())
+	{
+		this->RecordFrame();
+		this->UpdateGhostDelta();
+	}
+	else
+	{
+		this->hasGhostDelta = false;
+	}
+}
+
+void KZReplayService::BeginCapture()
+{
+	u64 steamID64 = this->player->GetSteamId64();
+	if (steamID64 == 0)
+	{
+		return;
+	}
+	char map[KZ_REPLAY_MAX_NAME_LENGTH];
+	SanitizePathComponent(g_pKZUtils->GetCurrentMapName().Get(), map, sizeof(map));
+	char path[MAX_PATH];
+	g_SMAPI->PathFormat(path, sizeof(path), "%s/%s/%s/%llu_%lld.kzuc", g_SMAPI->GetBaseDir(), KZ_CAPTURE_DIRECTORY, map, steamID64,
+						(long long)time(nullptr));
+
+	CaptureHeader header;
+	header.steamID64 = steamID64;
+	V_strncpy(header.playerName, this->player->GetName(), sizeof(header.playerName));
+	V_strncpy(header.mapName, g_pKZUtils->GetCurrentMapName().Get(), sizeof(header.mapName));
+	this->capture.Begin(header, path);
+}
+
+void KZReplayService::OnSetupMove(PlayerCommand *pc)
+{
+	if (!KZReplayService::captureEnabled || this->player->IsFakeClient())
+	{
+		return;
+	}
+	if (!this->capture.IsCapturing())
+	{
+		this->BeginCapture();
+	}
+	this->capture.AddUsercmd(pc);
+}
+
+void KZReplayService::OnProcessMovement()
+{
+	this->capture.AddMoveData(CAPTURE_MOVEDATA_PRE, *this->player->currentMoveData);
+}
+
+void KZReplayService::OnProcessMovementPost()
+{
+	this->capture.AddMoveData(CAPTURE_MOVEDATA_POST, *this->player->currentMoveData);
+}
+
+i32 KZReplayService::FindSavedReplayTime(const char *path)
+{
+	FOR_EACH_VEC(this->savedReplayTimes, i)
+	{
+		if (!V_strcmp(this->savedReplayTimes[i].path.Get(), path))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+bool KZReplayService::GetSavedReplayTime(const char *path, f64 &time)
+{
+	i32 index = this->FindSavedReplayTime(path);
+	if (index == -1)
+	{
+		return false;
+	}
+	time = this->savedReplayTimes[index].time;
+	return true;
+}
+
+void KZReplayService::SetSavedReplayTime(const char *path, f64 time)
+{
+	i32 index = this->FindSavedReplayTime(path);
+	if (index != -1)
+	{
+		this->savedReplayTimes[index].time = time;
+		return;
+	}
+	this->savedReplayTimes.AddToTail({path, time});
+}
+
+bool KZReplayService::UpdateGhost(PBDataKey key)
+{
+	if (this->ghostKeyValid && this->ghostKey == key)
+	{
+		return this->ghost.IsLoaded();
+	}
+	this->ghost.Clear();
+	this->ghostLoadSerial = 0;
+	// Try again on the next start if the steam ID is not known yet.
+	const KZCourse *course = this->player->timerService->GetCourse();
+	if (!course || this->player->GetSteamId64() == 0)
+	{
+		return false;
+	}
+	this->ghostKey = key;
+	this->ghostKeyValid = true;
+
+	// The replay is read on the writer thread, the ghost is swapped in by CheckGhostLoads once it is done.
+	GhostLoadJob *job = new GhostLoadJob();
+	char path[MAX_PATH];
+	char proPath[MAX_PATH];
+	const char *modeName = this->player->modeService->GetModeShortName();
+	KZReplayService::GetReplayPath(path, sizeof(path), this->player->GetSteamId64(), course->name, modeName, false);
+	KZReplayService::GetReplayPath(proPath, sizeof(proPath), this->player->GetSteamId64(), course->name, modeName, true);
+	job->path = path;
+	job->proPath = proPath;
+	job->slot = this->player->GetPlayerSlot().Get();
+	// Never 0, that means no load in flight.
+	if (++lastGhostLoadSerial == 0)
+	{
+		lastGhostLoadSerial++;
+	}
+	job->serial = lastGhostLoadSerial;
+	this->ghostLoadSerial = job->serial;
+	if (!QueueGhostLoad(job))
+	{
+		this->ghostKeyValid = false;
+		this->ghostLoadSerial = 0;
+	}
+	return false;
+}
+
+void KZReplayService::CheckGhostLoads()
+{
+	while (GhostLoadJob *job = PopLoadedGhost())
+	{
+		KZPlayer *player = g_pKZPlayerManager->ToPlayer(job->slot);
+		KZReplayService *service = player ? player->replayService : nullptr;
+		if (service && service->ghostLoadSerial == job->serial)
+		{
+			service->ghostLoadSerial = 0;
+			// Nothing newer was saved in the meantime, otherwise the serial would have changed.
+			if (service->FindSavedReplayTime(job->path.Get()) == -1)
+			{
+				service->savedReplayTimes.AddToTail({job->path, job->time});
+			}
+			if (service->FindSavedReplayTime(job->proPath.Get()) == -1)
+			{
+				service->savedReplayTimes.AddToTail({job->proPath, job->proTime});
+			}
+			if (job->success)
+			{
+				service->ghost.Swap(job->ghost);
+				service->ghost.ResetCursor();
+			}
+		}
+		delete job;
+	}
+}
+
+void KZReplayService::CheckFailedWrites()
+{
+	FailedWrite failed;
+	while (PopFailedWrite(failed))
+	{
+		KZPlayer *player = g_pKZPlayerManager->ToPlayer(failed.slot);
+		if (!player || player->GetSteamId64() != failed.steamID64)
+		{
+			continue;
+		}
+		KZReplayService *service = player->replayService;
+		i32 index = service->FindSavedReplayTime(failed.path.Get());
+		// Something else may have been saved at the path since.
+		if (index == -1 || service->savedReplayTimes[index].time != failed.time)
+		{
+			continue;
+		}
+		// Forget the time, the next ghost load reads it from whatever is on the disk.
+		service->savedReplayTimes.Remove(index);
+		// The ghost may have been built from the run that failed to be saved.
+		service->ghost.Clear();
+		service->ghostKeyValid = false;
+		service->ghostLoadSerial = 0;
+	}
+}
+
+void KZReplayService::UpdateGhostDelta()
+{
+	// Replays are only saved for runs without styles, there is nothing to compare styled runs with.
+	this->hasGhostDelta = this->player->timerService->GetTimerRunning() && this->player->styleServices.Count() == 0 && this->ghost.IsLoaded();
+	if (this->hasGhostDelta)
+	{
+		Vector origin;
+		this->player->GetOrigin(&origin);
+		this->ghostDelta = this->player->timerService->GetTime() - this->ghost.GetTimeAt(origin);
+	}
+}
+
+void KZReplayService::OnTimerStart()
+{
+	// The frame of the current tick has not been recorded yet, so the run starts at the next frame.
+	this->runStartFrame = this->totalFrames;
+	u64 preRoll = (u64)(KZ_REPLAY_PREROLL_TIME * ENGINE_FIXED_TICK_RATE);
+	this->runPreRollFrames = (u32)MIN(preRoll, this->totalFrames);
+
+	const KZCourse *course = this->player->timerService->GetCourse();
+	if (course && this->UpdateGhost(ToPBDataKey(KZ::mode::GetModeInfo(this->player->modeService).id, course->guid)))
+	{
+		this->ghost.ResetCursor();
+	}
+}
+
+void KZReplayService::OnTimerEnd(f64 time, u32 teleportsUsed)
+{
+	if (!this->frames || !this->ShouldRecord())
+	{
+		return;
+	}
+	// No leaderboard to compare against for styled runs.
+	if (this->player->styleServices.Count() > 0 || this->player->GetSteamId64() == 0)
+	{
+		return;
+	}
+	const KZCourse *course = this->player->timerService->GetCourse();
+	if (!course)
+	{
+		return;
+	}
+
+	// The tick the run ended on is only added to the job by CreateWriteJob, OnPhysicsSimulatePost records it into the ring.
+	u64 frameCount = this->totalFrames - this->runStartFrame + this->runPreRollFrames;
+	if (frameCount > KZReplayService::ringCapacity)
+	{
+		META_CONPRINTF("[KZ::Replays] Run of %s on %s is longer than the replay buffer, not saving replay.\n", this->player->GetName(), course->name);
+		return;
+	}
+
+	// Only keep the replays of personal bests. If a saved time isn't known yet, the writer compares with the file.
+	char path[MAX_PATH];
+	char proPath[MAX_PATH];
+	const char *modeName = this->player->modeService->GetModeShortName();
+	KZReplayService::GetReplayPath(path, sizeof(path), this->player->GetSteamId64(), course->name, modeName, false);
+	KZReplayService::GetReplayPath(proPath, sizeof(proPath), this->player->GetSteamId64(), course->name, modeName, true);
+	f64 savedTime = 0.0;
+	bool knownTime = this->GetSavedReplayTime(path, savedTime);
+	bool newPB = savedTime <= 0.0 || time < savedTime;
+	bool newProPB = false;
+	bool knownProTime = true;
+	if (teleportsUsed == 0)
+	{
+		f64 savedProTime = 0.0;
+		knownProTime = this->GetSavedReplayTime(proPath, savedProTime);
+		newProPB = savedProTime <= 0.0 || time < savedProTime;
+	}
+	if (!newPB && !newProPB)
+	{
+		return;
+	}
+
+	WriteJob *job = this->CreateWriteJob(time, teleportsUsed);
+	if (newPB)
+	{
+		job->paths.AddToTail(path);
+	}
+	if (newProPB)
+	{
+		job->paths.AddToTail(proPath);
+	}
+	// The new personal best becomes the ghost right away, no need to wait for the file to be written.
+	PBDataKey key = ToPBDataKey(KZ::mode::GetModeInfo(this->player->modeService).id, course->guid);
+	if (newPB && !knownTime)
+	{
+		// Whether this run replaces the saved replay is only known once the writer is done, load the ghost again on the next start.
+		this->ghost.Clear();
+		this->ghostKeyValid = false;
+		this->ghostLoadSerial = 0;
+	}
+	else if (newPB)
+	{
+		this->ghost.Begin(job->header.preRollFrames, job->header.tickInterval);
+		FOR_EACH_VEC(job->frames, i)
+		{
+			this->ghost.AddFrame(job->frames[i]);
+		}
+		this->ghostKey = key;
+		this->ghostKeyValid = true;
+		// A load of the replay this one replaces may still be in flight.
+		this->ghostLoadSerial = 0;
+	}
+	if (!QueueWrite(job))
+	{
+		META_CONPRINTF("[KZ::Replays] Replay writer is busy, dropping replay of %s on %s.\n", this->player->GetName(), course->name);
+		// The ghost has to match the saved replay, load it again on the next start.
+		if (newPB)
+		{
+			this->ghost.Clear();
+			this->ghostKeyValid = false;
+		}
+		return;
+	}
+	if (newPB && knownTime)
+	{
+		this->SetSavedReplayTime(path, time);
+	}
+	if (newProPB && knownProTime)
+	{
+		this->SetSavedReplayTime(proPath, time);
+	}
+}
+
+WriteJob *KZReplayService::CreateWriteJob(f64 time, u32 teleportsUsed)
+{
+	const KZCourse *course = this->player->timerService->GetCourse();
+
+	WriteJob *job = new WriteJob();
+	job->slot = this->player->GetPlayerSlot().Get();
+	Header &header = job->header;
+	header.preRollFrames = this->runPreRollFrames;
+	header.steamID64 = this->player->GetSteamId64();
+	header.time = time;
+	header.teleportsUsed = teleportsUsed;
+	V_strncpy(header.playerName, this->player->GetName(), sizeof(header.playerName));
+	V_strncpy(header.mapName, g_pKZUtils->GetCurrentMapName().Get(), sizeof(header.mapName));
+	V_strncpy(header.courseName, course ? course->name : "", sizeof(header.courseName));
+	V_strncpy(header.modeName, this->player->modeService->GetModeName(), sizeof(header.modeName));
+
+	// The run may wrap around the end of the ring, copy it out in at most two pieces.
+	// Encoding happens on the writer thread, the ring keeps being written to in the meantime.
+	u64 firstFrame = this->runStartFrame - this->runPreRollFrames;
+	u32 frameCount = (u32)(this->totalFrames - firstFrame);
+	u32 start = (u32)(firstFrame % KZReplayService::ringCapacity);
+	u32 firstPart = MIN(frameCount, KZReplayService::ringCapacity - start);
+	job->frames.SetCount(frameCount + 1);
+	V_memcpy(job->frames.Base(), this->frames + start, firstPart * sizeof(Frame));
+	V_memcpy(job->frames.Base() + firstPart, this->frames, (frameCount - firstPart) * sizeof(Frame));
+	// The tick the run ended on isn't in the ring yet.
+	this->CaptureFrame(job->frames.Tail());
+	return job;
+}
+
+bool KZReplayService::StartPlayback(const char *path)
+{
+	this->StopPlayback();
+	size_t size = 0;
+	void *data = Plat_MapFile(path, &size);
+	if (!data)
+	{
+		return false;
+	}
+	if (!this->decoder.Init((const u8 *)data, size))
+	{
+		META_CONPRINTF("[KZ::Replays] %s is not a valid replay.\n", path);
+		Plat_UnmapFile(data, size);
+		return false;
+	}
+	this->playbackData = data;
+	this->playbackSize = size;
+	this->playbackLoops = 0;
+	this->isReplayBot = true;
+	this->idleSince = 0.0;
+	return true;
+}
+
+void KZReplayService::StopPlayback()
+{
+	if (!this->playbackData)
+	{
+		return;
+	}
+	Plat_UnmapFile(this->playbackData, this->playbackSize);
+	this->playbackData = nullptr;
+	this->playbackSize = 0;
+	this->idleSince = Plat_FloatTime();
+	if (this->player->IsAlive() && this->player->GetMoveType() == MOVETYPE_NOCLIP)
+	{
+		this->player->SetMoveType(MOVETYPE_WALK);
+	}
+}
+
+void KZReplayService::PlaybackFrame()
+{
+	if (this->player->IsCSTV())
+	{
+		return;
+	}
+	// A bot joining right after kz_replay added one is ours, even if another bot got to its replay first.
+	if (!this->isReplayBot && Plat_FloatTime() - lastBotAddTime < KZ_REPLAY_BOT_JOIN_TIME)
+	{
+		this->isReplayBot = true;
+		this->idleSince = Plat_FloatTime();
+	}
+	if (!this->player->IsAlive())
+	{
+		return;
+	}
+	if (!this->IsPlaying())
+	{
+		if (pendingPlaybacks.Count() == 0)
+		{
+			return;
+		}
+		CUtlString path = pendingPlaybacks[0];
+		pendingPlaybacks.Remove(0);
+		if (!this->StartPlayback(path.Get()))
+		{
+			return;
+		}
+	}
+
+	Frame frame;
+	if (!this->decoder.NextFrame(frame))
+	{
+		// Loop the replay a few times, but give the bot to the next replay as soon as one is waiting.
+		this->playbackLoops++;
+		if (this->playbackLoops >= KZ_REPLAY_PLAYBACK_LOOPS || pendingPlaybacks.Count() > 0 || !this->decoder.Seek(0)
+			|| !this->decoder.NextFrame(frame))
+		{
+			this->StopPlayback();
+			return;
+		}
+	}
+	// The bot only follows the recorded path, it should not collide or fall in between frames.
+	if (this->player->GetMoveType() != MOVETYPE_NOCLIP)
+	{
+		this->player->SetMoveType(MOVETYPE_NOCLIP);
+	}
+	this->player->Teleport(&frame.origin, &frame.angles, &frame.velocity);
+}
+
+bool KZReplayService::PlayOnBot(const char *path)
+{
+	if (pendingPlaybacks.Count() >= KZ_REPLAY_MAX_PENDING_PLAYBACKS)
+	{
+		return false;
+	}
+	pendingPlaybacks.AddToTail(path);
+
+	// Idle bots pick up pending replays on their next tick, busy ones once their current loop ends.
+	u32 botCount = 0;
+	for (i32 i = 0; i <= g_pKZUtils->GetGlobals()->maxClients; i++)
+	{
+		KZPlayer *bot = g_pKZPlayerManager->ToPlayer(i);
+		if (!bot || !bot->IsConnected() || !bot->IsFakeClient() || bot->IsCSTV())
+		{
+			continue;
+		}
+		if (bot->IsAlive() && !bot->replayService->IsPlaying())
+		{
+			return true;
+		}
+		botCount++;
+	}
+	// Only add a new bot if there is room for it and the last one added had time to join.
+	f64 now = Plat_FloatTime();
+	if (botCount < KZReplayService::maxBots && now - lastBotAddTime >= KZ_REPLAY_BOT_JOIN_TIME)
+	{
+		lastBotAddTime = now;
+		interfaces::pEngine->ServerCommand("bot_add_ct");
+	}
+	return true;
+}
+
+void KZReplayService::CheckIdleBots()
+{
+	f64 now = Plat_FloatTime();
+	for (i32 i = 0; i <= g_pKZUtils->GetGlobals()->maxClients; i++)
+	{
+		KZPlayer *bot = g_pKZPlayerManager->ToPlayer(i);
+		if (!bot || !bot->IsConnected() || !bot->IsFakeClient() || bot->IsCSTV())
+		{
+			continue;
+		}
+		KZReplayService *service = bot->replayService;
+		if (!service->isReplayBot || service->IsPlaying() || pendingPlaybacks.Count() > 0)
+		{
+			continue;
+		}
+		if (now - service->idleSince >= KZ_REPLAY_BOT_IDLE_TIME)
+		{
+			bot->Kick("Replay bot idle");
+		}
+	}
+}
+
+static_function SCMD_CALLBACK(Command_KzReplay)
+{
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
+	const KZCourse *course = player->timerService->GetCourse();
+	if (!course)
+	{
+		player->languageService->PrintChat(true, false, "Replay - No Course");
+		return MRES_SUPERCEDE;
+	}
+
+	// kz_replay [steamid64] [pro]
+	u64 steamID64 = player->GetSteamId64();
+	bool pro = false;
+	for (i32 i = 1; i < args->ArgC(); i++)
+	{
+		if (!V_stricmp(args->Arg(i), "pro"))
+		{
+			pro = true;
+			continue;
+		}
+		char *end;
+		u64 target = utils::IsNumeric(args->Arg(i)) ? strtoull(args->Arg(i), &end, 10) : 0;
+		if (target == 0 || *end != '\0' || target == ULLONG_MAX)
+		{
+			player->languageService->PrintChat(true, false, "Replay - Invalid SteamID", args->Arg(i));
+			return MRES_SUPERCEDE;
+		}
+		if (target != player->GetSteamId64() && !replayAnyPlayer)
+		{
+			player->languageService->PrintChat(true, false, "Replay - Own Only");
+			return MRES_SUPERCEDE;
+		}
+		steamID64 = target;
+	}
+
+	char path[MAX_PATH];
+	KZReplayService::GetReplayPath(path, sizeof(path), steamID64, course->name, player->modeService->GetModeShortName(), pro);
+	if (!g_pFullFileSystem->FileExists(path))
+	{
+		player->languageService->PrintChat(true, false, "Replay - Not Found", course->name);
+		return MRES_SUPERCEDE;
+	}
+	if (!KZReplayService::PlayOnBot(path))
+	{
+		player->languageService->PrintChat(true, false, "Replay - Too Many Pending");
+		return MRES_SUPERCEDE;
+	}
+	player->languageService->PrintChat(true, false, "Replay - Starting", course->name);
+	return MRES_SUPERCEDE;
+}
+
+void KZReplayService::RegisterCommands()
+{
+	scmd::RegisterCmd("kz_replay", Command_KzReplay);
+}
@@ -1,7 +1,140 @@
 #pragma once
 #include "../kz.h"
+#include "kz/course/kz_course.h"
+#include "ghost.h"
+#include "replay_format.h"
+#include "replay_writer.h"
+#include "usercmd_capture.h"
+#include "utils/plat.h"
+
+#define KZ_REPLAY_DIRECTORY           "kzreplays"
+#define KZ_REPLAY_DEFAULT_MAX_MINUTES 30
+// How long before the timer start should be kept in the replay.
+#define KZ_REPLAY_PREROLL_TIME 2.0f
+// Maximum number of replays waiting for a bot to join.
+#define KZ_REPLAY_MAX_PENDING_PLAYBACKS 8
+#define KZ_REPLAY_DEFAULT_MAX_BOTS      2
+// A replay stops after playing this many times, or right after its current loop if other replays are waiting for a bot.
+#define KZ_REPLAY_PLAYBACK_LOOPS 3
+// Bots that haven't had a replay to play for this long are kicked.
+#define KZ_REPLAY_BOT_IDLE_TIME 60.0
+// Don't add another bot while the last one added may still be joining.
+#define KZ_REPLAY_BOT_JOIN_TIME 5.0
 
 class KZReplayService : public KZBaseService
 {
+public:
 	using KZBaseService::KZBaseService;
+
+	~KZReplayService()
+	{
+		delete[] this->frames;
+		if (this->playbackData)
+		{
+			Plat_UnmapFile(this->playbackData, this->playbackSize);
+		}
+	}
+
+	static void Init();
+	static void Cleanup();
+	static void RegisterCommands();
+	// Swap in the ghosts the writer thread finished loading. Called every frame.
+	static void CheckGhostLoads();
+	// Take back the saved times of the replays the writer thread failed to write. Called every frame.
+	static void CheckFailedWrites();
+
+	virtual void Reset() override;
+
+	void OnPhysicsSimulatePost();
+	void OnSetupMove(PlayerCommand *pc);
+	void OnProcessMovement();
+	void OnProcessMovementPost();
+	void OnTimerStart();
+	void OnTimerEnd(f64 time, u32 teleportsUsed);
+
+	// Difference between the current time and the time the personal best replay needed to get to the same place.
+	bool GetGhostDelta(f64 &delta)
+	{
+		delta = this->ghostDelta;
+		return this->hasGhostDelta;
+	}
+
+	static void GetReplayPath(char *buffer, u32 size, u64 steamID64, const char *courseName, const char *modeShortName, bool pro);
+
+	// Playback, only used by bots.
+	bool IsPlaying()
+	{
+		return this->playbackData != nullptr;
+	}
+
+	bool StartPlayback(const char *path);
+	void StopPlayback();
+	// Queue a replay for the next free bot, adding a new bot if there is none and the bot limit isn't reached.
+	static bool PlayOnBot(const char *path);
+	// Kick bots that have been idle for too long. Called every frame.
+	static void CheckIdleBots();
+
+private:
+	static bool recordingEnabled;
+	static bool captureEnabled;
+	static u32 maxBots;
+	// Number of frames each player's ring buffer can hold.
+	static u32 ringCapacity;
+
+	// Allocated once on the first recorded frame, then reused for the lifetime of the player slot.
+	KZ::replays::Frame *frames {};
+	// Total number of frames recorded since the last reset, the ring position is totalFrames % ringCapacity.
+	u64 totalFrames {};
+
+	u64 runStartFrame {};
+	u32 runPreRollFrames {};
+
+	// Time of the replay saved at each replay path, 0 if there is none.
+	// Seeded by the ghost load on the writer thread, then updated with every replay queued for writing.
+	// This is what decides whether a run replaces the saved replay, the timer's personal best cache loads too late for that.
+	// Paths that aren't known yet are left to the writer, it never writes over a faster replay.
+	struct SavedReplayTime
+	{
+		CUtlString path;
+		f64 time;
+	};
+
+	CUtlVector<SavedReplayTime> savedReplayTimes;
+
+	i32 FindSavedReplayTime(const char *path);
+	// Returns false if the time of the path isn't known yet.
+	bool GetSavedReplayTime(const char *path, f64 &time);
+	void SetSavedReplayTime(const char *path, f64 time);
+
+	KZ::replays::Ghost ghost;
+	PBDataKey ghostKey {};
+	bool ghostKeyValid {};
+	// Serial of the ghost load in flight, 0 if there is none. Loads that come back with a different serial are outdated.
+	u32 ghostLoadSerial {};
+	bool hasGhostDelta {};
+	f64 ghostDelta {};
+
+	bool UpdateGhost(PBDataKey key);
+	void UpdateGhostDelta();
+
+	// Replay file mapped into memory, frames are decoded straight out of it.
+	void *playbackData {};
+	size_t playbackSize {};
+	KZ::replays::ReplayDecoder decoder;
+	u32 playbackLoops {};
+	// Set once the bot played a replay, other bots are left alone.
+	bool isReplayBot {};
+	// Plat_FloatTime at which the bot ran out of replays to play, 0 while playing.
+	f64 idleSince {};
+
+	void PlaybackFrame();
+
+	// Usercmd capture, only active if enabled in the server config.
+	KZ::replays::CaptureWriter capture;
+	void BeginCapture();
+
+	bool ShouldRecord();
+	void CaptureFrame(KZ::replays::Frame &frame);
+	void RecordFrame();
+	KZ::replays::WriteJob *CreateWriteJob(f64 time, u32 teleportsUsed);
 };
@@ -0,0 +1,381 @@
+#include "replay_format.h"
+#include "utils/compression.h"
+#include "utils/varint.h"
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::replays;
+
+enum FrameFieldMask : u8
+{
+	FIELD_ORIGIN = 1 << 0,
+	FIELD_ANGLES = 1 << 1,
+	FIELD_VELOCITY = 1 << 2,
+	FIELD_BUTTONS = 1 << 3,
+	FIELD_MOVETYPE = 1 << 4,
+	FIELD_FLAGS = 1 << 5,
+	FIELD_ALL = FIELD_ORIGIN | FIELD_ANGLES | FIELD_VELOCITY | FIELD_BUTTONS | FIELD_MOVETYPE | FIELD_FLAGS,
+	FIELD_KEYFRAME = 1 << 7
+};
+
+static_function i32 QuantizeFloat(f32 value, f32 scale)
+{
+	return RoundFloatToInt(value * scale);
+}
+
+static_function u16 QuantizeAngle(f32 angle)
+{
+	return (u16)(RoundFloatToInt(angle * KZ_REPLAY_ANGLE_SCALE) & 0xFFFF);
+}
+
+static_function f32 DequantizeAngle(u16 angle)
+{
+	f32 result = angle / KZ_REPLAY_ANGLE_SCALE;
+	return result >= 180.0f ? result - 360.0f : result;
+}
+
+void KZ::replays::QuantizeFrame(const Frame &frame, QuantizedFrame &out)
+{
+	for (u32 i = 0; i < 3; i++)
+	{
+		out.origin[i] = QuantizeFloat(frame.origin[i], KZ_REPLAY_ORIGIN_SCALE);
+		out.angles[i] = QuantizeAngle(frame.angles[i]);
+		out.velocity[i] = QuantizeFloat(frame.velocity[i], KZ_REPLAY_VELOCITY_SCALE);
+	}
+	out.buttons = frame.buttons;
+	out.moveType = frame.moveType;
+	out.flags = frame.flags;
+}
+
+void KZ::replays::DequantizeFrame(const QuantizedFrame &frame, Frame &out)
+{
+	for (u32 i = 0; i < 3; i++)
+	{
+		out.origin[i] = frame.origin[i] / KZ_REPLAY_ORIGIN_SCALE;
+		out.angles[i] = DequantizeAngle(frame.angles[i]);
+		out.velocity[i] = frame.velocity[i] / KZ_REPLAY_VELOCITY_SCALE;
+	}
+	out.buttons = frame.buttons;
+	out.moveType = frame.moveType;
+	out.flags = frame.flags;
+}
+
+void ReplayEncoder::Begin(const Header &header)
+{
+	this->header = header;
+	this->header.magic = KZ_REPLAY_MAGIC;
+	this->header.version = KZ_REPLAY_VERSION;
+	this->header.keyframeInterval = KZ_REPLAY_KEYFRAME_INTERVAL;
+	this->header.frameCount = 0;
+	this->stream.Purge();
+	this->keyframeOffsets.RemoveAll();
+	this->previous = {};
+}
+
+void ReplayEncoder::AddFrame(const Frame &frame)
+{
+	QuantizedFrame current;
+	QuantizeFrame(frame, current);
+
+	bool keyframe = this->header.frameCount % KZ_REPLAY_KEYFRAME_INTERVAL == 0;
+	u8 mask = 0;
+	if (keyframe)
+	{
+		mask = FIELD_ALL | FIELD_KEYFRAME;
+		this->keyframeOffsets.AddToTail(this->stream.TellPut());
+		// Keyframes are deltas against zero so they can be decoded without any previous state.
+		this->previous = {};
+	}
+	else
+	{
+		for (u32 i = 0; i < 3; i++)
+		{
+			mask |= current.origin[i] != this->previous.origin[i] ? FIELD_ORIGIN : 0;
+			mask |= current.angles[i] != this->previous.angles[i] ? FIELD_ANGLES : 0;
+			mask |= current.velocity[i] != this->previous.velocity[i] ? FIELD_VELOCITY : 0;
+		}
+		mask |= current.buttons != this->previous.buttons ? FIELD_BUTTONS : 0;
+		mask |= current.moveType != this->previous.moveType ? FIELD_MOVETYPE : 0;
+		mask |= current.flags != this->previous.flags ? FIELD_FLAGS : 0;
+	}
+
+	this->stream.PutUnsignedChar(mask);
+	if (mask & FIELD_ORIGIN)
+	{
+		for (u32 i = 0; i < 3; i++)
+		{
+			varint::Put(this->stream, varint::ZigZagEncode(current.origin[i] - this->previous.origin[i]));
+		}
+	}
+	if (mask & FIELD_ANGLES)
+	{
+		for (u32 i = 0; i < 3; i++)
+		{
+			// Wrapping around is intended here, the shortest way around the circle is always used.
+			varint::Put(this->stream, varint::ZigZagEncode((i16)(u16)(current.angles[i] - this->previous.angles[i])));
+		}
+	}
+	if (mask & FIELD_VELOCITY)
+	{
+		for (u32 i = 0; i < 3; i++)
+		{
+			varint::Put(this->stream, varint::ZigZagEncode(current.velocity[i] - this->previous.velocity[i]));
+		}
+	}
+	if (mask & FIELD_BUTTONS)
+	{
+		varint::Put(this->stream, current.buttons ^ this->previous.buttons);
+	}
+	if (mask & FIELD_MOVETYPE)
+	{
+		this->stream.PutUnsignedChar(current.moveType);
+	}
+	if (mask & FIELD_FLAGS)
+	{
+		this->stream.PutUnsignedChar(current.flags);
+	}
+
+	this->previous = current;
+	this->header.frameCount++;
+}
+
+void ReplayEncoder::Finish(CUtlBuffer &out, bool compress)
+{
+	this->header.flags = compress ? KZ_REPLAY_FLAG_COMPRESSED : 0;
+	this->header.keyframeCount = this->keyframeOffsets.Count();
+
+	out.Purge();
+	if (!compress)
+	{
+		this->header.keyframeTableOffset = sizeof(Header) + this->stream.TellPut();
+		// Keyframe offsets are relative to the stream, make them absolute.
+		FOR_EACH_VEC(this->keyframeOffsets, i)
+		{
+			this->keyframeOffsets[i] += sizeof(Header);
+		}
+		out.EnsureCapacity(this->header.keyframeTableOffset + this->keyframeOffsets.Count() * sizeof(u32));
+		out.Put(&this->header, sizeof(Header));
+		out.Put(this->stream.Base(), this->stream.TellPut());
+		out.Put(this->keyframeOffsets.Base(), this->keyframeOffsets.Count() * sizeof(u32));
+		return;
+	}
+
+	// Header gets written again once the keyframe table offset is known.
+	out.Put(&this->header, sizeof(Header));
+	const u8 *stream = (const u8 *)this->stream.Base();
+	u8 compressed[compression::CompressBound(KZ_REPLAY_MAX_BLOCK_SIZE)];
+	FOR_EACH_VEC(this->keyframeOffsets, i)
+	{
+		u32 blockStart = this->keyframeOffsets[i];
+		u32 blockEnd = i + 1 < this->keyframeOffsets.Count() ? this->keyframeOffsets[i + 1] : this->stream.TellPut();
+		u16 rawSize = (u16)(blockEnd - blockStart);
+		u16 storedSize = (u16)compression::Compress(stream + blockStart, rawSize, compressed, sizeof(compressed));
+
+		this->keyframeOffsets[i] = out.TellPut();
+		bool stored = storedSize == 0 || storedSize >= rawSize;
+		if (stored)
+		{
+			storedSize = rawSize;
+		}
+		out.Put(&rawSize, sizeof(rawSize));
+		out.Put(&storedSize, sizeof(storedSize));
+		out.Put(stored ? stream + blockStart : compressed, storedSize);
+	}
+	this->header.keyframeTableOffset = out.TellPut();
+	out.Put(this->keyframeOffsets.Base(), this->keyframeOffsets.Count() * sizeof(u32));
+	V_memcpy(out.Base(), &this->header, sizeof(Header));
+}
+
+bool ReplayDecoder::Init(const u8 *data, size_t size)
+{
+	this->data = data;
+	this->size = size;
+	this->header = nullptr;
+	this->block = nullptr;
+	if (!data || size < sizeof(Header))
+	{
+		return false;
+	}
+	const Header *header = reinterpret_cast<const Header *>(data);
+	if (header->magic != KZ_REPLAY_MAGIC || header->version != KZ_REPLAY_VERSION || header->keyframeInterval != KZ_REPLAY_KEYFRAME_INTERVAL)
+	{
+		return false;
+	}
+	if (header->keyframeTableOffset < sizeof(Header) || header->keyframeTableOffset + (size_t)header->keyframeCount * sizeof(u32) > size)
+	{
+		return false;
+	}
+	// Every keyframe starts a block of at most keyframeInterval frames, so the keyframe table that was just checked against the
+	// file size also bounds frameCount. Readers size their buffers from it.
+	if (header->frameCount > (u64)header->keyframeCount * KZ_REPLAY_KEYFRAME_INTERVAL)
+	{
+		return false;
+	}
+	this->header = header;
+	this->frameIndex = 0;
+	this->current = {};
+	if (!(header->flags & KZ_REPLAY_FLAG_COMPRESSED))
+	{
+		// The whole stream is one big block.
+		this->block = data + sizeof(Header);
+		this->blockSize = header->keyframeTableOffset - sizeof(Header);
+		this->cursor = 0;
+	}
+	return true;
+}
+
+bool ReplayDecoder::LoadBlock(u32 keyframe)
+{
+	if (keyframe >= this->header->keyframeCount)
+	{
+		return false;
+	}
+	u32 offset;
+	V_memcpy(&offset, this->data + this->header->keyframeTableOffset + keyframe * sizeof(u32), sizeof(u32));
+	if (offset < sizeof(Header) || offset >= this->header->keyframeTableOffset)
+	{
+		return false;
+	}
+	if (!(this->header->flags & KZ_REPLAY_FLAG_COMPRESSED))
+	{
+		this->cursor = offset - sizeof(Header);
+		return true;
+	}
+
+	u16 rawSize, storedSize;
+	if (offset + 2 * sizeof(u16) > this->header->keyframeTableOffset)
+	{
+		return false;
+	}
+	V_memcpy(&rawSize, this->data + offset, sizeof(u16));
+	V_memcpy(&storedSize, this->data + offset + sizeof(u16), sizeof(u16));
+	offset += 2 * sizeof(u16);
+	if (offset + storedSize > this->header->keyframeTableOffset || rawSize > sizeof(this->blockBuffer))
+	{
+		return false;
+	}
+	if (storedSize == rawSize)
+	{
+		this->block = this->data + offset;
+	}
+	else
+	{
+		if (!compression::Decompress(this->data + offset, storedSize, this->blockBuffer, rawSize))
+		{
+			return false;
+		}
+		this->block = this->blockBuffer;
+	}
+	this->blockSize = rawSize;
+	this->cursor = 0;
+	return true;
+}
+
+bool ReplayDecoder::NextFrame(Frame &out)
+{
+	if (!this->header || this->frameIndex >= this->header->frameCount)
+	{
+		return false;
+	}
+	if ((this->header->flags & KZ_REPLAY_FLAG_COMPRESSED) && this->frameIndex % KZ_REPLAY_KEYFRAME_INTERVAL == 0)
+	{
+		if (!this->LoadBlock(this->frameIndex / KZ_REPLAY_KEYFRAME_INTERVAL))
+		{
+			return false;
+		}
+	}
+
+	const u8 *data = this->block;
+	size_t end = this->blockSize;
+	size_t cursor = this->cursor;
+	if (cursor >= end)
+	{
+		return false;
+	}
+	u8 mask = data[cursor++];
+	if (mask & FIELD_KEYFRAME)
+	{
+		this->current = {};
+	}
+
+	u64 value;
+	if (mask & FIELD_ORIGIN)
+	{
+		for (u32 i = 0; i < 3; i++)
+		{
+			if (!varint::Get(data, end, cursor, value))
+			{
+				return false;
+			}
+			this->current.origin[i] += varint::ZigZagDecode((u32)value);
+		}
+	}
+	if (mask & FIELD_ANGLES)
+	{
+		for (u32 i = 0; i < 3; i++)
+		{
+			if (!varint::Get(data, end, cursor, value))
+			{
+				return false;
+			}
+			this->current.angles[i] += (u16)varint::ZigZagDecode((u32)value);
+		}
+	}
+	if (mask & FIELD_VELOCITY)
+	{
+		for (u32 i = 0; i < 3; i++)
+		{
+			if (!varint::Get(data, end, cursor, value))
+			{
+				return false;
+			}
+			this->current.velocity[i] += varint::ZigZagDecode((u32)value);
+		}
+	}
+	if (mask & FIELD_BUTTONS)
+	{
+		if (!varint::Get(data, end, cursor, value))
+		{
+			return false;
+		}
+		this->current.buttons ^= value;
+	}
+	if (mask & FIELD_MOVETYPE)
+	{
+		if (cursor >= end)
+		{
+			return false;
+		}
+		this->current.moveType = data[cursor++];
+	}
+	if (mask & FIELD_FLAGS)
+	{
+		if (cursor >= end)
+		{
+			return false;
+		}
+		this->current.flags = data[cursor++];
+	}
+
+	this->cursor = (u32)cursor;
+	DequantizeFrame(this->current, out);
+	this->frameIndex++;
+	return true;
+}
+
+bool ReplayDecoder::Seek(u32 frame)
+{
+	if (!this->header || this->header->keyframeCount == 0)
+	{
+		return false;
+	}
+	u32 keyframe = MIN(frame / KZ_REPLAY_KEYFRAME_INTERVAL, this->header->keyframeCount - 1);
+	this->frameIndex = keyframe * KZ_REPLAY_KEYFRAME_INTERVAL;
+	this->current = {};
+	// Compressed blocks are loaded by NextFrame once it reaches the keyframe.
+	if (this->header->flags & KZ_REPLAY_FLAG_COMPRESSED)
+	{
+		return true;
+	}
+	return this->LoadBlock(keyframe);
+}
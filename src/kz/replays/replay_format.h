@@ -0,0 +1,138 @@
+// Compact binary replay format.
+//
+// Layout: Header | frame stream | keyframe offset table (u32 per keyframe).
+// Every frame starts with a field mask byte. Keyframes (every KZ_REPLAY_KEYFRAME_INTERVAL frames) store every field
+// as an absolute quantized value, every other frame only stores the fields that changed as a delta of the previous frame.
+// If KZ_REPLAY_FLAG_COMPRESSED is set, the frames between two keyframes form a block that is compressed on its own:
+// u16 raw size | u16 stored size | data. Blocks that don't shrink are stored as is, with both sizes being equal.
+
+#pragma once
+#include "common.h"
+#include "mathlib/vector.h"
+#include "utlbuffer.h"
+
+#define KZ_REPLAY_MAGIC             0x50525A4B // "KZRP"
+#define KZ_REPLAY_VERSION           1
+#define KZ_REPLAY_KEYFRAME_INTERVAL 64
+#define KZ_REPLAY_MAX_NAME_LENGTH   128
+
+#define KZ_REPLAY_FLAG_COMPRESSED (1 << 0)
+
+// Largest possible encoded frame: mask, 3 origin varints, 3 angle varints, 3 velocity varints, buttons varint, move type, flags.
+#define KZ_REPLAY_MAX_FRAME_SIZE (1 + 3 * 5 + 3 * 3 + 3 * 5 + 10 + 1 + 1)
+#define KZ_REPLAY_MAX_BLOCK_SIZE (KZ_REPLAY_MAX_FRAME_SIZE * KZ_REPLAY_KEYFRAME_INTERVAL)
+
+// Quantization steps.
+#define KZ_REPLAY_ORIGIN_SCALE   32.0f // 1/32 unit
+#define KZ_REPLAY_VELOCITY_SCALE 16.0f // 1/16 unit per second
+#define KZ_REPLAY_ANGLE_SCALE    (65536.0f / 360.0f)
+
+namespace KZ
+{
+	namespace replays
+	{
+		struct Frame
+		{
+			u64 buttons {};
+			Vector origin;
+			QAngle angles;
+			Vector velocity;
+			u8 moveType {};
+			u8 flags {};
+		};
+
+		struct Header
+		{
+			u32 magic = KZ_REPLAY_MAGIC;
+			u32 version = KZ_REPLAY_VERSION;
+			f32 tickInterval = ENGINE_FIXED_TICK_INTERVAL;
+			u32 frameCount {};
+			// Number of frames recorded before the timer started.
+			u32 preRollFrames {};
+			u32 keyframeInterval = KZ_REPLAY_KEYFRAME_INTERVAL;
+			u32 keyframeCount {};
+			// Absolute file offset of the keyframe table.
+			u32 keyframeTableOffset {};
+			u64 steamID64 {};
+			f64 time {};
+			u32 teleportsUsed {};
+			u32 flags {};
+			char playerName[KZ_REPLAY_MAX_NAME_LENGTH] {};
+			char mapName[KZ_REPLAY_MAX_NAME_LENGTH] {};
+			char courseName[KZ_REPLAY_MAX_NAME_LENGTH] {};
+			char modeName[KZ_REPLAY_MAX_NAME_LENGTH] {};
+		};
+
+		static_assert(sizeof(Header) == 56 + 4 * KZ_REPLAY_MAX_NAME_LENGTH, "Replay header must not contain padding");
+
+		// Frame values after quantization, this is what actually gets delta encoded.
+		struct QuantizedFrame
+		{
+			i32 origin[3] {};
+			u16 angles[3] {};
+			i32 velocity[3] {};
+			u64 buttons {};
+			u8 moveType {};
+			u8 flags {};
+		};
+
+		void QuantizeFrame(const Frame &frame, QuantizedFrame &out);
+		void DequantizeFrame(const QuantizedFrame &frame, Frame &out);
+
+		class ReplayEncoder
+		{
+		public:
+			void Begin(const Header &header);
+			void AddFrame(const Frame &frame);
+			// Write the whole file (header, frame stream, keyframe table) into out.
+			void Finish(CUtlBuffer &out, bool compress = false);
+
+		private:
+			Header header;
+			CUtlBuffer stream;
+			CUtlVector<u32> keyframeOffsets;
+			QuantizedFrame previous;
+		};
+
+		static_assert(KZ_REPLAY_MAX_BLOCK_SIZE <= UINT16_MAX, "Replay blocks must fit in 16 bits");
+
+		// Reads frames sequentially straight out of a memory region. Uncompressed data is never copied,
+		// compressed blocks are decompressed one at a time into a fixed buffer.
+		class ReplayDecoder
+		{
+		public:
+			// Returns false if the data does not contain a valid replay.
+			bool Init(const u8 *data, size_t size);
+
+			const Header *GetHeader() const
+			{
+				return header;
+			}
+
+			// Index of the frame that the next call to NextFrame will return.
+			u32 GetFrameIndex() const
+			{
+				return frameIndex;
+			}
+
+			bool NextFrame(Frame &out);
+			// Jump to the keyframe at or right before the frame index.
+			bool Seek(u32 frame);
+
+		private:
+			bool LoadBlock(u32 keyframe);
+
+			const u8 *data {};
+			size_t size {};
+			const Header *header {};
+			u32 frameIndex {};
+			QuantizedFrame current;
+
+			// Frame data that is currently being read, either pointing into data or into blockBuffer.
+			const u8 *block {};
+			u32 blockSize {};
+			u32 cursor {};
+			u8 blockBuffer[KZ_REPLAY_MAX_BLOCK_SIZE];
+		};
+	} // namespace replays
+} // namespace KZ
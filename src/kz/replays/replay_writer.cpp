@@ -0,0 +1,339 @@
+#include "replay_writer.h"
+#include "utils/plat.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::replays;
+
+// How long the writer sleeps when there is nothing to do.
+#define WRITER_IDLE_SLEEP_MS 10
+
+static_global std::thread writerThread;
+static_global std::atomic<bool> writerRunning;
+
+static_assert((KZ_REPLAY_WRITER_QUEUE_SIZE & (KZ_REPLAY_WRITER_QUEUE_SIZE - 1)) == 0, "Writer queue size must be a power of two");
+
+// Single producer single consumer ring of jobs. head is only written by the consumer, tail only by the producer.
+template<typename T>
+struct JobQueue
+{
+	T *jobs[KZ_REPLAY_WRITER_QUEUE_SIZE];
+	std::atomic<u32> head;
+	std::atomic<u32> tail;
+
+	bool Push(T *job)
+	{
+		u32 tail = this->tail.load(std::memory_order_relaxed);
+		if (tail - this->head.load(std::memory_order_acquire) >= KZ_REPLAY_WRITER_QUEUE_SIZE)
+		{
+			return false;
+		}
+		this->jobs[tail % KZ_REPLAY_WRITER_QUEUE_SIZE] = job;
+		this->tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	T *Pop()
+	{
+		u32 head = this->head.load(std::memory_order_relaxed);
+		if (head == this->tail.load(std::memory_order_acquire))
+		{
+			return nullptr;
+		}
+		T *job = this->jobs[head % KZ_REPLAY_WRITER_QUEUE_SIZE];
+		this->head.store(head + 1, std::memory_order_release);
+		return job;
+	}
+};
+
+static_global JobQueue<WriteJob> writeQueue;
+static_global JobQueue<GhostLoadJob> loadQueue;
+
+// Loaded ghosts waiting for the game thread to pick them up.
+static_global std::mutex loadedMutex;
+static_global CUtlVector<GhostLoadJob *> loadedGhosts;
+
+// Replays that couldn't be written, the game thread takes back the saved times it assumed for them.
+static_global std::mutex failedMutex;
+static_global CUtlVector<FailedWrite> failedWrites;
+
+// Printing to the console is only safe on the game thread, the writer leaves its messages here for PrintWriterMessages.
+static_global std::mutex messageMutex;
+static_global CUtlVector<CUtlString> messages;
+
+static_function void QueueMessage(const char *format, ...)
+{
+	char buffer[1024];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	std::lock_guard<std::mutex> lock(messageMutex);
+	messages.AddToTail(buffer);
+}
+
+static_function bool CreateDirectories(const char *path)
+{
+	char directory[MAX_PATH];
+	V_strncpy(directory, path, sizeof(directory));
+	V_StripFilename(directory);
+	// Skip the root so that absolute paths don't try to create "" or a drive letter.
+	for (char *c = directory + 1; *c; c++)
+	{
+		if (*c != '/' && *c != '\\')
+		{
+			continue;
+		}
+		char separator = *c;
+		*c = '\0';
+		bool success = Plat_CreateDirectory(directory);
+		*c = separator;
+		if (!success)
+		{
+			return false;
+		}
+	}
+	return Plat_CreateDirectory(directory);
+}
+
+static_function bool WriteFile(const char *path, const CUtlBuffer &buffer)
+{
+	if (!CreateDirectories(path))
+	{
+		return false;
+	}
+
+	// Write to a temporary file first so that a crash never leaves a truncated replay behind.
+	char tempPath[MAX_PATH];
+	V_snprintf(tempPath, sizeof(tempPath), "%s.tmp", path);
+	FILE *file = fopen(tempPath, "wb");
+	if (!file)
+	{
+		return false;
+	}
+	bool success = fwrite(buffer.Base(), 1, buffer.TellPut(), file) == (size_t)buffer.TellPut();
+	success = Plat_SyncFile(file) && success;
+	success = fclose(file) == 0 && success;
+	if (!success || !Plat_ReplaceFile(tempPath, path))
+	{
+		remove(tempPath);
+		return false;
+	}
+	return true;
+}
+
+static_function bool AppendFile(const char *path, const CUtlBuffer &buffer)
+{
+	if (!CreateDirectories(path))
+	{
+		return false;
+	}
+	FILE *file = fopen(path, "ab");
+	if (!file)
+	{
+		return false;
+	}
+	bool success = fwrite(buffer.Base(), 1, buffer.TellPut(), file) == (size_t)buffer.TellPut();
+	return fclose(file) == 0 && success;
+}
+
+// Time of the replay saved at the path, 0 if there is none. Only the header is read.
+static_function f64 ReadReplayTime(const char *path)
+{
+	f64 time = 0.0;
+	size_t size = 0;
+	void *data = Plat_MapFile(path, &size);
+	if (data)
+	{
+		ReplayDecoder decoder;
+		if (decoder.Init((const u8 *)data, size))
+		{
+			time = decoder.GetHeader()->time;
+		}
+		Plat_UnmapFile(data, size);
+	}
+	return time;
+}
+
+static_function void ProcessJob(WriteJob *job)
+{
+	if (job->appendData.TellPut() > 0)
+	{
+		FOR_EACH_VEC(job->paths, i)
+		{
+			if (!AppendFile(job->paths[i].Get(), job->appendData))
+			{
+				QueueMessage("[KZ::Replays] Failed to append to %s.\n", job->paths[i].Get());
+			}
+		}
+		return;
+	}
+
+	// Drop the paths that already hold a faster replay before spending time on encoding.
+	FOR_EACH_VEC_BACK(job->paths, i)
+	{
+		f64 savedTime = ReadReplayTime(job->paths[i].Get());
+		if (savedTime > 0.0 && savedTime <= job->header.time)
+		{
+			job->paths.Remove(i);
+		}
+	}
+	if (job->paths.Count() == 0)
+	{
+		return;
+	}
+
+	ReplayEncoder encoder;
+	encoder.Begin(job->header);
+	FOR_EACH_VEC(job->frames, i)
+	{
+		encoder.AddFrame(job->frames[i]);
+	}
+	CUtlBuffer buffer;
+	encoder.Finish(buffer, true);
+
+	FOR_EACH_VEC(job->paths, i)
+	{
+		if (!WriteFile(job->paths[i].Get(), buffer))
+		{
+			QueueMessage("[KZ::Replays] Failed to write %s.\n", job->paths[i].Get());
+			std::lock_guard<std::mutex> lock(failedMutex);
+			failedWrites.AddToTail({job->slot, job->header.steamID64, job->paths[i], job->header.time});
+		}
+	}
+}
+
+static_function void ProcessLoadJob(GhostLoadJob *job)
+{
+	job->success = job->ghost.LoadFromFile(job->path.Get(), &job->time);
+	job->proTime = ReadReplayTime(job->proPath.Get());
+	std::lock_guard<std::mutex> lock(loadedMutex);
+	loadedGhosts.AddToTail(job);
+}
+
+static_function void WriterMain()
+{
+	while (true)
+	{
+		// Read the flag before checking the queue, so every job queued before StopWriter still gets written.
+		bool stopping = !writerRunning.load(std::memory_order_acquire);
+		// Players are waiting for their ghost, loads go first. Nobody is left to use them once the writer stops.
+		if (GhostLoadJob *loadJob = loadQueue.Pop())
+		{
+			if (stopping)
+			{
+				delete loadJob;
+			}
+			else
+			{
+				ProcessLoadJob(loadJob);
+			}
+			continue;
+		}
+		WriteJob *job = writeQueue.Pop();
+		if (!job)
+		{
+			if (stopping)
+			{
+				break;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(WRITER_IDLE_SLEEP_MS));
+			continue;
+		}
+		ProcessJob(job);
+		delete job;
+	}
+}
+
+void KZ::replays::StartWriter()
+{
+	if (writerThread.joinable())
+	{
+		return;
+	}
+	writerRunning.store(true, std::memory_order_release);
+	writerThread = std::thread(WriterMain);
+}
+
+void KZ::replays::StopWriter()
+{
+	if (!writerThread.joinable())
+	{
+		return;
+	}
+	writerRunning.store(false, std::memory_order_release);
+	writerThread.join();
+	PrintWriterMessages();
+	FOR_EACH_VEC(loadedGhosts, i)
+	{
+		delete loadedGhosts[i];
+	}
+	loadedGhosts.Purge();
+	failedWrites.Purge();
+}
+
+void KZ::replays::PrintWriterMessages()
+{
+	CUtlVector<CUtlString> pending;
+	{
+		std::lock_guard<std::mutex> lock(messageMutex);
+		if (messages.Count() == 0)
+		{
+			return;
+		}
+		pending.Swap(messages);
+	}
+	FOR_EACH_VEC(pending, i)
+	{
+		META_CONPRINTF("%s", pending[i].Get());
+	}
+}
+
+bool KZ::replays::QueueWrite(WriteJob *job)
+{
+	if (!writerRunning.load(std::memory_order_relaxed) || !writeQueue.Push(job))
+	{
+		delete job;
+		return false;
+	}
+	return true;
+}
+
+bool KZ::replays::QueueGhostLoad(GhostLoadJob *job)
+{
+	if (!writerRunning.load(std::memory_order_relaxed) || !loadQueue.Push(job))
+	{
+		delete job;
+		return false;
+	}
+	return true;
+}
+
+GhostLoadJob *KZ::replays::PopLoadedGhost()
+{
+	std::lock_guard<std::mutex> lock(loadedMutex);
+	if (loadedGhosts.Count() == 0)
+	{
+		return nullptr;
+	}
+	GhostLoadJob *job = loadedGhosts[0];
+	loadedGhosts.Remove(0);
+	return job;
+}
+
+bool KZ::replays::PopFailedWrite(FailedWrite &out)
+{
+	std::lock_guard<std::mutex> lock(failedMutex);
+	if (failedWrites.Count() == 0)
+	{
+		return false;
+	}
+	out = failedWrites[0];
+	failedWrites.Remove(0);
+	return true;
+}
@@ -0,0 +1,71 @@
+// Background writer for replay files.
+// Encoding, compression and disk I/O all happen on a dedicated thread so that saving a run never stalls the game frame.
+// The same thread loads ghosts, which would otherwise read a whole replay on the game thread every time a timer starts.
+// The game thread is the only producer, the writer thread the only consumer.
+
+#pragma once
+#include "replay_format.h"
+#include "ghost.h"
+#include "utlstring.h"
+
+// Must be a power of two.
+#define KZ_REPLAY_WRITER_QUEUE_SIZE 64
+
+namespace KZ
+{
+	namespace replays
+	{
+		struct WriteJob
+		{
+			Header header;
+			CUtlVector<Frame> frames;
+			// Absolute paths, the same replay gets written to every one of them.
+			CUtlVector<CUtlString> paths;
+			// If not empty, this is appended to the files as is instead of writing a replay. Used by usercmd captures.
+			// Replays are only written over replays with a slower time, the game thread doesn't always know the saved time.
+			CUtlBuffer appendData;
+			// Player the replay belongs to, reported back with every path that failed to be written.
+			i32 slot {};
+		};
+
+		struct FailedWrite
+		{
+			i32 slot;
+			u64 steamID64;
+			CUtlString path;
+			f64 time;
+		};
+
+		struct GhostLoadJob
+		{
+			CUtlString path;
+			// Set by the requester to tell whether the result is still wanted once it comes back.
+			i32 slot {};
+			u32 serial {};
+
+			// Pro replay of the same run, only its time is read.
+			CUtlString proPath;
+
+			// Filled in by the writer thread.
+			bool success {};
+			Ghost ghost;
+			// Run times from the replay headers, 0 if there is no valid replay.
+			f64 time {};
+			f64 proTime {};
+		};
+
+		void StartWriter();
+		// Waits for every queued job to be written before returning.
+		void StopWriter();
+		// Takes ownership of the job. Returns false (and deletes the job) if the queue is full or the writer is not running.
+		bool QueueWrite(WriteJob *job);
+		// Takes ownership of the job. Returns false (and deletes the job) if the queue is full or the writer is not running.
+		bool QueueGhostLoad(GhostLoadJob *job);
+		// Game thread only. Returns the next finished load, the caller owns it.
+		GhostLoadJob *PopLoadedGhost();
+		// Game thread only. Returns false once every replay that failed to be written has been popped.
+		bool PopFailedWrite(FailedWrite &out);
+		// Print what the writer had to report since the last call. Game thread only, called every frame.
+		void PrintWriterMessages();
+	} // namespace replays
+} // namespace KZ
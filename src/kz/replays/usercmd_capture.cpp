@@ -0,0 +1,126 @@
+#include "cs_usercmd.pb.h"
+#include "usercmd_capture.h"
+#include "replay_writer.h"
+#include "sdk/usercmd.h"
+#include "utils/varint.h"
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::replays;
+
+void KZ::replays::FillMoveDataRecord(const CMoveData &mv, MoveDataRecord &out)
+{
+	out.viewAngles = mv.m_vecViewAngles;
+	out.absViewAngles = mv.m_vecAbsViewAngles;
+	out.lastMovementImpulses = mv.m_vecLastMovementImpulses;
+	out.velocity = mv.m_vecVelocity;
+	out.angles = mv.m_vecAngles;
+	out.collisionNormal = mv.m_collisionNormal;
+	out.groundNormal = mv.m_groundNormal;
+	out.absOrigin = mv.m_vecAbsOrigin;
+	out.forwardMove = mv.m_flForwardMove;
+	out.sideMove = mv.m_flSideMove;
+	out.upMove = mv.m_flUpMove;
+	out.maxSpeed = mv.m_flMaxSpeed;
+	out.subtickStartFraction = mv.m_flSubtickStartFraction;
+	out.subtickEndFraction = mv.m_flSubtickEndFraction;
+	out.tickCount = mv.m_nTickCount;
+	out.targetTick = mv.m_nTargetTick;
+	out.flags = 0;
+	out.flags |= mv.m_bFirstRunOfFunctions ? MOVEDATA_FIRST_RUN : 0;
+	out.flags |= mv.m_bIsLateCommand ? MOVEDATA_LATE_COMMAND : 0;
+	out.flags |= mv.m_bHasNextCommand ? MOVEDATA_HAS_NEXT_COMMAND : 0;
+	out.flags |= mv.m_bHasSubtickInputs ? MOVEDATA_HAS_SUBTICK_INPUTS : 0;
+	out.flags |= mv.m_bInAir ? MOVEDATA_IN_AIR : 0;
+	out.flags |= mv.m_bGameCodeMovedPlayer ? MOVEDATA_GAME_CODE_MOVED_PLAYER : 0;
+	V_memset(out.padding, 0, sizeof(out.padding));
+}
+
+void CaptureWriter::Begin(const CaptureHeader &header, const char *path)
+{
+	this->End();
+	this->capturing = true;
+	this->path = path;
+	this->buffer.Put(&header, sizeof(header));
+}
+
+void CaptureWriter::AddUsercmd(PlayerCommand *pc)
+{
+	if (!this->capturing)
+	{
+		return;
+	}
+	this->buffer.PutUnsignedChar(CAPTURE_USERCMD);
+	varint::Put(this->buffer, (u32)pc->cmdNum);
+	for (u32 i = 0; i < 3; i++)
+	{
+		varint::Put(this->buffer, pc->buttonstates.buttons[i]);
+	}
+
+	const CSGOUserCmdPB *cmd = pc;
+	i32 size = (i32)cmd->ByteSizeLong();
+	varint::Put(this->buffer, size);
+	this->buffer.EnsureCapacity(this->buffer.TellPut() + size);
+	cmd->SerializeToArray(this->buffer.PeekPut(), size);
+	this->buffer.SeekPut(CUtlBuffer::SEEK_CURRENT, size);
+}
+
+void CaptureWriter::AddMoveData(CaptureRecordType type, const CMoveData &mv)
+{
+	if (!this->capturing)
+	{
+		return;
+	}
+	MoveDataRecord record;
+	FillMoveDataRecord(mv, record);
+	this->buffer.PutUnsignedChar(type);
+	this->buffer.Put(&record, sizeof(record));
+
+	varint::Put(this->buffer, mv.m_SubtickMoves.Count());
+	FOR_EACH_VEC(mv.m_SubtickMoves, i)
+	{
+		const SubtickMove &move = mv.m_SubtickMoves[i];
+		this->buffer.Put(&move.when, sizeof(move.when));
+		varint::Put(this->buffer, move.button);
+		if (move.button == 0)
+		{
+			this->buffer.Put(&move.analogMove.analog_forward_delta, sizeof(f32));
+			this->buffer.Put(&move.analogMove.analog_left_delta, sizeof(f32));
+		}
+		else
+		{
+			this->buffer.PutUnsignedChar(move.pressed);
+		}
+	}
+
+	// Both move data records of a tick are written together, flushing after the post record keeps ticks in one piece.
+	if (type == CAPTURE_MOVEDATA_POST && this->buffer.TellPut() >= KZ_CAPTURE_FLUSH_SIZE)
+	{
+		this->Flush();
+	}
+}
+
+void CaptureWriter::Flush()
+{
+	if (!this->capturing || this->buffer.TellPut() == 0)
+	{
+		return;
+	}
+	WriteJob *job = new WriteJob();
+	job->paths.AddToTail(this->path);
+	job->appendData.Put(this->buffer.Base(), this->buffer.TellPut());
+	this->buffer.Clear();
+	if (!QueueWrite(job))
+	{
+		// A gap would make the rest of the capture useless for replaying, so stop here.
+		META_CONPRINTF("[KZ::Replays] Writer queue is full, stopping usercmd capture %s.\n", this->path.Get());
+		this->capturing = false;
+	}
+}
+
+void CaptureWriter::End()
+{
+	this->Flush();
+	this->capturing = false;
+	this->buffer.Purge();
+}
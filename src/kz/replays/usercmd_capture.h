@@ -0,0 +1,106 @@
+// Usercmd capture log, an opt-in record of every command a player sends and what the movement code made of it.
+// It is meant to be fed back into the movement code offline, so floats are stored bit for bit instead of quantized.
+//
+// Layout: CaptureHeader | records. Every record starts with its CaptureRecordType:
+// - CAPTURE_USERCMD: varint command number, 3 varint button states, varint size, serialized CSGOUserCmdPB (subtick moves included).
+// - CAPTURE_MOVEDATA_PRE/POST: MoveDataRecord, varint subtick move count, subtick moves.
+//   A subtick move is f32 when, varint button, then f32 forward and left deltas for analog moves (button 0) or u8 pressed.
+
+#pragma once
+#include "replay_format.h"
+#include "sdk/datatypes.h"
+#include "utlstring.h"
+
+#define KZ_CAPTURE_MAGIC     0x43555A4B // "KZUC"
+#define KZ_CAPTURE_VERSION   1
+#define KZ_CAPTURE_DIRECTORY "kzcaptures"
+// Captured data is handed to the replay writer thread once this many bytes are buffered.
+#define KZ_CAPTURE_FLUSH_SIZE 65536
+
+class PlayerCommand;
+
+namespace KZ
+{
+	namespace replays
+	{
+		enum CaptureRecordType : u8
+		{
+			CAPTURE_USERCMD = 0,
+			CAPTURE_MOVEDATA_PRE,
+			CAPTURE_MOVEDATA_POST,
+			CAPTURE_RECORD_COUNT
+		};
+
+		enum MoveDataRecordFlags : u8
+		{
+			MOVEDATA_FIRST_RUN = 1 << 0,
+			MOVEDATA_LATE_COMMAND = 1 << 1,
+			MOVEDATA_HAS_NEXT_COMMAND = 1 << 2,
+			MOVEDATA_HAS_SUBTICK_INPUTS = 1 << 3,
+			MOVEDATA_IN_AIR = 1 << 4,
+			MOVEDATA_GAME_CODE_MOVED_PLAYER = 1 << 5
+		};
+
+		struct CaptureHeader
+		{
+			u32 magic = KZ_CAPTURE_MAGIC;
+			u32 version = KZ_CAPTURE_VERSION;
+			f32 tickInterval = ENGINE_FIXED_TICK_INTERVAL;
+			u32 reserved {};
+			u64 steamID64 {};
+			char playerName[KZ_REPLAY_MAX_NAME_LENGTH] {};
+			char mapName[KZ_REPLAY_MAX_NAME_LENGTH] {};
+		};
+
+		static_assert(sizeof(CaptureHeader) == 24 + 2 * KZ_REPLAY_MAX_NAME_LENGTH, "Capture header must not contain padding");
+
+		// Every CMoveData field the movement code reads, pointers and touch traces aren't meaningful outside of the server.
+		struct MoveDataRecord
+		{
+			QAngle viewAngles;
+			QAngle absViewAngles;
+			Vector lastMovementImpulses;
+			Vector velocity;
+			Vector angles;
+			Vector collisionNormal;
+			Vector groundNormal;
+			Vector absOrigin;
+			f32 forwardMove;
+			f32 sideMove;
+			f32 upMove;
+			f32 maxSpeed;
+			f32 subtickStartFraction;
+			f32 subtickEndFraction;
+			i32 tickCount;
+			i32 targetTick;
+			u8 flags;
+			u8 padding[3];
+		};
+
+		static_assert(sizeof(MoveDataRecord) == 132, "Move data record must not contain padding");
+
+		void FillMoveDataRecord(const CMoveData &mv, MoveDataRecord &out);
+
+		// Buffers the capture of one player, full buffers are appended to the file by the replay writer thread.
+		class CaptureWriter
+		{
+		public:
+			bool IsCapturing() const
+			{
+				return this->capturing;
+			}
+
+			void Begin(const CaptureHeader &header, const char *path);
+			void AddUsercmd(PlayerCommand *pc);
+			void AddMoveData(CaptureRecordType type, const CMoveData &mv);
+			// Hand everything buffered so far to the writer thread.
+			void Flush();
+			void End();
+
+		private:
+			bool capturing {};
+			CUtlString path;
+			CUtlBuffer buffer;
+		};
+	} // namespace replays
+} // namespace KZ
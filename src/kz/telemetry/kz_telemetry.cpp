@@ -2,6 +2,7 @@
 #include "utils/simplecmds.h"
 #include "kz/language/kz_language.h"
 #include "sdk/usercmd.h"
+#include "utils/perf.h"
 
 #define AFK_THRESHOLD 30.0f
 f64 KZTelemetryService::lastActiveCheckTime = 0.0f;
@@ -23,6 +24,7 @@ void KZTelemetryService::OnPhysicsSimulatePost()
 
 void KZTelemetryService::ActiveCheck()
 {
+	KZ_PROFILE(__func__);
 	f64 currentTime = g_pKZUtils->GetServerGlobals()->realtime;
 	f64 duration = currentTime - KZTelemetryService::lastActiveCheckTime;
 	for (u32 i = 0; i < MAXPLAYERS + 1; i++)
@@ -3,6 +3,7 @@
 #include "kz/language/kz_language.h"
 #include "kz/mode/kz_mode.h"
 #include "kz/style/kz_style.h"
+#include "utils/perf.h"
 using namespace KZ::timer;
 #define ANNOUNCEMENT_WAIT_THRESHOLD 5.0f
 
@@ -218,6 +219,7 @@ void KZ::timer::UpdateGlobalRankData(u32 id, GlobalRankData data)
 
 void KZ::timer::CheckAnnounceQueue()
 {
+	KZ_PROFILE(__func__);
 	FOR_EACH_VEC(announceQueue, i)
 	{
 		AnnounceData &announceData = announceQueue[i];
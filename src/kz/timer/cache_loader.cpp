@@ -0,0 +1,192 @@
+#include "kz_timer.h"
+#include "run_metadata.h"
+#include "kz/mode/kz_mode.h"
+#include "utils/perf.h"
+#include "vendor/sql_mm/src/public/sql_mm.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::timer;
+
+/*
+	PB and record caches are built from database rows on a separate thread, parsing the metadata of every row
+	on the game thread is noticeable on maps with many courses. The finished cache replaces the old one in one go.
+*/
+
+struct CacheRow
+{
+	PBDataKey key;
+	bool overall;
+	f64 time;
+	u32 splitCount;
+	u32 cpCount;
+	u32 stageCount;
+	std::string metadata;
+};
+
+struct CacheLoad
+{
+	// Either the server records, or the local PBs of a player.
+	bool records;
+	CPlayerUserId userID;
+	// Caches are keyed by course GUID, which only has a meaning on the map they were loaded for.
+	CUtlString mapName;
+	std::vector<CacheRow> rows;
+	std::unordered_map<PBDataKey, PBData> cache;
+};
+
+static_global std::thread loaderThread;
+static_global std::mutex loaderMutex;
+static_global std::condition_variable loaderCondition;
+static_global bool loaderRunning;
+static_global std::deque<CacheLoad *> pendingLoads;
+static_global std::deque<CacheLoad *> finishedLoads;
+
+static_function void BuildCache(CacheLoad *load)
+{
+	for (const CacheRow &row : load->rows)
+	{
+		PBData &pb = load->cache[row.key];
+		auto &data = row.overall ? pb.overall : pb.pro;
+		data.pbTime = row.time;
+		if (row.metadata.empty())
+		{
+			continue;
+		}
+		ZoneTimeList lists[METADATA_LIST_COUNT] = {
+			{data.pbSplitZoneTimes.Base(), MIN(row.splitCount, (u32)KZ_MAX_SPLIT_ZONES)},
+			{data.pbCpZoneTimes.Base(), MIN(row.cpCount, (u32)KZ_MAX_CHECKPOINT_ZONES)},
+			{data.pbStageZoneTimes.Base(), MIN(row.stageCount, (u32)KZ_MAX_STAGE_ZONES)},
+		};
+		DecodeRunMetadata(row.metadata.c_str(), lists);
+	}
+	load->rows.clear();
+}
+
+static_function void LoaderMain()
+{
+	std::unique_lock<std::mutex> lock(loaderMutex);
+	while (true)
+	{
+		loaderCondition.wait(lock, [] { return !loaderRunning || !pendingLoads.empty(); });
+		if (pendingLoads.empty())
+		{
+			break;
+		}
+		CacheLoad *load = pendingLoads.front();
+		pendingLoads.pop_front();
+		lock.unlock();
+		BuildCache(load);
+		lock.lock();
+		finishedLoads.push_back(load);
+	}
+}
+
+void KZ::timer::StartCacheLoader()
+{
+	if (loaderThread.joinable())
+	{
+		return;
+	}
+	loaderRunning = true;
+	loaderThread = std::thread(LoaderMain);
+}
+
+void KZ::timer::StopCacheLoader()
+{
+	if (!loaderThread.joinable())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(loaderMutex);
+		loaderRunning = false;
+	}
+	loaderCondition.notify_one();
+	loaderThread.join();
+	for (CacheLoad *load : finishedLoads)
+	{
+		delete load;
+	}
+	finishedLoads.clear();
+}
+
+void KZ::timer::QueueCacheLoad(bool records, CPlayerUserId userID, std::vector<ISQLQuery *> &queries)
+{
+	CacheLoad *load = new CacheLoad();
+	load->records = records;
+	load->userID = userID;
+	load->mapName = g_pKZUtils->GetCurrentMapName();
+
+	// Only pull the rows out of the result sets here, everything else happens on the loader thread.
+	for (u32 i = 0; i < 2; i++)
+	{
+		ISQLResult *result = queries[i]->GetResultSet();
+		if (!result)
+		{
+			continue;
+		}
+		while (result->FetchRow())
+		{
+			auto modeInfo = KZ::mode::GetModeInfoFromDatabaseID(result->GetInt(2));
+			if (modeInfo.databaseID < 0)
+			{
+				continue;
+			}
+			const KZCourse *course = KZ::course::GetCourseByLocalCourseID(result->GetInt(1));
+			if (!course)
+			{
+				continue;
+			}
+			load->rows.push_back({ToPBDataKey(modeInfo.id, course->guid), i == 0, result->GetFloat(0), (u32)course->descriptor->splitCount,
+								  (u32)course->descriptor->checkpointCount, (u32)course->descriptor->stageCount, result->GetString(3)});
+		}
+	}
+
+	if (!loaderThread.joinable())
+	{
+		BuildCache(load);
+		std::lock_guard<std::mutex> lock(loaderMutex);
+		finishedLoads.push_back(load);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(loaderMutex);
+		pendingLoads.push_back(load);
+	}
+	loaderCondition.notify_one();
+}
+
+void KZ::timer::CheckCacheLoads()
+{
+	KZ_PROFILE(__func__);
+	std::deque<CacheLoad *> loads;
+	{
+		std::lock_guard<std::mutex> lock(loaderMutex);
+		loads.swap(finishedLoads);
+	}
+	for (CacheLoad *load : loads)
+	{
+		if (KZ_STREQ(load->mapName.Get(), g_pKZUtils->GetCurrentMapName().Get()))
+		{
+			if (load->records)
+			{
+				KZTimerService::SwapRecordCache(load->cache);
+			}
+			else
+			{
+				KZPlayer *player = g_pKZPlayerManager->ToPlayer(load->userID);
+				if (player)
+				{
+					player->timerService->SwapPBCache(load->cache);
+				}
+			}
+		}
+		delete load;
+	}
+}
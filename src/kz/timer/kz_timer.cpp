@@ -1,4 +1,5 @@
 #include "kz_timer.h"
+#include "run_metadata.h"
 #include "kz/db/kz_db.h"
 #include "kz/language/kz_language.h"
 #include "kz/mode/kz_mode.h"
@@ -967,110 +968,13 @@ void KZTimerService::ClearRecordCache()
 
 void KZTimerService::UpdateLocalRecordCache()
 {
-	auto onQuerySuccess = [](std::vector<ISQLQuery *> queries)
-	{
-		ISQLResult *result = queries[0]->GetResultSet();
-		if (result && result->GetRowCount() > 0)
-		{
-			while (result->FetchRow())
-			{
-				auto modeInfo = KZ::mode::GetModeInfoFromDatabaseID(result->GetInt(2));
-				if (modeInfo.databaseID < 0)
-				{
-					continue;
-				}
-				const KZCourse *course = KZ::course::GetCourseByLocalCourseID(result->GetInt(1));
-				if (!course)
-				{
-					continue;
-				}
-				KZTimerService::InsertRecordToCache(result->GetFloat(0), course, modeInfo.id, true, false, result->GetString(3));
-			}
-		}
-		result = queries[1]->GetResultSet();
-		if (result && result->GetRowCount() > 0)
-		{
-			while (result->FetchRow())
-			{
-				auto modeInfo = KZ::mode::GetModeInfoFromDatabaseID(result->GetInt(2));
-				if (modeInfo.databaseID < 0)
-				{
-					continue;
-				}
-				const KZCourse *course = KZ::course::GetCourseByLocalCourseID(result->GetInt(1));
-				if (!course)
-				{
-					continue;
-				}
-				KZTimerService::InsertRecordToCache(result->GetFloat(0), course, modeInfo.id, false, false, result->GetString(3));
-			}
-		}
-	};
+	auto onQuerySuccess = [](std::vector<ISQLQuery *> queries) { KZ::timer::QueueCacheLoad(true, CPlayerUserId(-1), queries); };
 	KZDatabaseService::QueryAllRecords(g_pKZUtils->GetCurrentMapName(), onQuerySuccess, KZDatabaseService::OnGenericTxnFailure);
 }
 
-void KZTimerService::InsertRecordToCache(f64 time, const KZCourse *course, PluginId modeID, bool overall, bool global, CUtlString metadata)
+void KZTimerService::SwapRecordCache(std::unordered_map<PBDataKey, PBData> &cache)
 {
-	PBData &pb = global ? KZTimerService::wrCache[ToPBDataKey(modeID, course->guid)] : KZTimerService::srCache[ToPBDataKey(modeID, course->guid)];
-
-	overall ? pb.overall.pbTime = time : pb.pro.pbTime = time;
-	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
-	CUtlString error = "";
-	if (metadata.IsEmpty())
-	{
-		return;
-	}
-	LoadKV3FromJSON(&kv, &error, metadata.Get(), "");
-	if (!error.IsEmpty())
-	{
-		META_CONPRINTF("[KZ::Timer] Failed to insert PB to cache due to metadata error: %s\n", error.Get());
-		return;
-	}
-
-	KeyValues3 *data = kv.FindMember("splitZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->descriptor->splitCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbSplitZoneTimes[i] = time : pb.pro.pbSplitZoneTimes[i] = time;
-		}
-	}
-
-	data = kv.FindMember("cpZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->descriptor->checkpointCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbCpZoneTimes[i] = time : pb.pro.pbCpZoneTimes[i] = time;
-		}
-	}
-
-	data = kv.FindMember("stageZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->descriptor->stageCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbStageZoneTimes[i] = time : pb.pro.pbStageZoneTimes[i] = time;
-		}
-	}
+	KZTimerService::srCache.swap(cache);
 }
 
 void KZTimerService::ClearPBCache()
@@ -1078,70 +982,6 @@ void KZTimerService::ClearPBCache()
 	this->localPBCache.clear();
 }
 
-void KZTimerService::InsertPBToCache(f64 time, const KZCourse *course, PluginId modeID, bool overall, bool global, CUtlString metadata)
-{
-	PBData &pb = global ? this->globalPBCache[ToPBDataKey(modeID, course->guid)] : this->localPBCache[ToPBDataKey(modeID, course->guid)];
-
-	overall ? pb.overall.pbTime = time : pb.pro.pbTime = time;
-	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
-	CUtlString error = "";
-	if (metadata.IsEmpty())
-	{
-		return;
-	}
-	LoadKV3FromJSON(&kv, &error, metadata.Get(), "");
-	if (!error.IsEmpty())
-	{
-		META_CONPRINTF("[KZ::Timer] Failed to insert server record to cache due to metadata error: %s\n", error.Get());
-		return;
-	}
-
-	KeyValues3 *data = kv.FindMember("splitZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->descriptor->splitCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbSplitZoneTimes[i] = time : pb.pro.pbSplitZoneTimes[i] = time;
-		}
-	}
-
-	data = kv.FindMember("cpZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->descriptor->checkpointCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbCpZoneTimes[i] = time : pb.pro.pbCpZoneTimes[i] = time;
-		}
-	}
-
-	data = kv.FindMember("stageZoneTimes");
-	if (data && data->GetType() == KV3_TYPE_ARRAY)
-	{
-		for (i32 i = 0; i < course->descriptor->stageCount; i++)
-		{
-			f64 time = -1.0f;
-			KeyValues3 *element = data->GetArrayElement(i);
-			if (element)
-			{
-				time = element->GetDouble(-1.0);
-			}
-			overall ? pb.overall.pbStageZoneTimes[i] = time : pb.pro.pbStageZoneTimes[i] = time;
-		}
-	}
-}
-
 void KZTimerService::CheckMissedTime()
 {
 	const KZCourse *course = this->GetCourse();
@@ -1357,98 +1197,36 @@ void KZTimerService::ShowStageText()
 
 CUtlString KZTimerService::GetCurrentRunMetadata()
 {
-	KeyValues3 kv(KV3_TYPEEX_TABLE, KV3_SUBTYPE_UNSPECIFIED);
-
-	KeyValues3 *splitZoneTimesKV = kv.FindOrCreateMember("splitZoneTimes");
-
-	splitZoneTimesKV->SetToEmptyArray();
-	FOR_EACH_VEC(this->splitZoneTimes, i)
-	{
-		KeyValues3 *time = splitZoneTimesKV->ArrayAddElementToTail();
-		time->SetDouble(this->splitZoneTimes[i]);
-	}
-
-	KeyValues3 *cpZoneTimesKV = kv.FindOrCreateMember("cpZoneTimes");
-	cpZoneTimesKV->SetToEmptyArray();
-	FOR_EACH_VEC(this->cpZoneTimes, i)
-	{
-		KeyValues3 *time = cpZoneTimesKV->ArrayAddElementToTail();
-		time->SetDouble(this->cpZoneTimes[i]);
-	}
-
-	splitZoneTimesKV->SetToEmptyArray();
-
-	KeyValues3 *stageZoneTimesKV = kv.FindOrCreateMember("stageZoneTimes");
-	FOR_EACH_VEC(this->stageZoneTimes, i)
-	{
-		KeyValues3 *time = stageZoneTimesKV->ArrayAddElementToTail();
-		time->SetDouble(this->stageZoneTimes[i]);
-	}
-
-	CUtlString result, error;
-	if (SaveKV3AsJSON(&kv, &error, &result))
-	{
-		return result;
-	}
-	META_CONPRINTF("[KZ::Timer] Failed to obtain current run's metadata! (%s)\n", error.Get());
-	return "";
+	KZ::timer::ZoneTimeList lists[KZ::timer::METADATA_LIST_COUNT] = {
+		{this->splitZoneTimes.Base(), (u32)this->splitZoneTimes.Count()},
+		{this->cpZoneTimes.Base(), (u32)this->cpZoneTimes.Count()},
+		{this->stageZoneTimes.Base(), (u32)this->stageZoneTimes.Count()},
+	};
+	return KZ::timer::EncodeRunMetadata(lists);
 }
 
 void KZTimerService::UpdateLocalPBCache()
 {
 	CPlayerUserId uid = player->GetClient()->GetUserID();
-
-	auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
-	{
-		KZPlayer *pl = g_pKZPlayerManager->ToPlayer(uid);
-		if (!pl)
-		{
-			return;
-		}
-		ISQLResult *result = queries[0]->GetResultSet();
-		if (result && result->GetRowCount() > 0)
-		{
-			while (result->FetchRow())
-			{
-				auto modeInfo = KZ::mode::GetModeInfoFromDatabaseID(result->GetInt(2));
-				if (modeInfo.databaseID < 0)
-				{
-					continue;
-				}
-				const KZCourse *course = KZ::course::GetCourseByLocalCourseID(result->GetInt(1));
-				if (!course)
-				{
-					continue;
-				}
-				pl->timerService->InsertPBToCache(result->GetFloat(0), course, modeInfo.id, true, false, result->GetString(3));
-			}
-		}
-		result = queries[1]->GetResultSet();
-		if (result && result->GetRowCount() > 0)
-		{
-			while (result->FetchRow())
-			{
-				auto modeInfo = KZ::mode::GetModeInfoFromDatabaseID(result->GetInt(2));
-				if (modeInfo.databaseID < 0)
-				{
-					continue;
-				}
-				const KZCourse *course = KZ::course::GetCourseByLocalCourseID(result->GetInt(1));
-				if (!course)
-				{
-					continue;
-				}
-				pl->timerService->InsertPBToCache(result->GetFloat(0), course, modeInfo.id, false, false, result->GetString(3));
-			}
-		}
-	};
+	auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries) { KZ::timer::QueueCacheLoad(false, uid, queries); };
 	KZDatabaseService::QueryAllPBs(player->GetSteamId64(), g_pKZUtils->GetCurrentMapName(), onQuerySuccess, KZDatabaseService::OnGenericTxnFailure);
 }
 
+void KZTimerService::SwapPBCache(std::unordered_map<PBDataKey, PBData> &cache)
+{
+	this->localPBCache.swap(cache);
+}
+
 void KZTimerService::Init()
 {
 	KZDatabaseService::RegisterEventListener(&databaseEventListener);
 	KZOptionService::RegisterEventListener(&optionEventListener);
+	KZ::timer::StartCacheLoader();
+}
+
+void KZTimerService::Cleanup()
+{
+	KZ::timer::StopCacheLoader();
 }
 
 void KZTimerService::RegisterCommands()
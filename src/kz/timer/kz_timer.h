@@ -4,6 +4,8 @@
 #include "kz/course/kz_course.h"
 #include "kz/mappingapi/kz_mappingapi.h"
 
+class ISQLQuery;
+
 #define KZ_MAX_MODE_NAME_LENGTH 128
 
 #define KZ_TIMER_MIN_GROUND_TIME 0.05f
@@ -121,11 +123,18 @@ private:
 public:
 	static void ClearRecordCache();
 	static void UpdateLocalRecordCache();
-	static void InsertRecordToCache(f64 time, const KZCourse *courseName, PluginId modeID, bool hasTeleports, bool global, CUtlString metadata = "");
+	// Replace the whole cache with one built by the cache loader.
+	static void SwapRecordCache(std::unordered_map<PBDataKey, PBData> &cache);
 
 	void ClearPBCache();
 	void UpdateLocalPBCache();
-	void InsertPBToCache(f64 time, const KZCourse *courseName, PluginId modeID, bool hasTeleports, bool global, CUtlString metadata = "");
+	void SwapPBCache(std::unordered_map<PBDataKey, PBData> &cache);
+
+	const PBData *GetLocalPB(PBDataKey key)
+	{
+		return this->GetCompareTargetForType(COMPARE_SPB, key);
+	}
+
 	void SetCompareTarget(const char *typeString);
 
 	void CheckMissedTime();
@@ -142,6 +151,7 @@ private:
 
 public:
 	static void Init();
+	static void Cleanup();
 	static void RegisterCommands();
 	static void RegisterPBCommand();
 	static void RegisterRecordCommands();
@@ -373,5 +383,13 @@ namespace KZ
 		void CheckAnnounceQueue();
 		void UpdateLocalRankData(u32 id, LocalRankData data);
 		void UpdateGlobalRankData(u32 id, GlobalRankData data);
+
+		// PB and record caches
+		void StartCacheLoader();
+		void StopCacheLoader();
+		// Build a cache from the overall and pro rows of a PB or record query on the loader thread.
+		void QueueCacheLoad(bool records, CPlayerUserId userID, std::vector<ISQLQuery *> &queries);
+		// Hand finished caches over to the timer services, called every frame.
+		void CheckCacheLoads();
 	} // namespace timer
 } // namespace KZ
@@ -4,6 +4,7 @@
 #include "kz/timer/kz_timer.h"
 #include "kz/mode/kz_mode.h"
 #include "kz/style/kz_style.h"
+#include "utils/perf.h"
 #include "utils/ctimer.h"
 
 #include "vendor/sql_mm/src/public/sql_mm.h"
@@ -119,6 +120,7 @@ void BaseRequest::Remove(u64 uid)
 
 void BaseRequest::CheckRequests()
 {
+	KZ_PROFILE(__func__);
 	// clang-format off
 	instances.erase(std::remove_if(instances.begin(), instances.end(),
 		[](BaseRequest *instance)
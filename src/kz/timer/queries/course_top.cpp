@@ -1,6 +1,7 @@
 #include "base_request.h"
 #include "kz/timer/kz_timer.h"
 #include "kz/db/kz_db.h"
+#include "kz/db/leaderboard.h"
 
 #include "utils/simplecmds.h"
 
@@ -109,6 +110,24 @@ struct CourseTopRequest : public BaseRequest
 
 			this->localStatus = ResponseStatus::PENDING;
 
+			KZ::Database::Leaderboard *leaderboard = KZ::Database::GetLeaderboard(this->mapName, this->courseName, this->localModeID, false);
+			KZ::Database::Leaderboard *leaderboardPro = KZ::Database::GetLeaderboard(this->mapName, this->courseName, this->localModeID, true);
+			if (leaderboard && leaderboardPro)
+			{
+				this->localStatus = leaderboard->Count() > this->offset ? ResponseStatus::RECEIVED : ResponseStatus::DISABLED;
+				for (u64 i = this->offset; i < MIN(this->offset + this->limit, (u64)leaderboard->Count()); i++)
+				{
+					const KZ::Database::LeaderboardEntry *entry = leaderboard->GetEntry(i);
+					this->srData.overallData.AddToTail({entry->runID, entry->name, entry->teleportsUsed, entry->time, entry->steamID64});
+				}
+				for (u64 i = this->offset; i < MIN(this->offset + this->limit, (u64)leaderboardPro->Count()); i++)
+				{
+					const KZ::Database::LeaderboardEntry *entry = leaderboardPro->GetEntry(i);
+					this->srData.proData.AddToTail({entry->runID, entry->name, 0, entry->time, entry->steamID64});
+				}
+				return;
+			}
+
 			u64 uid = this->uid;
 
 			auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
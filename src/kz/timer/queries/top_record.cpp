@@ -1,6 +1,7 @@
 #include "base_request.h"
 #include "kz/timer/kz_timer.h"
 #include "kz/db/kz_db.h"
+#include "kz/db/leaderboard.h"
 
 #include "utils/simplecmds.h"
 
@@ -56,6 +57,27 @@ struct TopRecordRequest : public BaseRequest
 				return;
 			}
 
+			KZ::Database::Leaderboard *leaderboard = KZ::Database::GetLeaderboard(this->mapName, this->courseName, this->localModeID, false);
+			KZ::Database::Leaderboard *leaderboardPro = KZ::Database::GetLeaderboard(this->mapName, this->courseName, this->localModeID, true);
+			if (leaderboard && leaderboardPro)
+			{
+				this->localStatus = ResponseStatus::RECEIVED;
+				if (const KZ::Database::LeaderboardEntry *entry = leaderboard->GetEntry(0))
+				{
+					this->srData.hasRecord = true;
+					this->srData.holder = entry->name;
+					this->srData.runTime = entry->time;
+					this->srData.teleportsUsed = entry->teleportsUsed;
+				}
+				if (const KZ::Database::LeaderboardEntry *entry = leaderboardPro->GetEntry(0))
+				{
+					this->srData.hasRecordPro = true;
+					this->srData.holderPro = entry->name;
+					this->srData.runTimePro = entry->time;
+				}
+				return;
+			}
+
 			u64 uid = this->uid;
 
 			auto onQuerySuccess = [uid](std::vector<ISQLQuery *> queries)
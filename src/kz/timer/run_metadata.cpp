@@ -0,0 +1,173 @@
+#include "run_metadata.h"
+#include "utils/varint.h"
+
+#include <cmath>
+#include <string>
+
+#include "tier0/memdbgon.h"
+
+using namespace KZ::timer;
+
+#define MICROSECONDS_PER_SECOND 1000000.0
+
+static_global const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Names of the lists in the old JSON metadata.
+static_global const char *jsonListNames[METADATA_LIST_COUNT] = {"\"splitZoneTimes\"", "\"cpZoneTimes\"", "\"stageZoneTimes\""};
+
+static_function i64 QuantizeTime(f64 time)
+{
+	return time < 0.0 ? -1 : llround(time * MICROSECONDS_PER_SECOND);
+}
+
+static_function f64 DequantizeTime(i64 time)
+{
+	return time < 0 ? -1.0 : time / MICROSECONDS_PER_SECOND;
+}
+
+static_function std::string EncodeBase64(const std::string &data)
+{
+	std::string result;
+	result.reserve((data.size() + 2) / 3 * 4);
+	for (size_t i = 0; i < data.size(); i += 3)
+	{
+		u32 remaining = (u32)MIN(data.size() - i, (size_t)3);
+		u32 chunk = (u8)data[i] << 16;
+		chunk |= remaining > 1 ? (u8)data[i + 1] << 8 : 0;
+		chunk |= remaining > 2 ? (u8)data[i + 2] : 0;
+		for (u32 j = 0; j < 4; j++)
+		{
+			result += j <= remaining ? base64Alphabet[(chunk >> (18 - 6 * j)) & 0x3F] : '=';
+		}
+	}
+	return result;
+}
+
+static_function bool DecodeBase64(const char *text, std::string &data)
+{
+	u32 chunk = 0;
+	u32 bits = 0;
+	for (const char *c = text; *c && *c != '='; c++)
+	{
+		const char *position = strchr(base64Alphabet, *c);
+		if (!position)
+		{
+			return false;
+		}
+		chunk = (chunk << 6) | (u32)(position - base64Alphabet);
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			data += (char)((chunk >> bits) & 0xFF);
+		}
+	}
+	return true;
+}
+
+CUtlString KZ::timer::EncodeRunMetadata(const ZoneTimeList (&lists)[METADATA_LIST_COUNT])
+{
+	std::string data;
+	data += (char)KZ_RUN_METADATA_VERSION;
+	for (u32 list = 0; list < METADATA_LIST_COUNT; list++)
+	{
+		varint::Put(data, lists[list].count);
+		i64 previous = 0;
+		for (u32 i = 0; i < lists[list].count; i++)
+		{
+			i64 time = QuantizeTime(lists[list].times[i]);
+			i64 delta = time - previous;
+			varint::Put(data, varint::ZigZagEncode(delta));
+			previous = time;
+		}
+	}
+
+	CUtlString result;
+	result.Format("%c%s", KZ_RUN_METADATA_PREFIX, EncodeBase64(data).c_str());
+	return result;
+}
+
+static_function bool DecodeBinaryMetadata(const char *text, const ZoneTimeList (&lists)[METADATA_LIST_COUNT])
+{
+	std::string data;
+	if (!DecodeBase64(text, data) || data.empty() || (u8)data[0] != KZ_RUN_METADATA_VERSION)
+	{
+		return false;
+	}
+
+	size_t cursor = 1;
+	for (u32 list = 0; list < METADATA_LIST_COUNT; list++)
+	{
+		u64 count;
+		if (!varint::Get((const u8 *)data.data(), data.size(), cursor, count))
+		{
+			return false;
+		}
+		i64 time = 0;
+		for (u64 i = 0; i < count; i++)
+		{
+			u64 value;
+			if (!varint::Get((const u8 *)data.data(), data.size(), cursor, value))
+			{
+				return false;
+			}
+			time += varint::ZigZagDecode(value);
+			if (i < lists[list].count)
+			{
+				lists[list].times[i] = DequantizeTime(time);
+			}
+		}
+	}
+	return true;
+}
+
+// Read the array of numbers that follows the name of the list.
+static_function void DecodeJSONList(const char *metadata, const char *name, const ZoneTimeList &list)
+{
+	const char *c = strstr(metadata, name);
+	if (!c || !(c = strchr(c, '[')))
+	{
+		return;
+	}
+	c++;
+	for (u32 i = 0; i < list.count; i++)
+	{
+		while (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n' || *c == ',')
+		{
+			c++;
+		}
+		if (*c == ']' || *c == '\0')
+		{
+			return;
+		}
+		char *end;
+		f64 time = strtod(c, &end);
+		if (end == c)
+		{
+			return;
+		}
+		list.times[i] = time;
+		c = end;
+	}
+}
+
+bool KZ::timer::DecodeRunMetadata(const char *metadata, const ZoneTimeList (&lists)[METADATA_LIST_COUNT])
+{
+	if (!metadata || !metadata[0])
+	{
+		return false;
+	}
+	if (metadata[0] == KZ_RUN_METADATA_PREFIX)
+	{
+		return DecodeBinaryMetadata(metadata + 1, lists);
+	}
+	if (metadata[0] != '{')
+	{
+		return false;
+	}
+	for (u32 list = 0; list < METADATA_LIST_COUNT; list++)
+	{
+		DecodeJSONList(metadata, jsonListNames[list], lists[list]);
+	}
+	return true;
+}
@@ -0,0 +1,38 @@
+// Run metadata stored alongside every time, currently the split, checkpoint and stage zone times of the run.
+//
+// Binary layout: version | for every list: varint count, then one zigzag varint per time.
+// Times are stored in microseconds as the delta of the previous time in the same list, -1 for zones that weren't reached.
+// The database column is text, so the blob is stored as base64 behind KZ_RUN_METADATA_PREFIX.
+// Older rows contain JSON instead, which is still understood when decoding.
+
+#pragma once
+#include "common.h"
+#include "utlstring.h"
+
+#define KZ_RUN_METADATA_VERSION 1
+#define KZ_RUN_METADATA_PREFIX  '#'
+
+namespace KZ
+{
+	namespace timer
+	{
+		enum RunMetadataList : u8
+		{
+			METADATA_SPLITS = 0,
+			METADATA_CHECKPOINTS,
+			METADATA_STAGES,
+			METADATA_LIST_COUNT
+		};
+
+		struct ZoneTimeList
+		{
+			f64 *times;
+			u32 count;
+		};
+
+		CUtlString EncodeRunMetadata(const ZoneTimeList (&lists)[METADATA_LIST_COUNT]);
+		// Fill in at most count times of every list, times that aren't part of the metadata are left untouched.
+		// Doesn't use KeyValues3, so it is safe to call from any thread.
+		bool DecodeRunMetadata(const char *metadata, const ZoneTimeList (&lists)[METADATA_LIST_COUNT]);
+	} // namespace timer
+} // namespace KZ
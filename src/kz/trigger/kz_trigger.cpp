@@ -5,6 +5,8 @@
 #include "kz/mode/kz_mode.h"
 #include "kz/style/kz_style.h"
 #include "kz/timer/kz_timer.h"
+#include "trigger_broadphase.h"
+#include "trigger_table.h"
 
 void KZTriggerService::Reset()
 {
@@ -23,7 +25,7 @@ void KZTriggerService::OnPhysicsSimulate()
 	FOR_EACH_VEC(this->triggerTrackers, i)
 	{
 		CEntityHandle handle = this->triggerTrackers[i].triggerHandle;
-		CBaseTrigger *trigger = dynamic_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(handle));
+		CBaseTrigger *trigger = KZ::trigger::GetTrigger(handle);
 		// The trigger mysteriously disappeared...
 		if (!trigger)
 		{
@@ -118,14 +120,18 @@ void KZTriggerService::TouchTriggersAlongPath(const Vector &start, const Vector
 	{
 		return;
 	}
+	if (!KZ::trigger::MayTouchTriggers(start, end, bounds))
+	{
+		return;
+	}
 	CTraceFilterHitAllTriggers filter;
 	trace_t tr;
 	g_pKZUtils->TracePlayerBBox(start, end, bounds, &filter, tr);
 	FOR_EACH_VEC(filter.hitTriggerHandles, i)
 	{
 		CEntityHandle handle = filter.hitTriggerHandles[i];
-		CBaseTrigger *trigger = dynamic_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(handle));
-		if (!trigger || !V_strstr(trigger->GetClassname(), "trigger_"))
+		CBaseTrigger *trigger = KZ::trigger::GetTrigger(handle);
+		if (!trigger)
 		{
 			continue;
 		}
@@ -159,13 +165,17 @@ void KZTriggerService::UpdateTriggerTouchList()
 	bbox_t bounds;
 	this->player->GetBBoxBounds(&bounds);
 	CTraceFilterHitAllTriggers filter;
-	trace_t tr;
-	g_pKZUtils->TracePlayerBBox(origin, origin, bounds, &filter, tr);
+	// Far away from every trigger, the trace would come back empty anyway.
+	if (KZ::trigger::MayTouchTriggers(origin, origin, bounds))
+	{
+		trace_t tr;
+		g_pKZUtils->TracePlayerBBox(origin, origin, bounds, &filter, tr);
+	}
 
 	FOR_EACH_VEC_BACK(this->triggerTrackers, i)
 	{
 		CEntityHandle handle = this->triggerTrackers[i].triggerHandle;
-		CBaseTrigger *trigger = dynamic_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(handle));
+		CBaseTrigger *trigger = KZ::trigger::GetTrigger(handle);
 		// The trigger mysteriously disappeared...
 		if (!trigger)
 		{
@@ -190,8 +200,8 @@ void KZTriggerService::UpdateTriggerTouchList()
 	FOR_EACH_VEC(filter.hitTriggerHandles, i)
 	{
 		CEntityHandle handle = filter.hitTriggerHandles[i];
-		CBaseTrigger *trigger = dynamic_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(handle));
-		if (!trigger || !V_strstr(trigger->GetClassname(), "trigger_"))
+		CBaseTrigger *trigger = KZ::trigger::GetTrigger(handle);
+		if (!trigger)
 		{
 			continue;
 		}
@@ -214,7 +224,7 @@ void KZTriggerService::EndTouchAll()
 	FOR_EACH_VEC(this->triggerTrackers, i)
 	{
 		CEntityHandle handle = this->triggerTrackers[i].triggerHandle;
-		CBaseTrigger *trigger = dynamic_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(handle));
+		CBaseTrigger *trigger = KZ::trigger::GetTrigger(handle);
 		// The trigger mysteriously disappeared...
 		if (!trigger)
 		{
@@ -259,7 +269,7 @@ void KZTriggerService::TouchAll()
 	FOR_EACH_VEC(this->triggerTrackers, i)
 	{
 		CEntityHandle handle = this->triggerTrackers[i].triggerHandle;
-		CBaseTrigger *trigger = dynamic_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(handle));
+		CBaseTrigger *trigger = KZ::trigger::GetTrigger(handle);
 		// The trigger mysteriously disappeared...
 		if (!trigger)
 		{
@@ -285,12 +295,12 @@ bool KZTriggerService::IsManagedByTriggerService(CBaseEntity *toucher, CBaseEnti
 	{
 		return false;
 	}
-	if (V_stricmp(toucher->GetClassname(), "player") == 0 && V_strstr(touched->GetClassname(), "trigger_"))
+	if (KZ::trigger::GetTriggerInfo(touched->GetRefEHandle()) && V_stricmp(toucher->GetClassname(), "player") == 0)
 	{
 		player = g_pKZPlayerManager->ToPlayer(static_cast<CCSPlayerPawn *>(toucher));
 		trigger = static_cast<CBaseTrigger *>(touched);
 	}
-	if (V_stricmp(touched->GetClassname(), "player") == 0 && V_strstr(toucher->GetClassname(), "trigger_"))
+	if (KZ::trigger::GetTriggerInfo(toucher->GetRefEHandle()) && V_stricmp(touched->GetClassname(), "player") == 0)
 	{
 		player = g_pKZPlayerManager->ToPlayer(static_cast<CCSPlayerPawn *>(touched));
 		trigger = static_cast<CBaseTrigger *>(toucher);
@@ -353,10 +363,11 @@ void KZTriggerService::StartTouch(CBaseTrigger *trigger)
 		tracker = triggerTrackers.AddToTailGetPtr();
 		tracker->triggerHandle = trigger->GetRefEHandle();
 		tracker->startTouchTime = g_pKZUtils->GetServerGlobals()->curtime;
-		tracker->isPossibleLegacyBhopTrigger = V_stricmp(trigger->GetClassname(), "trigger_multiple") == 0
-												   ? KZTriggerService::IsPossibleLegacyBhopTrigger((CTriggerMultiple *)trigger)
-												   : false;
-		tracker->kzTrigger = KZ::mapapi::GetKzTrigger(trigger);
+		const KZ::trigger::TriggerInfo *info = KZ::trigger::GetTriggerInfo(tracker->triggerHandle);
+		// Checked on every new touch rather than at spawn, outputs added through AddOutput and filters set by inputs change it.
+		tracker->isPossibleLegacyBhopTrigger =
+			info && info->kind == KZ::trigger::TRIGGER_KIND_MULTIPLE && KZTriggerService::IsPossibleLegacyBhopTrigger((CTriggerMultiple *)trigger);
+		tracker->kzTrigger = info ? info->kzTrigger : nullptr;
 	}
 
 	// Handle changes in origin and velocity due to this event.
@@ -468,7 +479,7 @@ void KZTriggerService::UpdatePlayerPostTouch()
 	bool modifiedVelocity = this->preTouchVelocity != pawn->m_vecAbsVelocity();
 	if (player->processingMovement && modifiedVelocity)
 	{
-		player->SetVelocity(player->currentMoveData->m_vecVelocity - player->moveDataPre.m_vecVelocity + pawn->m_vecAbsVelocity());
+		player->SetVelocity(player->currentMoveData->m_vecVelocity - player->moveDataPre.velocity + pawn->m_vecAbsVelocity());
 		this->player->jumpstatsService->InvalidateJumpstats("Externally modified");
 	}
 
@@ -5,6 +5,7 @@
 #include "kz/mode/kz_mode.h"
 #include "kz/style/kz_style.h"
 #include "kz/timer/kz_timer.h"
+#include "trigger_table.h"
 
 void KZTriggerService::ResetBhopState()
 {
@@ -116,7 +117,7 @@ bool KZTriggerService::TouchTeleportTrigger(TriggerTouchTracker tracker)
 
 	Vector destOrigin = destination->m_CBodyComponent()->m_pSceneNode()->m_vecAbsOrigin();
 	QAngle destAngles = destination->m_CBodyComponent()->m_pSceneNode()->m_angRotation();
-	CBaseEntity *trigger = dynamic_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(tracker.kzTrigger->entity));
+	CBaseEntity *trigger = KZ::trigger::GetTrigger(tracker.kzTrigger->entity);
 	Vector triggerOrigin = Vector(0, 0, 0);
 	if (trigger)
 	{
@@ -0,0 +1,165 @@
+#include "trigger_broadphase.h"
+#include "trigger_bvh.h"
+#include "kz/kz.h"
+#include "sdk/entity/cbasetrigger.h"
+#include "utils/perf.h"
+
+#include "tier0/memdbgon.h"
+
+// Bounds are grown by this much so that the engine trace tolerance can never hit a trigger the broadphase missed.
+#define BROADPHASE_TOLERANCE 1.0f
+// Triggers that moved far make the refit hierarchy looser, it is rebuilt after this many refits.
+#define BROADPHASE_MAX_REFITS 64
+
+// Named trigger in the hierarchy, inputs can move it at any time.
+struct WatchedTrigger
+{
+	CEntityHandle handle;
+	i32 box;
+	// Transform the bounds in the hierarchy were computed from.
+	Vector origin;
+	QAngle rotation;
+	f32 scale;
+};
+
+static_global bool dirty = true;
+static_global KZ::trigger::BoxTree tree;
+// Parented triggers follow their parent and move all the time, they are tested against their current bounds on every query.
+static_global CUtlVector<CEntityHandle> movableTriggers;
+static_global CUtlVector<WatchedTrigger> watchedTriggers;
+// Tick the watched triggers were last compared with their cached transform on.
+static_global i32 lastWatchTick = -1;
+static_global i32 refitCount;
+
+static_function bool Overlaps(const Vector &minsA, const Vector &maxsA, const Vector &minsB, const Vector &maxsB)
+{
+	return minsA.x <= maxsB.x && maxsA.x >= minsB.x && minsA.y <= maxsB.y && maxsA.y >= minsB.y && minsA.z <= maxsB.z && maxsA.z >= minsB.z;
+}
+
+static_function void GetTriggerBounds(CBaseTrigger *trigger, Vector &mins, Vector &maxs)
+{
+	CGameSceneNode *node = trigger->m_CBodyComponent()->m_pSceneNode();
+	f32 scale = node->m_flAbsScale();
+	matrix3x4_t transform;
+	AngleMatrix(node->m_angAbsRotation(), node->m_vecAbsOrigin(), transform);
+	TransformAABB(transform, trigger->m_pCollision()->m_vecMins() * scale, trigger->m_pCollision()->m_vecMaxs() * scale, mins, maxs);
+	mins -= Vector(BROADPHASE_TOLERANCE, BROADPHASE_TOLERANCE, BROADPHASE_TOLERANCE);
+	maxs += Vector(BROADPHASE_TOLERANCE, BROADPHASE_TOLERANCE, BROADPHASE_TOLERANCE);
+}
+
+static_function void Rebuild()
+{
+	KZ_PROFILE(__func__);
+	tree.Clear();
+	movableTriggers.RemoveAll();
+	watchedTriggers.RemoveAll();
+	dirty = false;
+	refitCount = 0;
+	lastWatchTick = g_pKZUtils->GetServerGlobals()->tickcount;
+	if (!GameEntitySystem())
+	{
+		return;
+	}
+
+	for (CEntityIdentity *entID = GameEntitySystem()->m_EntityList.m_pFirstActiveEntity; entID != NULL; entID = entID->m_pNext)
+	{
+		CBaseTrigger *trigger = static_cast<CBaseTrigger *>(entID->m_pInstance);
+		if (!trigger || !V_strstr(trigger->GetClassname(), "trigger_") || !trigger->m_CBodyComponent()
+			|| !trigger->m_CBodyComponent()->m_pSceneNode())
+		{
+			continue;
+		}
+		CGameSceneNode *node = trigger->m_CBodyComponent()->m_pSceneNode();
+		if (node->m_pParent())
+		{
+			movableTriggers.AddToTail(trigger->GetRefEHandle());
+			continue;
+		}
+		Vector mins, maxs;
+		GetTriggerBounds(trigger, mins, maxs);
+		i32 box = tree.AddBox(mins, maxs);
+		// Named triggers can be moved or parented later through inputs, which nothing here sees.
+		const char *targetname = entID->m_name.String();
+		if (targetname && targetname[0])
+		{
+			watchedTriggers.AddToTail({trigger->GetRefEHandle(), box, node->m_vecAbsOrigin(), node->m_angAbsRotation(), node->m_flAbsScale()});
+		}
+	}
+	tree.Build();
+}
+
+// Refit the hierarchy around the named triggers that moved since the last check.
+static_function void CheckWatchedTriggers()
+{
+	bool moved = false;
+	FOR_EACH_VEC(watchedTriggers, i)
+	{
+		WatchedTrigger &watched = watchedTriggers[i];
+		CBaseTrigger *trigger = static_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(watched.handle));
+		CGameSceneNode *node = trigger ? trigger->m_CBodyComponent()->m_pSceneNode() : nullptr;
+		// Gone, or got parented and has to be tested on every query from now on.
+		if (!node || node->m_pParent())
+		{
+			Rebuild();
+			return;
+		}
+		if (node->m_vecAbsOrigin() == watched.origin && node->m_angAbsRotation() == watched.rotation && node->m_flAbsScale() == watched.scale)
+		{
+			continue;
+		}
+		watched.origin = node->m_vecAbsOrigin();
+		watched.rotation = node->m_angAbsRotation();
+		watched.scale = node->m_flAbsScale();
+		Vector mins, maxs;
+		GetTriggerBounds(trigger, mins, maxs);
+		tree.SetBox(watched.box, mins, maxs);
+		moved = true;
+	}
+	if (moved)
+	{
+		tree.Refit();
+		// Still correct as is, the rebuild happens on the next query.
+		dirty = ++refitCount >= BROADPHASE_MAX_REFITS;
+	}
+}
+
+void KZ::trigger::InvalidateBroadphase()
+{
+	dirty = true;
+}
+
+bool KZ::trigger::MayTouchTriggers(const Vector &start, const Vector &end, const bbox_t &bounds)
+{
+	if (dirty)
+	{
+		Rebuild();
+	}
+	else if (lastWatchTick != g_pKZUtils->GetServerGlobals()->tickcount)
+	{
+		lastWatchTick = g_pKZUtils->GetServerGlobals()->tickcount;
+		CheckWatchedTriggers();
+	}
+
+	Vector mins, maxs;
+	VectorMin(start, end, mins);
+	VectorMax(start, end, maxs);
+	mins += bounds.mins;
+	maxs += bounds.maxs;
+
+	FOR_EACH_VEC(movableTriggers, i)
+	{
+		CBaseTrigger *trigger = static_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(movableTriggers[i]));
+		if (!trigger)
+		{
+			continue;
+		}
+		Vector triggerMins, triggerMaxs;
+		GetTriggerBounds(trigger, triggerMins, triggerMaxs);
+		if (Overlaps(mins, maxs, triggerMins, triggerMaxs))
+		{
+			return true;
+		}
+	}
+
+	return tree.Overlaps(mins, maxs);
+}
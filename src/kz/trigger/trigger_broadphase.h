@@ -0,0 +1,27 @@
+#pragma once
+
+#include "common.h"
+#include "sdk/datatypes.h"
+
+/*
+	Broadphase for the trigger traces of TriggerFix.
+	Most of the time the player isn't anywhere near a trigger, yet every tick TouchTriggersAlongPath and UpdateTriggerTouchList
+	would run an engine trace against every trigger of the map. Triggers barely ever move, so the world space bounds of all triggers
+	are kept in a bounding volume hierarchy and the engine trace is only done if the swept hull overlaps one of them.
+
+	The hierarchy is rebuilt the first time it is used after a trigger spawned or got deleted, or after a round start.
+	Parented triggers (including those with a parentname, which are parented by the time they spawn) follow their parent and are
+	checked against their current bounds every time instead. Triggers with a targetname can be moved or parented by inputs at any
+	time, they stay in the hierarchy and their transform is compared once per tick, the hierarchy is refit around those that moved
+	and rebuilt after a number of refits.
+*/
+
+namespace KZ::trigger
+{
+	// Mark the hierarchy as outdated, it is rebuilt on the next query.
+	void InvalidateBroadphase();
+
+	// Whether a hull with these bounds moving from start to end might touch any trigger.
+	// False means the engine trace wouldn't hit a trigger either, true means it has to be done.
+	bool MayTouchTriggers(const Vector &start, const Vector &end, const bbox_t &bounds);
+} // namespace KZ::trigger
@@ -0,0 +1,146 @@
+#include "trigger_bvh.h"
+
+#include <algorithm>
+
+#include "tier0/memdbgon.h"
+
+// Leaves stop splitting at this many boxes, testing a few boxes is cheaper than descending further.
+#define BVH_LEAF_SIZE 4
+
+using namespace KZ::trigger;
+
+static_function bool BoxesOverlap(const Vector &minsA, const Vector &maxsA, const Vector &minsB, const Vector &maxsB)
+{
+	return minsA.x <= maxsB.x && maxsA.x >= minsB.x && minsA.y <= maxsB.y && maxsA.y >= minsB.y && minsA.z <= maxsB.z && maxsA.z >= minsB.z;
+}
+
+void BoxTree::Clear()
+{
+	this->nodes.RemoveAll();
+	this->boxes.RemoveAll();
+	this->boxIndices.RemoveAll();
+}
+
+i32 BoxTree::AddBox(const Vector &mins, const Vector &maxs)
+{
+	i32 id = this->boxes.Count();
+	this->boxes.AddToTail({mins, maxs, (mins + maxs) * 0.5f, id});
+	this->boxIndices.AddToTail(id);
+	return id;
+}
+
+// Top down build, every node is split at the median of the box centers along its longest axis.
+void BoxTree::BuildNode(i32 start, i32 count)
+{
+	i32 nodeIndex = this->nodes.AddToTail();
+	Vector mins = this->boxes[start].mins;
+	Vector maxs = this->boxes[start].maxs;
+	for (i32 i = start + 1; i < start + count; i++)
+	{
+		VectorMin(mins, this->boxes[i].mins, mins);
+		VectorMax(maxs, this->boxes[i].maxs, maxs);
+	}
+	this->nodes[nodeIndex].mins = mins;
+	this->nodes[nodeIndex].maxs = maxs;
+
+	if (count <= BVH_LEAF_SIZE)
+	{
+		this->nodes[nodeIndex].index = start;
+		this->nodes[nodeIndex].count = count;
+		return;
+	}
+
+	Vector size = maxs - mins;
+	i32 axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+	std::nth_element(this->boxes.Base() + start, this->boxes.Base() + start + count / 2, this->boxes.Base() + start + count,
+					 [axis](const Box &a, const Box &b) { return a.center[axis] < b.center[axis]; });
+
+	this->BuildNode(start, count / 2);
+	// Nodes can be reallocated by the recursion, don't hold on to a pointer.
+	this->nodes[nodeIndex].index = this->nodes.Count();
+	this->nodes[nodeIndex].count = 0;
+	this->BuildNode(start + count / 2, count - count / 2);
+}
+
+void BoxTree::Build()
+{
+	this->nodes.RemoveAll();
+	if (this->boxes.Count() == 0)
+	{
+		return;
+	}
+	this->BuildNode(0, this->boxes.Count());
+	FOR_EACH_VEC(this->boxes, i)
+	{
+		this->boxIndices[this->boxes[i].id] = i;
+	}
+}
+
+void BoxTree::SetBox(i32 id, const Vector &mins, const Vector &maxs)
+{
+	Box &box = this->boxes[this->boxIndices[id]];
+	box.mins = mins;
+	box.maxs = maxs;
+	box.center = (mins + maxs) * 0.5f;
+}
+
+// Children always come after their parent, so going backwards every node is refit after its children.
+// The split stays the same, a box that moved far makes the tree looser but never wrong.
+void BoxTree::Refit()
+{
+	FOR_EACH_VEC_BACK(this->nodes, i)
+	{
+		Node &node = this->nodes[i];
+		if (node.count == 0)
+		{
+			const Node &first = this->nodes[i + 1];
+			const Node &second = this->nodes[node.index];
+			VectorMin(first.mins, second.mins, node.mins);
+			VectorMax(first.maxs, second.maxs, node.maxs);
+			continue;
+		}
+		node.mins = this->boxes[node.index].mins;
+		node.maxs = this->boxes[node.index].maxs;
+		for (i32 j = node.index + 1; j < node.index + node.count; j++)
+		{
+			VectorMin(node.mins, this->boxes[j].mins, node.mins);
+			VectorMax(node.maxs, this->boxes[j].maxs, node.maxs);
+		}
+	}
+}
+
+bool BoxTree::Overlaps(const Vector &mins, const Vector &maxs) const
+{
+	if (this->nodes.Count() == 0)
+	{
+		return false;
+	}
+
+	// A balanced tree over the maximum number of entities is far less deep than this.
+	i32 stack[64];
+	i32 stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		i32 nodeIndex = stack[--stackSize];
+		const Node &node = this->nodes[nodeIndex];
+		if (!BoxesOverlap(mins, maxs, node.mins, node.maxs))
+		{
+			continue;
+		}
+		if (node.count == 0)
+		{
+			stack[stackSize++] = node.index;
+			stack[stackSize++] = nodeIndex + 1;
+			continue;
+		}
+		for (i32 i = node.index; i < node.index + node.count; i++)
+		{
+			if (BoxesOverlap(mins, maxs, this->boxes[i].mins, this->boxes[i].maxs))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "common.h"
+#include "mathlib/mathlib.h"
+
+/*
+	Bounding volume hierarchy over axis aligned boxes, used by the trigger broadphase. It doesn't know about entities, so the
+	queries can be compared with a brute force search over the same boxes outside of a running server, which
+	trigger_bvh_check.cpp does with random boxes.
+*/
+
+namespace KZ::trigger
+{
+	class BoxTree
+	{
+	public:
+		void Clear();
+
+		// Boxes are referred to by the order they were added in, Build reorders them internally.
+		i32 AddBox(const Vector &mins, const Vector &maxs);
+		void Build();
+
+		// Move a box without rebuilding the tree, the nodes above it only match again after Refit.
+		void SetBox(i32 id, const Vector &mins, const Vector &maxs);
+		void Refit();
+
+		// Whether any box overlaps the given bounds.
+		bool Overlaps(const Vector &mins, const Vector &maxs) const;
+
+		i32 GetBoxCount() const
+		{
+			return this->boxes.Count();
+		}
+
+	private:
+		struct Node
+		{
+			Vector mins;
+			Vector maxs;
+			// Inner nodes: index of the second child, the first child directly follows the node.
+			// Leaves: first index into the box list.
+			i32 index;
+			// Number of boxes for leaves, 0 for inner nodes.
+			i32 count;
+		};
+
+		struct Box
+		{
+			Vector mins;
+			Vector maxs;
+			Vector center;
+			i32 id;
+		};
+
+		void BuildNode(i32 start, i32 count);
+
+		CUtlVector<Node> nodes;
+		CUtlVector<Box> boxes;
+		// Position of every box in boxes, by the order they were added in.
+		CUtlVector<i32> boxIndices;
+	};
+} // namespace KZ::trigger
@@ -0,0 +1,203 @@
+// Compares the trigger broadphase hierarchy (trigger_bvh.h) with a brute force search over the same boxes. Random boxes are
+// queried with random swept hulls, then part of the boxes are moved the way named triggers are and the hierarchy is refit and
+// queried again, and finally built again. Prints every query the two disagree on and the cost per query of both, returns
+// non-zero on a mismatch.
+//
+//   cs2kz-check-trigger-bvh [-n boxes] [-q queries] [-s seed]
+//
+// The tool links tier0 like the plugin does, run it with the game's bin directory in the library path.
+
+#include "trigger_bvh.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tier0/memdbgon.h"
+
+#define CHECK_DEFAULT_BOXES   512
+#define CHECK_DEFAULT_QUERIES 100000
+#define CHECK_DEFAULT_SEED    0x2545F4914F6CDD1Dull
+// Roughly the size of a map, triggers and hulls are placed inside of it.
+#define CHECK_WORLD_SIZE      16384.0f
+#define CHECK_MAX_BOX_SIZE    1024.0f
+// Player hull plus how far it can move in a tick.
+#define CHECK_MAX_HULL_SIZE   72.0f
+#define CHECK_MAX_SWEEP       64.0f
+#define CHECK_MOVE_ROUNDS     8
+
+struct CheckBox
+{
+	Vector mins;
+	Vector maxs;
+};
+
+static_global u64 rngState;
+static_global i32 mismatches;
+
+// xorshift64, the same seed always gives the same boxes.
+static_function f32 NextRandom(f32 min, f32 max)
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 7;
+	rngState ^= rngState << 17;
+	return min + (max - min) * (f32)(rngState >> 40) / (f32)(1 << 24);
+}
+
+static_function Vector RandomPoint(f32 extent)
+{
+	return Vector(NextRandom(-extent, extent), NextRandom(-extent, extent), NextRandom(-extent, extent));
+}
+
+static_function CheckBox RandomBox()
+{
+	Vector center = RandomPoint(CHECK_WORLD_SIZE * 0.5f);
+	Vector size(NextRandom(1.0f, CHECK_MAX_BOX_SIZE), NextRandom(1.0f, CHECK_MAX_BOX_SIZE), NextRandom(1.0f, CHECK_MAX_BOX_SIZE));
+	return {center - size * 0.5f, center + size * 0.5f};
+}
+
+// Same bounds MayTouchTriggers queries with: the hull swept from start to end.
+static_function CheckBox RandomQuery()
+{
+	Vector start = RandomPoint(CHECK_WORLD_SIZE * 0.5f);
+	Vector end = start + RandomPoint(CHECK_MAX_SWEEP);
+	f32 halfWidth = NextRandom(1.0f, CHECK_MAX_HULL_SIZE) * 0.5f;
+	CheckBox query;
+	VectorMin(start, end, query.mins);
+	VectorMax(start, end, query.maxs);
+	query.mins -= Vector(halfWidth, halfWidth, 0.0f);
+	query.maxs += Vector(halfWidth, halfWidth, NextRandom(1.0f, CHECK_MAX_HULL_SIZE));
+	return query;
+}
+
+static_function bool BruteForce(const CUtlVector<CheckBox> &boxes, const CheckBox &query)
+{
+	FOR_EACH_VEC(boxes, i)
+	{
+		const CheckBox &box = boxes[i];
+		if (query.mins.x <= box.maxs.x && query.maxs.x >= box.mins.x && query.mins.y <= box.maxs.y && query.maxs.y >= box.mins.y
+			&& query.mins.z <= box.maxs.z && query.maxs.z >= box.mins.z)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Runs every query through both and reports the disagreements, returns how many of the queries hit a box.
+static_function i32 CompareQueries(const char *stage, const KZ::trigger::BoxTree &tree, const CUtlVector<CheckBox> &boxes,
+								   const CUtlVector<CheckBox> &queries, f64 &treeTime, f64 &bruteTime)
+{
+	CUtlVector<bool> treeResults;
+	treeResults.SetCount(queries.Count());
+	f64 start = Plat_FloatTime();
+	FOR_EACH_VEC(queries, i)
+	{
+		treeResults[i] = tree.Overlaps(queries[i].mins, queries[i].maxs);
+	}
+	treeTime += Plat_FloatTime() - start;
+
+	i32 hits = 0;
+	start = Plat_FloatTime();
+	FOR_EACH_VEC(queries, i)
+	{
+		bool hit = BruteForce(boxes, queries[i]);
+		hits += hit;
+		if (hit != treeResults[i])
+		{
+			const CheckBox &query = queries[i];
+			printf("  %s: query %i (%.1f %.1f %.1f) - (%.1f %.1f %.1f) brute force %i, hierarchy %i\n", stage, i, query.mins.x, query.mins.y,
+				   query.mins.z, query.maxs.x, query.maxs.y, query.maxs.z, hit, (i32)treeResults[i]);
+			mismatches++;
+		}
+	}
+	bruteTime += Plat_FloatTime() - start;
+	return hits;
+}
+
+int main(int argc, char *argv[])
+{
+	i32 boxCount = CHECK_DEFAULT_BOXES;
+	i32 queryCount = CHECK_DEFAULT_QUERIES;
+	rngState = CHECK_DEFAULT_SEED;
+	for (i32 i = 1; i < argc; i++)
+	{
+		if (i + 1 >= argc)
+		{
+			printf("Usage: %s [-n boxes] [-q queries] [-s seed]\n", argv[0]);
+			return 1;
+		}
+		if (KZ_STREQ(argv[i], "-n"))
+		{
+			boxCount = V_StringToInt32(argv[++i], CHECK_DEFAULT_BOXES);
+			boxCount = MAX(boxCount, 0);
+		}
+		else if (KZ_STREQ(argv[i], "-q"))
+		{
+			queryCount = V_StringToInt32(argv[++i], CHECK_DEFAULT_QUERIES);
+			queryCount = MAX(queryCount, 1);
+		}
+		else if (KZ_STREQ(argv[i], "-s"))
+		{
+			rngState = strtoull(argv[++i], nullptr, 0);
+			// xorshift never leaves 0.
+			if (rngState == 0)
+			{
+				rngState = CHECK_DEFAULT_SEED;
+			}
+		}
+		else
+		{
+			printf("Usage: %s [-n boxes] [-q queries] [-s seed]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	CUtlVector<CheckBox> boxes;
+	KZ::trigger::BoxTree tree;
+	for (i32 i = 0; i < boxCount; i++)
+	{
+		CheckBox box = RandomBox();
+		boxes.AddToTail(box);
+		tree.AddBox(box.mins, box.maxs);
+	}
+	tree.Build();
+
+	CUtlVector<CheckBox> queries;
+	for (i32 i = 0; i < queryCount; i++)
+	{
+		queries.AddToTail(RandomQuery());
+	}
+
+	f64 builtTime = 0;
+	f64 bruteTime = 0;
+	i32 hits = CompareQueries("built", tree, boxes, queries, builtTime, bruteTime);
+
+	// Move every fourth box somewhere else entirely, like a named trigger teleported by an input, then refit.
+	// Boxes that moved far make the tree looser, this is why the broadphase rebuilds after a number of refits.
+	f64 refitTime = 0;
+	f64 refitBruteTime = 0;
+	for (i32 round = 0; round < CHECK_MOVE_ROUNDS; round++)
+	{
+		for (i32 i = round % 4; i < boxes.Count(); i += 4)
+		{
+			boxes[i] = RandomBox();
+			tree.SetBox(i, boxes[i].mins, boxes[i].maxs);
+		}
+		tree.Refit();
+		hits += CompareQueries("refit", tree, boxes, queries, refitTime, refitBruteTime);
+	}
+
+	// Building again keeps the ids of the moved boxes.
+	tree.Build();
+	hits += CompareQueries("rebuilt", tree, boxes, queries, builtTime, bruteTime);
+	bruteTime += refitBruteTime;
+
+	u64 builtQueries = (u64)queryCount * 2;
+	u64 refitQueries = (u64)queryCount * CHECK_MOVE_ROUNDS;
+	printf("%i boxes, %llu queries, %i hits\n", boxCount, (unsigned long long)(builtQueries + refitQueries), hits);
+	printf("  Built hierarchy: %.1f ns/query\n", builtTime * 1e9 / builtQueries);
+	printf("  Refit hierarchy: %.1f ns/query\n", refitTime * 1e9 / refitQueries);
+	printf("  Brute force:     %.1f ns/query\n", bruteTime * 1e9 / (builtQueries + refitQueries));
+	printf("%i mismatches\n", mismatches);
+	return mismatches > 0 ? 1 : 0;
+}
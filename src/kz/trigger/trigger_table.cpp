@@ -0,0 +1,85 @@
+#include "trigger_table.h"
+#include "kz_trigger.h"
+#include "sdk/entity/cbasetrigger.h"
+
+#include "tier0/memdbgon.h"
+
+static_global KZ::trigger::TriggerInfo triggerTable[KZ_TRIGGER_TABLE_SIZE];
+
+static_function KZ::trigger::TriggerInfo *GetEntry(CEntityHandle handle)
+{
+	if (!handle.IsValid() || handle.GetEntryIndex() >= KZ_TRIGGER_TABLE_SIZE)
+	{
+		return nullptr;
+	}
+	return &triggerTable[handle.GetEntryIndex()];
+}
+
+void KZ::trigger::OnTriggerSpawned(CBaseTrigger *trigger)
+{
+	CEntityHandle handle = trigger->GetRefEHandle();
+	TriggerInfo *info = GetEntry(handle);
+	if (!info)
+	{
+		return;
+	}
+	// The Mapping API might have registered this trigger already.
+	if (info->handle != handle)
+	{
+		*info = {};
+		info->handle = handle;
+	}
+	info->kind = KZ_STREQI(trigger->GetClassname(), "trigger_multiple") ? TRIGGER_KIND_MULTIPLE : TRIGGER_KIND_OTHER;
+}
+
+void KZ::trigger::OnTriggerDeleted(CBaseTrigger *trigger)
+{
+	CEntityHandle handle = trigger->GetRefEHandle();
+	TriggerInfo *info = GetEntry(handle);
+	if (info && info->handle == handle)
+	{
+		*info = {};
+	}
+}
+
+void KZ::trigger::SetKzTrigger(CEntityHandle handle, const KzTrigger *kzTrigger)
+{
+	TriggerInfo *info = GetEntry(handle);
+	if (!info)
+	{
+		return;
+	}
+	if (info->handle != handle)
+	{
+		*info = {};
+		info->handle = handle;
+	}
+	info->kzTrigger = kzTrigger;
+}
+
+void KZ::trigger::ClearKzTriggers()
+{
+	for (u32 i = 0; i < KZ_TRIGGER_TABLE_SIZE; i++)
+	{
+		triggerTable[i].kzTrigger = nullptr;
+	}
+}
+
+const KZ::trigger::TriggerInfo *KZ::trigger::GetTriggerInfo(CEntityHandle handle)
+{
+	TriggerInfo *info = GetEntry(handle);
+	if (!info || info->handle != handle || info->kind == TRIGGER_KIND_NONE)
+	{
+		return nullptr;
+	}
+	return info;
+}
+
+CBaseTrigger *KZ::trigger::GetTrigger(CEntityHandle handle)
+{
+	if (!GetTriggerInfo(handle))
+	{
+		return nullptr;
+	}
+	return static_cast<CBaseTrigger *>(GameEntitySystem()->GetEntityInstance(handle));
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "common.h"
+#include "sdk/datatypes.h"
+
+/*
+	Per entity index classification of triggers, so that the touch code doesn't have to dynamic_cast and compare classnames
+	for every trigger the player is near every tick.
+	Entries are filled when a trigger spawns (or when entities are hooked on round prestart) and cleared when it is deleted.
+	The Mapping API trigger is attached by the Mapping API itself as it registers triggers.
+	Whether a trigger_multiple is a legacy bhop trigger isn't cached, its outputs and filter can change after it spawns.
+*/
+
+#define KZ_TRIGGER_TABLE_SIZE (1 << 15)
+
+class CBaseTrigger;
+struct KzTrigger;
+
+namespace KZ::trigger
+{
+	enum TriggerKind : u8
+	{
+		TRIGGER_KIND_NONE = 0,
+		TRIGGER_KIND_OTHER,
+		TRIGGER_KIND_MULTIPLE,
+	};
+
+	struct TriggerInfo
+	{
+		// Entries are only valid for the entity they were filled for, the serial number in the handle tells them apart.
+		CEntityHandle handle;
+		TriggerKind kind;
+		const KzTrigger *kzTrigger;
+	};
+
+	void OnTriggerSpawned(CBaseTrigger *trigger);
+	void OnTriggerDeleted(CBaseTrigger *trigger);
+
+	void SetKzTrigger(CEntityHandle handle, const KzTrigger *kzTrigger);
+	// Mapping API triggers are gone, drop the pointers to them.
+	void ClearKzTriggers();
+
+	// Returns nullptr if the entity isn't a trigger.
+	const TriggerInfo *GetTriggerInfo(CEntityHandle handle);
+
+	// Returns nullptr if the entity doesn't exist anymore or isn't a trigger.
+	CBaseTrigger *GetTrigger(CEntityHandle handle);
+} // namespace KZ::trigger
@@ -9,6 +9,7 @@ class CCSPlayer_MovementServices;
 
 #include "sdk/datatypes.h"
 #include "sdk/services.h"
+#include "mv_snapshot.h"
 // TODO: better error sound
 #define MV_SND_ERROR "Buttons.snd8"
 
@@ -265,8 +266,8 @@ public:
 	// General
 	bool processingMovement {};
 	CMoveData *currentMoveData {};
-	CMoveData moveDataPre;
-	CMoveData moveDataPost;
+	MoveDataSnapshot moveDataPre {};
+	MoveDataSnapshot moveDataPost {};
 	QAngle oldAngles;
 
 	bool processingDuck {};
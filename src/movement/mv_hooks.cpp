@@ -5,7 +5,7 @@
 #include "utils/gameconfig.h"
 #include "tier0/memdbgon.h"
 #include "sdk/usercmd.h"
-#include "vprof.h"
+#include "utils/perf.h"
 #ifdef DEBUG_TPM
 #include "fmtstr.h"
 
@@ -47,7 +47,7 @@ MovementPlayerManager *playerManager = static_cast<MovementPlayerManager *>(g_pP
 
 void FASTCALL movement::Detour_PhysicsSimulate(CCSPlayerController *controller)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	if (controller->m_bIsHLTV)
 	{
 		return;
@@ -62,7 +62,7 @@ void FASTCALL movement::Detour_PhysicsSimulate(CCSPlayerController *controller)
 
 f32 FASTCALL movement::Detour_GetMaxSpeed(CCSPlayerPawn *pawn)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(pawn);
 	f32 maxSpeed = GetMaxSpeed(pawn);
 	f32 newMaxSpeed = maxSpeed;
@@ -76,7 +76,7 @@ f32 FASTCALL movement::Detour_GetMaxSpeed(CCSPlayerPawn *pawn)
 
 i32 FASTCALL movement::Detour_ProcessUsercmds(CCSPlayerController *controller, void *cmds, int numcmds, bool paused, float margin)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(controller);
 	player->OnProcessUsercmds(cmds, numcmds);
 	auto retValue = ProcessUsercmds(controller, cmds, numcmds, paused, margin);
@@ -87,7 +87,7 @@ i32 FASTCALL movement::Detour_ProcessUsercmds(CCSPlayerController *controller, v
 
 void FASTCALL movement::Detour_SetupMove(CCSPlayer_MovementServices *ms, PlayerCommand *pc, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	CBasePlayerController *controller = player->GetController();
 	player->OnSetupMove(pc);
@@ -97,19 +97,19 @@ void FASTCALL movement::Detour_SetupMove(CCSPlayer_MovementServices *ms, PlayerC
 
 void FASTCALL movement::Detour_ProcessMovement(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->currentMoveData = mv;
-	player->moveDataPre = CMoveData(*mv);
+	player->moveDataPre.Capture(*mv);
 	player->OnProcessMovement();
 	ProcessMovement(ms, mv);
-	player->moveDataPost = CMoveData(*mv);
+	player->moveDataPost.Capture(*mv);
 	player->OnProcessMovementPost();
 }
 
 bool FASTCALL movement::Detour_PlayerMove(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnPlayerMove();
 	auto retValue = PlayerMove(ms, mv);
@@ -119,7 +119,7 @@ bool FASTCALL movement::Detour_PlayerMove(CCSPlayer_MovementServices *ms, CMoveD
 
 void FASTCALL movement::Detour_CheckParameters(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnCheckParameters();
 	CheckParameters(ms, mv);
@@ -128,7 +128,7 @@ void FASTCALL movement::Detour_CheckParameters(CCSPlayer_MovementServices *ms, C
 
 bool FASTCALL movement::Detour_CanMove(CCSPlayerPawnBase *pawn)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(pawn);
 	player->OnCanMove();
 	auto retValue = CanMove(pawn);
@@ -138,7 +138,7 @@ bool FASTCALL movement::Detour_CanMove(CCSPlayerPawnBase *pawn)
 
 void FASTCALL movement::Detour_FullWalkMove(CCSPlayer_MovementServices *ms, CMoveData *mv, bool ground)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnFullWalkMove(ground);
 	FullWalkMove(ms, mv, ground);
@@ -147,7 +147,7 @@ void FASTCALL movement::Detour_FullWalkMove(CCSPlayer_MovementServices *ms, CMov
 
 bool FASTCALL movement::Detour_MoveInit(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnMoveInit();
 	auto retValue = MoveInit(ms, mv);
@@ -157,7 +157,7 @@ bool FASTCALL movement::Detour_MoveInit(CCSPlayer_MovementServices *ms, CMoveDat
 
 bool FASTCALL movement::Detour_CheckWater(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnCheckWater();
 	auto retValue = CheckWater(ms, mv);
@@ -168,7 +168,7 @@ bool FASTCALL movement::Detour_CheckWater(CCSPlayer_MovementServices *ms, CMoveD
 
 void FASTCALL movement::Detour_WaterMove(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnWaterMove();
 #ifdef WATER_FIX
@@ -183,7 +183,7 @@ void FASTCALL movement::Detour_WaterMove(CCSPlayer_MovementServices *ms, CMoveDa
 
 void FASTCALL movement::Detour_CheckVelocity(CCSPlayer_MovementServices *ms, CMoveData *mv, const char *a3)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnCheckVelocity(a3);
 	CheckVelocity(ms, mv, a3);
@@ -192,7 +192,7 @@ void FASTCALL movement::Detour_CheckVelocity(CCSPlayer_MovementServices *ms, CMo
 
 void FASTCALL movement::Detour_Duck(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnDuck();
 	player->processingDuck = true;
@@ -203,7 +203,7 @@ void FASTCALL movement::Detour_Duck(CCSPlayer_MovementServices *ms, CMoveData *m
 
 bool FASTCALL movement::Detour_CanUnduck(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnCanUnduck();
 	bool canUnduck = CanUnduck(ms, mv);
@@ -213,7 +213,7 @@ bool FASTCALL movement::Detour_CanUnduck(CCSPlayer_MovementServices *ms, CMoveDa
 
 bool FASTCALL movement::Detour_LadderMove(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnLadderMove();
 	Vector oldVelocity = mv->m_vecVelocity;
@@ -256,7 +256,7 @@ bool FASTCALL movement::Detour_LadderMove(CCSPlayer_MovementServices *ms, CMoveD
 
 void FASTCALL movement::Detour_CheckJumpButton(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 #ifdef WATER_FIX
 	if (player->enableWaterFix && ms->pawn->m_MoveType() == MOVETYPE_WALK && ms->pawn->m_flWaterLevel() > 0.5f && ms->pawn->m_fFlags & FL_ONGROUND)
@@ -274,7 +274,7 @@ void FASTCALL movement::Detour_CheckJumpButton(CCSPlayer_MovementServices *ms, C
 
 void FASTCALL movement::Detour_OnJump(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnJump();
 	Vector oldOutWishVel = mv->m_outWishVel;
@@ -291,7 +291,7 @@ void FASTCALL movement::Detour_OnJump(CCSPlayer_MovementServices *ms, CMoveData
 
 void FASTCALL movement::Detour_AirMove(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnAirMove();
 	AirMove(ms, mv);
@@ -300,7 +300,7 @@ void FASTCALL movement::Detour_AirMove(CCSPlayer_MovementServices *ms, CMoveData
 
 void FASTCALL movement::Detour_Friction(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnFriction();
 	Friction(ms, mv);
@@ -309,7 +309,7 @@ void FASTCALL movement::Detour_Friction(CCSPlayer_MovementServices *ms, CMoveDat
 
 void FASTCALL movement::Detour_WalkMove(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnWalkMove();
 	WalkMove(ms, mv);
@@ -319,7 +319,7 @@ void FASTCALL movement::Detour_WalkMove(CCSPlayer_MovementServices *ms, CMoveDat
 
 void FASTCALL movement::Detour_TryPlayerMove(CCSPlayer_MovementServices *ms, CMoveData *mv, Vector *pFirstDest, trace_t *pFirstTrace)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 #ifdef DEBUG_TPM
 	traceHistory.RemoveAll();
@@ -393,7 +393,7 @@ void FASTCALL movement::Detour_TryPlayerMove(CCSPlayer_MovementServices *ms, CMo
 
 void FASTCALL movement::Detour_CategorizePosition(CCSPlayer_MovementServices *ms, CMoveData *mv, bool bStayOnGround)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 #ifdef WATER_FIX
 	if (player->enableWaterFix && player->ignoreNextCategorizePosition)
@@ -428,7 +428,7 @@ void FASTCALL movement::Detour_CategorizePosition(CCSPlayer_MovementServices *ms
 
 void FASTCALL movement::Detour_CheckFalling(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnCheckFalling();
 	CheckFalling(ms, mv);
@@ -437,7 +437,7 @@ void FASTCALL movement::Detour_CheckFalling(CCSPlayer_MovementServices *ms, CMov
 
 void FASTCALL movement::Detour_PostPlayerMove(CCSPlayer_MovementServices *ms, CMoveData *mv)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(ms);
 	player->OnPostPlayerMove();
 	PostPlayerMove(ms, mv);
@@ -446,7 +446,7 @@ void FASTCALL movement::Detour_PostPlayerMove(CCSPlayer_MovementServices *ms, CM
 
 void FASTCALL movement::Detour_PostThink(CCSPlayerPawnBase *pawn)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	MovementPlayer *player = playerManager->ToPlayer(pawn);
 	player->OnPostThink();
 	PostThink(pawn);
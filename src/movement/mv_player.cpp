@@ -37,7 +37,7 @@ void MovementPlayer::OnProcessMovementPost()
 	this->processingMovement = false;
 	if (g_pKZUtils->GetGlobals()->frametime > 0.0f)
 	{
-		this->oldAngles = this->moveDataPost.m_vecViewAngles;
+		this->oldAngles = this->moveDataPost.viewAngles;
 	}
 	this->oldWalkMoved = this->walkMoved;
 	this->previousOnGround = this->GetPlayerPawn()->m_fFlags() & FL_ONGROUND;
@@ -142,7 +142,7 @@ void MovementPlayer::GetAngles(QAngle *angles)
 	}
 	else
 	{
-		*angles = this->moveDataPost.m_vecViewAngles;
+		*angles = this->moveDataPost.viewAngles;
 	}
 }
 
@@ -171,7 +171,7 @@ TurnState MovementPlayer::GetTurning()
 	}
 	else
 	{
-		currentAngle = this->moveDataPre.m_vecViewAngles;
+		currentAngle = this->moveDataPre.viewAngles;
 	}
 	bool turning = this->oldAngles.y != currentAngle.y;
 	if (!turning)
@@ -197,18 +197,15 @@ bool MovementPlayer::IsButtonPressed(InputBitMask_t button, bool onlyDown)
 
 f32 MovementPlayer::GetGroundPosition()
 {
-	CMoveData *mv = this->currentMoveData;
-	if (!this->processingMovement)
-	{
-		mv = &this->moveDataPost;
-	}
+	// Read straight from the move being processed, moveDataPost holds the last processed move otherwise.
+	const Vector &origin = this->processingMovement ? this->currentMoveData->m_vecAbsOrigin : this->moveDataPost.absOrigin;
 
 	CTraceFilterPlayerMovementCS filter;
 	g_pKZUtils->InitPlayerMovementTraceFilter(filter, this->GetPlayerPawn(),
 											  this->GetPlayerPawn()->m_Collision().m_collisionAttribute().m_nInteractsWith(),
 											  COLLISION_GROUP_PLAYER_MOVEMENT);
 
-	Vector ground = mv->m_vecAbsOrigin;
+	Vector ground = origin;
 	ground.z -= 2;
 
 	f32 standableZ = 0.7;
@@ -239,12 +236,12 @@ f32 MovementPlayer::GetGroundPosition()
 	trace_t trace;
 	g_pKZUtils->InitGameTrace(&trace);
 
-	g_pKZUtils->TracePlayerBBox(mv->m_vecAbsOrigin, ground, bounds, &filter, trace);
+	g_pKZUtils->TracePlayerBBox(origin, ground, bounds, &filter, trace);
 
 	// Doesn't hit anything, fall back to the original ground
 	if (trace.m_bStartInSolid || trace.m_flFraction == 1.0f)
 	{
-		return mv->m_vecAbsOrigin.z;
+		return origin.z;
 	}
 
 	return trace.m_vEndPos.z;
@@ -252,22 +249,19 @@ f32 MovementPlayer::GetGroundPosition()
 
 void MovementPlayer::RegisterTakeoff(bool jumped, bool fromLadder, Vector *overrideOrigin)
 {
-	CMoveData *mv = this->currentMoveData;
-	if (!this->processingMovement)
-	{
-		mv = &this->moveDataPost;
-	}
+	const Vector &origin = this->processingMovement ? this->currentMoveData->m_vecAbsOrigin : this->moveDataPost.absOrigin;
+	const Vector &velocity = this->processingMovement ? this->currentMoveData->m_vecVelocity : this->moveDataPost.velocity;
 	this->takeoffFromLadder = fromLadder;
-	this->takeoffOrigin = overrideOrigin ? *overrideOrigin : mv->m_vecAbsOrigin;
+	this->takeoffOrigin = overrideOrigin ? *overrideOrigin : origin;
 	this->takeoffTime = g_pKZUtils->GetGlobals()->curtime - g_pKZUtils->GetGlobals()->frametime;
-	this->takeoffVelocity = mv->m_vecVelocity;
+	this->takeoffVelocity = velocity;
 	if (overrideOrigin)
 	{
 		this->takeoffGroundOrigin = *overrideOrigin;
 	}
 	else
 	{
-		this->takeoffGroundOrigin = mv->m_vecAbsOrigin;
+		this->takeoffGroundOrigin = origin;
 		this->takeoffGroundOrigin.z = this->GetGroundPosition();
 	}
 	this->inRealPerf = this->inPerf;
@@ -276,15 +270,11 @@ void MovementPlayer::RegisterTakeoff(bool jumped, bool fromLadder, Vector *overr
 
 void MovementPlayer::RegisterLanding(const Vector &landingVelocity, bool distbugFix)
 {
-	CMoveData *mv = this->currentMoveData;
-	if (!this->processingMovement)
-	{
-		mv = &this->moveDataPost;
-	}
+	const Vector &origin = this->processingMovement ? this->currentMoveData->m_vecAbsOrigin : this->moveDataPost.absOrigin;
 	this->duckBugged = this->processingDuck;
 	this->inPerf = false;
 	this->inRealPerf = false;
-	this->landingOrigin = mv->m_vecAbsOrigin;
+	this->landingOrigin = origin;
 	this->landingTime = g_pKZUtils->GetGlobals()->curtime;
 	this->landingTimeServer = g_pKZUtils->GetServerGlobals()->curtime;
 	this->landingVelocity = landingVelocity;
@@ -294,7 +284,10 @@ void MovementPlayer::RegisterLanding(const Vector &landingVelocity, bool distbug
 		this->landingTimeActual = this->landingTime;
 	}
 	// Distbug shenanigans
-	if (mv->m_TouchList.Count() > 0) // bugged
+	// Touches are read straight from the move being processed. Outside of ProcessMovement the copy of the move data never had
+	// usable traces, so the landing falls through to the reverse bugged case below like it always did.
+	CUtlVector<touchlist_t> *touchList = this->processingMovement ? &this->currentMoveData->m_TouchList : nullptr;
+	if (touchList && touchList->Count() > 0) // bugged
 	{
 		// The true landing origin from TryPlayerMove, use this whenever you can
 		f32 normal = 0.7;
@@ -313,23 +306,23 @@ void MovementPlayer::RegisterLanding(const Vector &landingVelocity, bool distbug
 			normal = reinterpret_cast<CVValue_t *>(&sv_walkable_normal->values)->m_flValue;
 		}
 
-		FOR_EACH_VEC(mv->m_TouchList, i)
+		FOR_EACH_VEC(*touchList, i)
 		{
-			if (mv->m_TouchList[i].trace.m_vHitNormal.z > normal)
+			if ((*touchList)[i].trace.m_vHitNormal.z > normal)
 			{
-				this->landingOriginActual = mv->m_TouchList[i].trace.m_vEndPos;
+				this->landingOriginActual = (*touchList)[i].trace.m_vEndPos;
 				this->landingTimeActual =
 					this->landingTime
-					- (1 - mv->m_TouchList[i].trace.m_flFraction) * g_pKZUtils->GetGlobals()->frametime; // TODO: make sure this is right
+					- (1 - (*touchList)[i].trace.m_flFraction) * g_pKZUtils->GetGlobals()->frametime; // TODO: make sure this is right
 				return;
 			}
 		}
 	}
 	// reverse bugged
-	f32 diffZ = mv->m_vecAbsOrigin.z - this->GetGroundPosition();
+	f32 diffZ = origin.z - this->GetGroundPosition();
 	if (diffZ <= 0) // Ledgegrabbed, just use the current origin.
 	{
-		this->landingOriginActual = mv->m_vecAbsOrigin;
+		this->landingOriginActual = origin;
 		this->landingTimeActual = this->landingTime;
 	}
 	else
@@ -353,7 +346,7 @@ void MovementPlayer::RegisterLanding(const Vector &landingVelocity, bool distbug
 		// basic x + vt + (0.5a)t^2 = 0;
 		const f64 delta = landingVelocity.z * landingVelocity.z - 2 * gravity.z * diffZ;
 		const f64 time = (-landingVelocity.z - sqrt(delta)) / (gravity.z);
-		this->landingOriginActual = mv->m_vecAbsOrigin + landingVelocity * time + 0.5 * gravity * time * time;
+		this->landingOriginActual = origin + landingVelocity * time + 0.5 * gravity * time * time;
 		this->landingTimeActual = this->landingTime + time;
 	}
 }
@@ -0,0 +1,29 @@
+#pragma once
+#include "common.h"
+#include "sdk/datatypes.h"
+
+// The parts of CMoveData read by the KZ services before and after ProcessMovement.
+// Copying the whole CMoveData copies three CUtlVectors every tick, this is a plain copy of a few vectors instead.
+struct MoveDataSnapshot
+{
+	QAngle viewAngles;
+	Vector velocity;
+	Vector absOrigin;
+	f32 forwardMove;
+	f32 sideMove;
+	f32 upMove;
+	f32 maxSpeed;
+	bool inAir;
+
+	void Capture(const CMoveData &mv)
+	{
+		this->viewAngles = mv.m_vecViewAngles;
+		this->velocity = mv.m_vecVelocity;
+		this->absOrigin = mv.m_vecAbsOrigin;
+		this->forwardMove = mv.m_flForwardMove;
+		this->sideMove = mv.m_flSideMove;
+		this->upMove = mv.m_flUpMove;
+		this->maxSpeed = mv.m_flMaxSpeed;
+		this->inAir = mv.m_bInAir;
+	}
+};
@@ -0,0 +1,117 @@
+// Compares the two copies Detour_ProcessMovement makes of the move data every tick: the full CMoveData copy it used to make
+// and the MoveDataSnapshot it makes now. The move data is filled with as many subtick moves, attack subtick moves and touches
+// as given, a regular tick has a few of each.
+//
+//   cs2kz-bench-movedata [-n iterations] [-s subtick moves] [-t touches]
+//
+// The tool links tier0 like the plugin does, run it with the game's bin directory in the library path.
+
+#include "mv_snapshot.h"
+
+#include <stdio.h>
+
+#include "tier0/memdbgon.h"
+
+#define BENCH_DEFAULT_ITERATIONS 1000000
+#define BENCH_DEFAULT_SUBTICKS   4
+#define BENCH_DEFAULT_TOUCHES    2
+
+static_function void FillMoveData(CMoveData &mv, i32 subtickCount, i32 touchCount)
+{
+	mv.m_bFirstRunOfFunctions = true;
+	mv.m_bIsLateCommand = false;
+	mv.m_bHasNextCommand = false;
+	mv.m_vecViewAngles = {10.0f, 90.0f, 0.0f};
+	mv.m_vecAbsViewAngles = mv.m_vecViewAngles;
+	mv.m_vecVelocity = {250.0f, 10.0f, -20.0f};
+	mv.m_vecAbsOrigin = {1024.0f, -512.0f, 64.0f};
+	mv.m_flForwardMove = 1.0f;
+	mv.m_flSideMove = -1.0f;
+	mv.m_flUpMove = 0.0f;
+	mv.m_flMaxSpeed = 250.0f;
+	mv.m_bInAir = true;
+	mv.m_bHasSubtickInputs = subtickCount > 0;
+	for (i32 i = 0; i < subtickCount; i++)
+	{
+		SubtickMove move {};
+		move.when = (f32)(i + 1) / (subtickCount + 1);
+		move.button = IN_JUMP;
+		move.pressed = i % 2 == 0;
+		mv.m_SubtickMoves.AddToTail(move);
+		mv.m_AttackSubtickMoves.AddToTail(move);
+	}
+	for (i32 i = 0; i < touchCount; i++)
+	{
+		touchlist_t *touch = mv.m_TouchList.AddToTailGetPtr();
+		touch->deltavelocity = {0.0f, 0.0f, 20.0f};
+		touch->trace.m_vEndPos = mv.m_vecAbsOrigin;
+		touch->trace.m_vHitNormal = {0.0f, 0.0f, 1.0f};
+		touch->trace.m_flFraction = 0.5f;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	i32 iterations = BENCH_DEFAULT_ITERATIONS;
+	i32 subtickCount = BENCH_DEFAULT_SUBTICKS;
+	i32 touchCount = BENCH_DEFAULT_TOUCHES;
+	for (i32 i = 1; i < argc; i++)
+	{
+		if (i + 1 >= argc)
+		{
+			printf("Usage: %s [-n iterations] [-s subtick moves] [-t touches]\n", argv[0]);
+			return 1;
+		}
+		if (KZ_STREQ(argv[i], "-n"))
+		{
+			iterations = V_StringToInt32(argv[++i], BENCH_DEFAULT_ITERATIONS);
+			iterations = MAX(iterations, 1);
+		}
+		else if (KZ_STREQ(argv[i], "-s"))
+		{
+			subtickCount = V_StringToInt32(argv[++i], BENCH_DEFAULT_SUBTICKS);
+			subtickCount = MAX(subtickCount, 0);
+		}
+		else if (KZ_STREQ(argv[i], "-t"))
+		{
+			touchCount = V_StringToInt32(argv[++i], BENCH_DEFAULT_TOUCHES);
+			touchCount = MAX(touchCount, 0);
+		}
+		else
+		{
+			printf("Usage: %s [-n iterations] [-s subtick moves] [-t touches]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	CMoveData mv;
+	FillMoveData(mv, subtickCount, touchCount);
+
+	// Sum up something out of every copy so they can't be optimized out.
+	f64 copySum = 0;
+	f64 start = Plat_FloatTime();
+	for (i32 i = 0; i < iterations; i++)
+	{
+		mv.m_vecVelocity.x += 1.0f;
+		CMoveData copy(mv);
+		copySum += copy.m_vecVelocity.x + copy.m_SubtickMoves.Count() + copy.m_TouchList.Count();
+	}
+	f64 copyTime = Plat_FloatTime() - start;
+
+	f64 snapshotSum = 0;
+	MoveDataSnapshot snapshot;
+	start = Plat_FloatTime();
+	for (i32 i = 0; i < iterations; i++)
+	{
+		mv.m_vecVelocity.x += 1.0f;
+		snapshot.Capture(mv);
+		snapshotSum += snapshot.velocity.x;
+	}
+	f64 snapshotTime = Plat_FloatTime() - start;
+
+	printf("%i copies (%i subtick moves, %i touches)\n", iterations, subtickCount, touchCount);
+	printf("  CMoveData copy:            %.1f ns/copy\n", copyTime * 1e9 / iterations);
+	printf("  MoveDataSnapshot::Capture: %.1f ns/copy\n", snapshotTime * 1e9 / iterations);
+	printf("  (checksums %.0f %.0f)\n", copySum, snapshotSum);
+	return 0;
+}
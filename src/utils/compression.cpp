@@ -0,0 +1,191 @@
+#include "compression.h"
+
+#include "tier0/memdbgon.h"
+
+#define MIN_MATCH      4
+// The last 5 bytes are always literals, and the last match must start at least 12 bytes before the end of the block.
+#define LAST_LITERALS  5
+#define MATCH_LIMIT    12
+#define MAX_OFFSET     65535
+#define HASH_LOG       12
+#define RUN_MASK       15
+#define ML_MASK        15
+
+static_function u32 Read32(const u8 *ptr)
+{
+	u32 value;
+	V_memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static_function u32 Hash(u32 sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+static_function u8 *WriteLength(u8 *op, u32 length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (u8)length;
+	return op;
+}
+
+static_function u8 *WriteSequence(u8 *op, const u8 *literals, u32 literalLength, u32 offset, u32 matchLength)
+{
+	u8 *token = op++;
+	*token = (u8)(MIN(literalLength, RUN_MASK) << 4);
+	if (literalLength >= RUN_MASK)
+	{
+		op = WriteLength(op, literalLength - RUN_MASK);
+	}
+	V_memcpy(op, literals, literalLength);
+	op += literalLength;
+
+	// The last sequence only contains literals.
+	if (offset == 0)
+	{
+		return op;
+	}
+	*op++ = (u8)(offset & 0xFF);
+	*op++ = (u8)(offset >> 8);
+
+	matchLength -= MIN_MATCH;
+	*token |= (u8)MIN(matchLength, ML_MASK);
+	if (matchLength >= ML_MASK)
+	{
+		op = WriteLength(op, matchLength - ML_MASK);
+	}
+	return op;
+}
+
+u32 compression::Compress(const u8 *src, u32 srcSize, u8 *dst, u32 dstCapacity)
+{
+	if (dstCapacity < CompressBound(srcSize))
+	{
+		return 0;
+	}
+
+	// Position + 1 of the last occurrence of each hashed sequence, 0 means empty.
+	u32 table[1 << HASH_LOG] = {};
+
+	const u8 *ip = src;
+	const u8 *anchor = src;
+	const u8 *end = src + srcSize;
+	u8 *op = dst;
+
+	if (srcSize > MATCH_LIMIT)
+	{
+		const u8 *matchEnd = end - LAST_LITERALS;
+		const u8 *searchEnd = end - MATCH_LIMIT;
+		while (ip < searchEnd)
+		{
+			u32 sequence = Read32(ip);
+			u32 hash = Hash(sequence);
+			u32 candidate = table[hash];
+			table[hash] = (u32)(ip - src) + 1;
+
+			const u8 *ref = src + candidate - 1;
+			if (candidate == 0 || ip - ref > MAX_OFFSET || Read32(ref) != sequence)
+			{
+				ip++;
+				continue;
+			}
+
+			const u8 *matchIp = ip + MIN_MATCH;
+			const u8 *matchRef = ref + MIN_MATCH;
+			while (matchIp < matchEnd && *matchIp == *matchRef)
+			{
+				matchIp++;
+				matchRef++;
+			}
+
+			op = WriteSequence(op, anchor, (u32)(ip - anchor), (u32)(ip - ref), (u32)(matchIp - ip));
+			ip = matchIp;
+			anchor = ip;
+		}
+	}
+
+	op = WriteSequence(op, anchor, (u32)(end - anchor), 0, 0);
+	return (u32)(op - dst);
+}
+
+static_function bool ReadLength(const u8 *&ip, const u8 *end, u32 &length)
+{
+	u8 byte;
+	do
+	{
+		if (ip >= end)
+		{
+			return false;
+		}
+		byte = *ip++;
+		length += byte;
+	} while (byte == 255);
+	return true;
+}
+
+bool compression::Decompress(const u8 *src, u32 srcSize, u8 *dst, u32 dstSize)
+{
+	const u8 *ip = src;
+	const u8 *end = src + srcSize;
+	u8 *op = dst;
+	u8 *outEnd = dst + dstSize;
+
+	while (ip < end)
+	{
+		u8 token = *ip++;
+
+		u32 literalLength = token >> 4;
+		if (literalLength == RUN_MASK && !ReadLength(ip, end, literalLength))
+		{
+			return false;
+		}
+		if (literalLength > (u32)(end - ip) || literalLength > (u32)(outEnd - op))
+		{
+			return false;
+		}
+		V_memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// End of block.
+		if (ip >= end)
+		{
+			break;
+		}
+
+		if (end - ip < 2)
+		{
+			return false;
+		}
+		u32 offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (u32)(op - dst))
+		{
+			return false;
+		}
+
+		u32 matchLength = token & ML_MASK;
+		if (matchLength == ML_MASK && !ReadLength(ip, end, matchLength))
+		{
+			return false;
+		}
+		matchLength += MIN_MATCH;
+		if (matchLength > (u32)(outEnd - op))
+		{
+			return false;
+		}
+		// Matches can overlap with the output, so copy byte by byte.
+		const u8 *match = op - offset;
+		for (u32 i = 0; i < matchLength; i++)
+		{
+			op[i] = match[i];
+		}
+		op += matchLength;
+	}
+	return op == outEnd;
+}
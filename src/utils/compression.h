@@ -0,0 +1,20 @@
+// Minimal LZ4 block format codec, used for data that is written by the plugin itself (replays).
+// Favours speed over ratio: greedy matching with a single hash probe per position.
+
+#pragma once
+#include "common.h"
+
+namespace compression
+{
+	// Worst case size of the compressed output for an input of the given size.
+	constexpr u32 CompressBound(u32 size)
+	{
+		return size + size / 255 + 16;
+	}
+
+	// Returns the compressed size, or 0 if dstCapacity is smaller than CompressBound(srcSize).
+	u32 Compress(const u8 *src, u32 srcSize, u8 *dst, u32 dstCapacity);
+
+	// Returns false if the input is malformed or does not decompress to exactly dstSize bytes.
+	bool Decompress(const u8 *src, u32 srcSize, u8 *dst, u32 dstSize);
+} // namespace compression
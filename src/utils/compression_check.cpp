@@ -0,0 +1,212 @@
+// Checks the replay block codec in compression.h: round trips of empty, compressible, incompressible and maximum size blocks,
+// and that truncated and corrupted blocks are rejected without writing past the output. Prints every failed check and returns
+// non-zero if there was one. Run it under a sanitizer to catch reads past the input as well.
+//
+//   cs2kz-check-compression [-s seed]
+//
+// The tool links tier0 like the plugin does, run it with the game's bin directory in the library path.
+
+#include "compression.h"
+#include "kz/replays/replay_format.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tier0/memdbgon.h"
+
+#define CHECK_DEFAULT_SEED 0x2545F4914F6CDD1Dull
+// Written after the end of every output buffer, must still be there after decompressing.
+#define CHECK_GUARD_SIZE   64
+#define CHECK_GUARD_BYTE   0xCD
+#define CHECK_CORRUPTIONS  4096
+
+static_global u64 rngState;
+static_global i32 failures;
+
+// xorshift64, the same seed always gives the same data.
+static_function u32 NextRandom()
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 7;
+	rngState ^= rngState << 17;
+	return (u32)(rngState >> 32);
+}
+
+static_function void Fail(const char *check, u32 size, const char *reason)
+{
+	printf("  %s (%u bytes): %s\n", check, size, reason);
+	failures++;
+}
+
+// Decompress into a buffer of exactly dstSize bytes followed by a guard, returns false if the guard was overwritten.
+static_function bool DecompressGuarded(const u8 *src, u32 srcSize, u32 dstSize, CUtlVector<u8> &out, bool &success)
+{
+	out.SetCount(dstSize + CHECK_GUARD_SIZE);
+	V_memset(out.Base(), CHECK_GUARD_BYTE, out.Count());
+	// Copy the input into a buffer of its exact size, so a sanitizer sees any read past its end.
+	u8 *input = new u8[MAX(srcSize, 1u)];
+	V_memcpy(input, src, srcSize);
+	success = compression::Decompress(input, srcSize, out.Base(), dstSize);
+	delete[] input;
+	for (u32 i = dstSize; i < (u32)out.Count(); i++)
+	{
+		if (out[i] != CHECK_GUARD_BYTE)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Compress the data and check that it decompresses to the same bytes, returns the compressed size.
+static_function u32 CheckRoundTrip(const char *check, const CUtlVector<u8> &data, CUtlVector<u8> &compressed)
+{
+	u32 size = data.Count();
+	compressed.SetCount(compression::CompressBound(size));
+	if (size > 0 && compression::Compress(data.Base(), size, compressed.Base(), compressed.Count() - 1) != 0)
+	{
+		Fail(check, size, "compressed into a buffer smaller than CompressBound");
+	}
+	u32 compressedSize = compression::Compress(data.Base(), size, compressed.Base(), compressed.Count());
+	if (compressedSize == 0 || compressedSize > compression::CompressBound(size))
+	{
+		Fail(check, size, "compressed size out of bounds");
+		return 0;
+	}
+	compressed.SetCount(compressedSize);
+
+	CUtlVector<u8> out;
+	bool success;
+	if (!DecompressGuarded(compressed.Base(), compressedSize, size, out, success))
+	{
+		Fail(check, size, "wrote past the output");
+	}
+	if (!success)
+	{
+		Fail(check, size, "failed to decompress");
+	}
+	else if (size > 0 && V_memcmp(out.Base(), data.Base(), size) != 0)
+	{
+		Fail(check, size, "decompressed to different data");
+	}
+
+	// The exact size is stored next to the block, any other size is an error.
+	if (DecompressGuarded(compressed.Base(), compressedSize, size + 1, out, success) && success)
+	{
+		Fail(check, size, "decompressed into a larger output");
+	}
+	if (size > 0 && DecompressGuarded(compressed.Base(), compressedSize, size - 1, out, success) && success)
+	{
+		Fail(check, size, "decompressed into a smaller output");
+	}
+	return compressedSize;
+}
+
+// Every prefix of a block must be rejected, and corrupted blocks must never write past the output.
+static_function void CheckMalformed(const char *check, u32 size, const CUtlVector<u8> &compressed)
+{
+	CUtlVector<u8> out;
+	bool success;
+	for (u32 length = 0; length < (u32)compressed.Count(); length++)
+	{
+		if (!DecompressGuarded(compressed.Base(), length, size, out, success))
+		{
+			Fail(check, size, "truncated block wrote past the output");
+			return;
+		}
+		if (success && size > 0)
+		{
+			Fail(check, size, "truncated block was accepted");
+			return;
+		}
+	}
+
+	CUtlVector<u8> corrupted;
+	for (u32 i = 0; i < CHECK_CORRUPTIONS && compressed.Count() > 0; i++)
+	{
+		corrupted.CopyArray(compressed.Base(), compressed.Count());
+		u32 flips = 1 + NextRandom() % 4;
+		for (u32 j = 0; j < flips; j++)
+		{
+			corrupted[NextRandom() % corrupted.Count()] = (u8)NextRandom();
+		}
+		// A corrupted block may still decode to the right size, only the bounds are checked.
+		if (!DecompressGuarded(corrupted.Base(), corrupted.Count(), size, out, success))
+		{
+			Fail(check, size, "corrupted block wrote past the output");
+			return;
+		}
+	}
+}
+
+static_function void Check(const char *check, const CUtlVector<u8> &data, bool incompressible)
+{
+	CUtlVector<u8> compressed;
+	u32 compressedSize = CheckRoundTrip(check, data, compressed);
+	if (compressedSize == 0)
+	{
+		return;
+	}
+	if (incompressible && data.Count() > 0 && compressedSize <= (u32)data.Count())
+	{
+		Fail(check, data.Count(), "random data shrank, the generator is broken");
+	}
+	CheckMalformed(check, data.Count(), compressed);
+}
+
+int main(int argc, char *argv[])
+{
+	rngState = CHECK_DEFAULT_SEED;
+	for (i32 i = 1; i < argc; i++)
+	{
+		if (KZ_STREQ(argv[i], "-s") && i + 1 < argc)
+		{
+			rngState = strtoull(argv[++i], nullptr, 0);
+			// xorshift never leaves 0.
+			if (rngState == 0)
+			{
+				rngState = CHECK_DEFAULT_SEED;
+			}
+			continue;
+		}
+		printf("Usage: %s [-s seed]\n", argv[0]);
+		return 1;
+	}
+
+	// Sizes around the literal and match limits of the codec, and the largest block a replay can contain.
+	const u32 sizes[] = {0, 1, 4, 5, 12, 13, 14, 15, 16, 255, 256, 270, 4096, KZ_REPLAY_MAX_BLOCK_SIZE - 1, KZ_REPLAY_MAX_BLOCK_SIZE};
+	CUtlVector<u8> data;
+	for (u32 i = 0; i < Q_ARRAYSIZE(sizes); i++)
+	{
+		u32 size = sizes[i];
+		data.SetCount(size);
+
+		for (u32 j = 0; j < size; j++)
+		{
+			data[j] = (u8)NextRandom();
+		}
+		Check("incompressible", data, true);
+
+		V_memset(data.Base(), 0, size);
+		Check("zeroes", data, false);
+
+		// Short repeats with some noise, closer to what replay frames look like.
+		for (u32 j = 0; j < size; j++)
+		{
+			data[j] = (NextRandom() % 8 == 0) ? (u8)NextRandom() : (u8)(j % 24);
+		}
+		Check("mixed", data, false);
+	}
+
+	// A match far back in the block that is longer than a single length byte can describe.
+	data.SetCount(KZ_REPLAY_MAX_BLOCK_SIZE);
+	for (u32 j = 0; j < (u32)data.Count(); j++)
+	{
+		data[j] = (u8)NextRandom();
+	}
+	V_memcpy(data.Base() + data.Count() - 1024, data.Base(), 1024);
+	Check("long match", data, false);
+
+	printf("%i failed checks\n", failures);
+	return failures > 0 ? 1 : 0;
+}
@@ -1,41 +1,248 @@
 #include "ctimer.h"
+#include "perf.h"
 
-CUtlVector<CTimerBase *> g_NonPersistentTimers;
-CUtlVector<CTimerBase *> g_PersistentTimers;
+/*
+	Timers are kept in one binary min-heap per clock, ordered by the time they execute next.
+	ProcessTimers only has to look at the top of each heap, so ticks where no timer is due cost two comparisons.
+	Timers added since the last ProcessTimers wait in a pending list, they start counting their interval the first time they are
+	processed, same as they did when every timer was checked every tick.
+*/
 
-static_function void ProcessTimerList(CUtlVector<CTimerBase *> &timers)
+// Values of CTimerBase::heapIndex for timers that aren't in a heap.
+#define TIMER_NOT_SCHEDULED -1
+#define TIMER_PENDING       -2
+#define TIMER_DUE           -3
+
+struct TimerHeapEntry
+{
+	f64 nextExecute;
+	CTimerBase *timer;
+};
+
+struct TimerHeap
 {
-	for (int i = timers.Count() - 1; i >= 0; i--)
+	CUtlVector<TimerHeapEntry> entries;
+
+	void Set(i32 index, const TimerHeapEntry &entry)
 	{
-		auto timer = timers[i];
-		f64 currentTime = timer->useRealTime ? g_pKZUtils->GetGlobals()->realtime : g_pKZUtils->GetGlobals()->curtime;
-		if (timer->lastExecute == -1)
+		this->entries[index] = entry;
+		entry.timer->heapIndex = index;
+	}
+
+	void SiftUp(i32 index)
+	{
+		TimerHeapEntry entry = this->entries[index];
+		while (index > 0)
 		{
-			timer->lastExecute = currentTime;
+			i32 parent = (index - 1) / 2;
+			if (this->entries[parent].nextExecute <= entry.nextExecute)
+			{
+				break;
+			}
+			this->Set(index, this->entries[parent]);
+			index = parent;
 		}
+		this->Set(index, entry);
+	}
 
-		if (timer->lastExecute + timer->interval <= currentTime)
+	void SiftDown(i32 index)
+	{
+		TimerHeapEntry entry = this->entries[index];
+		i32 count = this->entries.Count();
+		while (true)
 		{
-			if (!timer->Execute())
+			i32 child = index * 2 + 1;
+			if (child >= count)
 			{
-				delete timer;
-				timers.Remove(i);
+				break;
 			}
-			else
+			if (child + 1 < count && this->entries[child + 1].nextExecute < this->entries[child].nextExecute)
 			{
-				timer->lastExecute = currentTime;
+				child++;
 			}
+			if (entry.nextExecute <= this->entries[child].nextExecute)
+			{
+				break;
+			}
+			this->Set(index, this->entries[child]);
+			index = child;
+		}
+		this->Set(index, entry);
+	}
+
+	void Push(CTimerBase *timer, f64 nextExecute)
+	{
+		i32 index = this->entries.AddToTail({nextExecute, timer});
+		this->SiftUp(index);
+	}
+
+	void RemoveAt(i32 index)
+	{
+		this->entries[index].timer->heapIndex = TIMER_NOT_SCHEDULED;
+		i32 last = this->entries.Count() - 1;
+		if (index == last)
+		{
+			this->entries.RemoveMultipleFromTail(1);
+			return;
+		}
+		// The last entry takes the free spot and can end up having to move either way.
+		CTimerBase *moved = this->entries[last].timer;
+		this->Set(index, this->entries[last]);
+		this->entries.RemoveMultipleFromTail(1);
+		this->SiftDown(index);
+		this->SiftUp(moved->heapIndex);
+	}
+
+	// Restore the heap after entries were removed out of order.
+	void Rebuild()
+	{
+		FOR_EACH_VEC(this->entries, i)
+		{
+			this->entries[i].timer->heapIndex = i;
+		}
+		for (i32 i = this->entries.Count() / 2 - 1; i >= 0; i--)
+		{
+			this->SiftDown(i);
+		}
+	}
+};
+
+static_global TimerHeap realTimeTimers;
+static_global TimerHeap curTimeTimers;
+static_global CUtlVector<CTimerBase *> pendingTimers;
+// Timers being executed by ProcessTimerHeap, removed timers are set to nullptr.
+static_global CUtlVector<CTimerBase *> dueTimers;
+
+static_function f64 GetTimerTime(bool useRealTime)
+{
+	return useRealTime ? g_pKZUtils->GetGlobals()->realtime : g_pKZUtils->GetGlobals()->curtime;
+}
+
+static_function TimerHeap &GetTimerHeap(CTimerBase *timer)
+{
+	return timer->useRealTime ? realTimeTimers : curTimeTimers;
+}
+
+static_function void ProcessTimerHeap(TimerHeap &heap, f64 currentTime)
+{
+	if (heap.entries.Count() == 0 || heap.entries[0].nextExecute > currentTime)
+	{
+		return;
+	}
+
+	// Take every due timer out first, so that each timer runs at most once per call no matter what interval it returns.
+	dueTimers.RemoveAll();
+	while (heap.entries.Count() > 0 && heap.entries[0].nextExecute <= currentTime)
+	{
+		CTimerBase *timer = heap.entries[0].timer;
+		heap.RemoveAt(0);
+		timer->heapIndex = TIMER_DUE;
+		dueTimers.AddToTail(timer);
+	}
+
+	FOR_EACH_VEC(dueTimers, i)
+	{
+		CTimerBase *timer = dueTimers[i];
+		if (!timer)
+		{
+			continue;
 		}
+		bool keep = timer->Execute();
+		// The timer might have been removed by its own callback, it belongs to whoever removed it then.
+		if (!dueTimers[i])
+		{
+			continue;
+		}
+		dueTimers[i] = nullptr;
+		if (!keep)
+		{
+			delete timer;
+			continue;
+		}
+		timer->lastExecute = currentTime;
+		heap.Push(timer, currentTime + timer->interval);
 	}
+	dueTimers.RemoveAll();
 }
 
 void ProcessTimers()
 {
-	ProcessTimerList(g_PersistentTimers);
-	ProcessTimerList(g_NonPersistentTimers);
+	KZ_PROFILE(__func__);
+	if (pendingTimers.Count() > 0)
+	{
+		f64 realTime = GetTimerTime(true);
+		f64 curTime = GetTimerTime(false);
+		FOR_EACH_VEC(pendingTimers, i)
+		{
+			CTimerBase *timer = pendingTimers[i];
+			if (timer->lastExecute == -1)
+			{
+				timer->lastExecute = timer->useRealTime ? realTime : curTime;
+			}
+			GetTimerHeap(timer).Push(timer, timer->lastExecute + timer->interval);
+		}
+		pendingTimers.RemoveAll();
+	}
+	ProcessTimerHeap(realTimeTimers, GetTimerTime(true));
+	ProcessTimerHeap(curTimeTimers, GetTimerTime(false));
+}
+
+void ScheduleTimer(CTimerBase *timer, bool preserveMapChange)
+{
+	timer->preserveMapChange = preserveMapChange;
+	timer->heapIndex = TIMER_PENDING;
+	pendingTimers.AddToTail(timer);
+}
+
+void UnscheduleTimer(CTimerBase *timer)
+{
+	if (timer->heapIndex >= 0)
+	{
+		TimerHeap &heap = GetTimerHeap(timer);
+		if (timer->heapIndex < heap.entries.Count() && heap.entries[timer->heapIndex].timer == timer)
+		{
+			heap.RemoveAt(timer->heapIndex);
+		}
+		return;
+	}
+	if (timer->heapIndex == TIMER_PENDING)
+	{
+		pendingTimers.FindAndRemove(timer);
+	}
+	else if (timer->heapIndex == TIMER_DUE)
+	{
+		i32 index = dueTimers.Find(timer);
+		if (dueTimers.IsValidIndex(index))
+		{
+			dueTimers[index] = nullptr;
+		}
+	}
+	timer->heapIndex = TIMER_NOT_SCHEDULED;
+}
+
+static_function void RemoveNonPersistentTimers(TimerHeap &heap)
+{
+	for (i32 i = heap.entries.Count() - 1; i >= 0; i--)
+	{
+		if (!heap.entries[i].timer->preserveMapChange)
+		{
+			delete heap.entries[i].timer;
+			heap.entries.FastRemove(i);
+		}
+	}
+	heap.Rebuild();
 }
 
 void RemoveNonPersistentTimers()
 {
-	g_NonPersistentTimers.PurgeAndDeleteElements();
+	RemoveNonPersistentTimers(realTimeTimers);
+	RemoveNonPersistentTimers(curTimeTimers);
+	for (i32 i = pendingTimers.Count() - 1; i >= 0; i--)
+	{
+		if (!pendingTimers[i]->preserveMapChange)
+		{
+			delete pendingTimers[i];
+			pendingTimers.Remove(i);
+		}
+	}
 }
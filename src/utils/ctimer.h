@@ -20,13 +20,18 @@ public:
 	f64 interval {};
 	f64 lastExecute = -1;
 	bool useRealTime {};
+
+	// Managed by the scheduler in ctimer.cpp.
+	bool preserveMapChange = true;
+	i32 heapIndex = -1;
 };
 
 void ProcessTimers();
 void RemoveNonPersistentTimers();
 
-extern CUtlVector<CTimerBase *> g_NonPersistentTimers;
-extern CUtlVector<CTimerBase *> g_PersistentTimers;
+// Backends of KZUtils::AddTimer and KZUtils::RemoveTimer, the timer isn't owned by the scheduler anymore after removing it.
+void ScheduleTimer(CTimerBase *timer, bool preserveMapChange);
+void UnscheduleTimer(CTimerBase *timer);
 
 template<typename... Args>
 class CTimer : public CTimerBase
@@ -19,12 +19,15 @@
 #include "kz/timer/queries/base_request.h"
 #include "kz/telemetry/kz_telemetry.h"
 #include "kz/trigger/kz_trigger.h"
+#include "kz/trigger/trigger_broadphase.h"
+#include "kz/trigger/trigger_table.h"
 #include "kz/db/kz_db.h"
 #include "kz/mappingapi/kz_mappingapi.h"
+#include "kz/replays/kz_replays.h"
 #include "utils/utils.h"
 #include "sdk/entity/cbasetrigger.h"
 
-#include "vprof.h"
+#include "utils/perf.h"
 
 #include "memdbgon.h"
 
@@ -333,7 +336,9 @@ void EntListener::OnEntitySpawned(CEntityInstance *pEntity)
 	if (V_strstr(pEntity->GetClassname(), "trigger_"))
 	{
 		AddEntityHooks(static_cast<CBaseEntity *>(pEntity));
+		KZ::trigger::OnTriggerSpawned((CBaseTrigger *)pEntity);
 		KZ::mapapi::CheckEndTimerTrigger((CBaseTrigger *)pEntity);
+		KZ::trigger::InvalidateBroadphase();
 	}
 }
 
@@ -342,6 +347,8 @@ void EntListener::OnEntityDeleted(CEntityInstance *pEntity)
 	if (V_strstr(pEntity->GetClassname(), "trigger_"))
 	{
 		RemoveEntityHooks(static_cast<CBaseEntity *>(pEntity));
+		KZ::trigger::OnTriggerDeleted((CBaseTrigger *)pEntity);
+		KZ::trigger::InvalidateBroadphase();
 	}
 }
 
@@ -356,6 +363,10 @@ void hooks::HookEntities()
 	for (CEntityIdentity *entID = GameEntitySystem()->m_EntityList.m_pFirstActiveEntity; entID != NULL; entID = entID->m_pNext)
 	{
 		AddEntityHooks(static_cast<CBaseEntity *>(entID->m_pInstance));
+		if (V_strstr(entID->m_pInstance->GetClassname(), "trigger_"))
+		{
+			KZ::trigger::OnTriggerSpawned(static_cast<CBaseTrigger *>(entID->m_pInstance));
+		}
 	}
 	GameEntitySystem()->AddListenerEntity(&entityListener);
 }
@@ -456,9 +467,14 @@ static_function void Hook_CheckTransmit(CCheckTransmitInfo **pInfo, int infoCoun
 // ISource2Server
 static_function void Hook_GameFrame(bool simulating, bool bFirstTick, bool bLastTick)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	g_KZPlugin.serverGlobals = *(g_pKZUtils->GetGlobals());
 	KZ::timer::CheckAnnounceQueue();
+	KZ::timer::CheckCacheLoads();
+	KZ::replays::PrintWriterMessages();
+	KZReplayService::CheckGhostLoads();
+	KZReplayService::CheckFailedWrites();
+	KZReplayService::CheckIdleBots();
 	BaseRequest::CheckRequests();
 	KZ::misc::EnforceTimeLimit();
 	KZTelemetryService::ActiveCheck();
@@ -546,7 +562,7 @@ static_function void Hook_ClientVoice(CPlayerSlot slot)
 
 static_function void Hook_ClientCommand(CPlayerSlot slot, const CCommand &args)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	if (META_RES result = KZ::misc::CheckBlockedRadioCommands(args[0]))
 	{
 		RETURN_META(result);
@@ -593,6 +609,7 @@ static_function bool Hook_FireEvent(IGameEvent *event, bool bDontBroadcast)
 			KZTimerService::OnRoundStart();
 			KZ::misc::OnRoundStart();
 			KZ::mapapi::OnRoundStart();
+			KZ::trigger::InvalidateBroadphase();
 		}
 		else if (KZ_STREQI(event->GetName(), "player_team"))
 		{
@@ -617,7 +634,7 @@ static_function bool Hook_FireEvent(IGameEvent *event, bool bDontBroadcast)
 // ICvar
 static_function void Hook_DispatchConCommand(ConCommandHandle cmd, const CCommandContext &ctx, const CCommand &args)
 {
-	VPROF_BUDGET(__func__, "CS2KZ");
+	KZ_PROFILE(__func__);
 	if (META_RES result = KZ::misc::CheckBlockedRadioCommands(args[0]))
 	{
 		RETURN_META(result);
@@ -0,0 +1,259 @@
+#include "perf.h"
+#include "utils/simplecmds.h"
+#include "kz/kz.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "tier0/memdbgon.h"
+
+// Four buckets per power of two, every bucket is at most 25% wider than its lower bound.
+#define PERF_SUB_BUCKETS 4
+#define PERF_BUCKETS     256
+
+struct Histogram
+{
+	// Only written by the owning thread, atomics just keep kz_perf from reading torn values.
+	std::atomic<u32> buckets[PERF_BUCKETS];
+	std::atomic<u64> count;
+	std::atomic<u64> max;
+};
+
+struct ThreadData
+{
+	// Allocated the first time a scope is recorded for a slot, most scopes never see a player.
+	std::atomic<Histogram *> histograms[PERF_MAX_SCOPES][MAXPLAYERS + 1];
+};
+
+struct Scope
+{
+	const char *name;
+	const char *file;
+};
+
+static_global std::mutex perfMutex;
+static_global Scope scopes[PERF_MAX_SCOPES];
+static_global std::atomic<u32> scopeCount;
+static_global std::vector<ThreadData *> threads;
+static_global thread_local ThreadData *currentThread;
+// Cleanup frees the data of every thread but can't reach their thread_local pointers.
+// Bumping the generation tells each thread its pointer is gone, so it never touches it again.
+static_global std::atomic<u32> generation;
+static_global thread_local u32 currentThreadGeneration;
+static_global std::atomic<bool> recording;
+
+// Used to convert cycles to microseconds, the TSC frequency is measured between Init and kz_perf.
+static_global u64 startCycles;
+static_global f64 startTime;
+
+static_function u32 GetBucket(u64 cycles)
+{
+	if (cycles < PERF_SUB_BUCKETS)
+	{
+		return (u32)cycles;
+	}
+#ifdef _WIN32
+	unsigned long msb;
+	_BitScanReverse64(&msb, cycles);
+#else
+	u32 msb = 63 - __builtin_clzll(cycles);
+#endif
+	return (msb - 1) * PERF_SUB_BUCKETS + ((cycles >> (msb - 2)) & (PERF_SUB_BUCKETS - 1));
+}
+
+static_function u64 GetBucketUpperBound(u32 bucket)
+{
+	if (bucket < PERF_SUB_BUCKETS)
+	{
+		return bucket;
+	}
+	u32 shift = bucket / PERF_SUB_BUCKETS - 1;
+	u64 lower = (u64)(PERF_SUB_BUCKETS + bucket % PERF_SUB_BUCKETS) << shift;
+	return lower + ((u64)1 << shift) - 1;
+}
+
+template<typename T>
+static_function void Add(std::atomic<T> &value, T amount)
+{
+	value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void perf::Init()
+{
+	startCycles = __rdtsc();
+	startTime = Plat_FloatTime();
+	recording.store(true);
+}
+
+// The writer and cache loader threads are stopped before this, nothing can be in the middle of recording.
+void perf::Cleanup()
+{
+	std::lock_guard<std::mutex> lock(perfMutex);
+	recording.store(false);
+	generation.fetch_add(1);
+	currentThread = nullptr;
+	for (ThreadData *thread : threads)
+	{
+		for (u32 scope = 0; scope < PERF_MAX_SCOPES; scope++)
+		{
+			for (u32 slot = 0; slot < MAXPLAYERS + 1; slot++)
+			{
+				delete thread->histograms[scope][slot].load();
+			}
+		}
+		delete thread;
+	}
+	threads.clear();
+}
+
+u32 perf::RegisterScope(const char *name, const char *file)
+{
+	std::lock_guard<std::mutex> lock(perfMutex);
+	u32 scope = scopeCount.load();
+	if (scope >= PERF_MAX_SCOPES)
+	{
+		return PERF_MAX_SCOPES;
+	}
+	// Only keep the file name, full paths depend on where the plugin was built.
+	const char *fileName = V_strrchr(file, '/') ? V_strrchr(file, '/') + 1 : file;
+	fileName = V_strrchr(fileName, '\\') ? V_strrchr(fileName, '\\') + 1 : fileName;
+	scopes[scope] = {name, fileName};
+	scopeCount.store(scope + 1);
+	return scope;
+}
+
+void perf::Record(u32 scope, i32 slot, u64 cycles)
+{
+	if (scope >= PERF_MAX_SCOPES || slot < PERF_NO_PLAYER || slot >= MAXPLAYERS || !recording.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	if (!currentThread || currentThreadGeneration != generation.load(std::memory_order_acquire))
+	{
+		currentThread = new ThreadData();
+		currentThreadGeneration = generation.load(std::memory_order_acquire);
+		std::lock_guard<std::mutex> lock(perfMutex);
+		threads.push_back(currentThread);
+	}
+	std::atomic<Histogram *> &entry = currentThread->histograms[scope][slot + 1];
+	Histogram *histogram = entry.load(std::memory_order_relaxed);
+	if (!histogram)
+	{
+		histogram = new Histogram();
+		entry.store(histogram, std::memory_order_release);
+	}
+	Add(histogram->buckets[GetBucket(cycles)], 1u);
+	Add(histogram->count, (u64)1);
+	if (cycles > histogram->max.load(std::memory_order_relaxed))
+	{
+		histogram->max.store(cycles, std::memory_order_relaxed);
+	}
+}
+
+// Histogram of one scope merged over every thread.
+struct MergedHistogram
+{
+	u64 buckets[PERF_BUCKETS];
+	u64 count;
+	u64 max;
+
+	void Add(const Histogram *histogram)
+	{
+		for (u32 i = 0; i < PERF_BUCKETS; i++)
+		{
+			buckets[i] += histogram->buckets[i].load(std::memory_order_relaxed);
+		}
+		count += histogram->count.load(std::memory_order_relaxed);
+		max = MAX(max, histogram->max.load(std::memory_order_relaxed));
+	}
+
+	u64 GetPercentile(f64 percentile) const
+	{
+		u64 target = (u64)ceil(count * percentile);
+		u64 seen = 0;
+		for (u32 i = 0; i < PERF_BUCKETS; i++)
+		{
+			seen += buckets[i];
+			if (seen >= MAX(target, (u64)1))
+			{
+				return MIN(GetBucketUpperBound(i), max);
+			}
+		}
+		return max;
+	}
+};
+
+static_function MergedHistogram MergeHistograms(u32 scope, i32 slot, bool allSlots)
+{
+	MergedHistogram result {};
+	for (ThreadData *thread : threads)
+	{
+		for (i32 i = PERF_NO_PLAYER; i < MAXPLAYERS; i++)
+		{
+			if (!allSlots && i != slot)
+			{
+				continue;
+			}
+			Histogram *histogram = thread->histograms[scope][i + 1].load(std::memory_order_acquire);
+			if (histogram)
+			{
+				result.Add(histogram);
+			}
+		}
+	}
+	return result;
+}
+
+static_function void PrintHistogram(KZPlayer *player, const char *name, const MergedHistogram &histogram, f64 cyclesPerMicrosecond)
+{
+	player->PrintConsole(false, false, "%-48s %10llu %9.2f %9.2f %9.2f", name, (unsigned long long)histogram.count,
+						 histogram.GetPercentile(0.5) / cyclesPerMicrosecond, histogram.GetPercentile(0.99) / cyclesPerMicrosecond,
+						 histogram.max / cyclesPerMicrosecond);
+}
+
+// kz_perf [me]
+// The histograms are server wide and there are no admin permissions, so players only get their own per player timings
+// and can't reset anything.
+static_function SCMD_CALLBACK(Command_KzPerf)
+{
+	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
+	std::lock_guard<std::mutex> lock(perfMutex);
+	bool showSelf = args->ArgC() >= 2 && KZ_STREQI(args->Arg(1), "me");
+
+	f64 elapsed = Plat_FloatTime() - startTime;
+	if (elapsed <= 0.0)
+	{
+		return MRES_SUPERCEDE;
+	}
+	f64 cyclesPerMicrosecond = (__rdtsc() - startCycles) / (elapsed * 1000000.0);
+
+	player->PrintConsole(false, false, "%-48s %10s %9s %9s %9s", "Scope", "Calls", "p50 (us)", "p99 (us)", "Max (us)");
+	for (u32 scope = 0; scope < scopeCount.load(); scope++)
+	{
+		MergedHistogram total = MergeHistograms(scope, PERF_NO_PLAYER, true);
+		if (total.count == 0)
+		{
+			continue;
+		}
+		char name[128];
+		V_snprintf(name, sizeof(name), "%s:%s", scopes[scope].file, scopes[scope].name);
+		PrintHistogram(player, name, total, cyclesPerMicrosecond);
+		if (!showSelf)
+		{
+			continue;
+		}
+		MergedHistogram histogram = MergeHistograms(scope, player->GetPlayerSlot().Get(), false);
+		if (histogram.count != 0)
+		{
+			V_snprintf(name, sizeof(name), "    %s", player->GetName());
+			PrintHistogram(player, name, histogram, cyclesPerMicrosecond);
+		}
+	}
+	return MRES_SUPERCEDE;
+}
+
+void perf::RegisterCommands()
+{
+	scmd::RegisterCmd("kz_perf", Command_KzPerf);
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "common.h"
+#include "vprof.h"
+
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+/*
+	Always-on profiler for the hooks and services that run every tick.
+	VPROF is never enabled on live servers, so every profiled scope also records its duration in TSC cycles into a histogram.
+	Histograms are owned by the thread that records into them, recording is a couple of adds and never takes a lock.
+	kz_perf merges them and prints p50/p99/max per scope, and the caller's own timings for player scopes.
+*/
+
+#define PERF_MAX_SCOPES 256
+// Slot used by scopes that don't belong to a specific player.
+#define PERF_NO_PLAYER  -1
+
+// Same as VPROF_BUDGET(name, "CS2KZ"), but also recorded by kz_perf.
+#define KZ_PROFILE(name) KZ_PROFILE_PLAYER(name, PERF_NO_PLAYER)
+
+#define KZ_PROFILE_PLAYER(name, slot) \
+	VPROF_BUDGET(name, "CS2KZ"); \
+	static_persist const u32 perfScopeID = perf::RegisterScope(name, __FILE__); \
+	perf::ScopeTimer perfScopeTimer(perfScopeID, slot)
+
+namespace perf
+{
+	void Init();
+	void Cleanup();
+	void RegisterCommands();
+
+	// Scopes are registered once per call site, names don't have to be unique.
+	u32 RegisterScope(const char *name, const char *file);
+	void Record(u32 scope, i32 slot, u64 cycles);
+
+	struct ScopeTimer
+	{
+		ScopeTimer(u32 scope, i32 slot) : scope(scope), slot(slot), start(__rdtsc()) {}
+
+		~ScopeTimer()
+		{
+			Record(scope, slot, __rdtsc() - start);
+		}
+
+		u32 scope;
+		i32 slot;
+		u64 start;
+	};
+} // namespace perf
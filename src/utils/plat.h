@@ -2,6 +2,7 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <cstdio>
 #include "metamod_oslink.h"
 
 struct Section
@@ -41,3 +42,14 @@ int GetModuleInformation(HINSTANCE module, void **base, size_t *length, std::vec
 #endif
 
 void Plat_WriteMemory(void *pPatchAddress, uint8_t *pPatch, int iPatchSize);
+
+// Flush a file all the way to the disk.
+bool Plat_SyncFile(FILE *file);
+// Create a single directory, succeeds if it already exists.
+bool Plat_CreateDirectory(const char *path);
+// Atomically replace the destination file with the source file.
+bool Plat_ReplaceFile(const char *source, const char *destination);
+// Map a whole file read only into memory. Returns nullptr on failure or if the file is empty.
+// Windows reads the file into memory instead, so the file can still be replaced while the data is in use.
+void *Plat_MapFile(const char *path, size_t *size);
+void Plat_UnmapFile(void *data, size_t size);
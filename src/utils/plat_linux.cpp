@@ -13,6 +13,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 
 #include "tier0/memdbgon.h"
 
@@ -246,4 +248,51 @@ void *CModule::FindVirtualTable(const std::string &name)
 	Warning("Failed to find vtable for %s\n", name.c_str());
 	return nullptr;
 }
+
+bool Plat_SyncFile(FILE *file)
+{
+	return fflush(file) == 0 && fsync(fileno(file)) == 0;
+}
+
+bool Plat_CreateDirectory(const char *path)
+{
+	return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+bool Plat_ReplaceFile(const char *source, const char *destination)
+{
+	return rename(source, destination) == 0;
+}
+
+void *Plat_MapFile(const char *path, size_t *size)
+{
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return nullptr;
+	}
+	struct stat info;
+	void *data = nullptr;
+	if (fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (data == MAP_FAILED)
+		{
+			data = nullptr;
+		}
+		else
+		{
+			*size = info.st_size;
+			madvise(data, info.st_size, MADV_SEQUENTIAL);
+		}
+	}
+	// The mapping stays valid after the descriptor is closed.
+	close(fd);
+	return data;
+}
+
+void Plat_UnmapFile(void *data, size_t size)
+{
+	munmap(data, size);
+}
 #endif
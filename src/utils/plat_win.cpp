@@ -1,5 +1,8 @@
 #include "plat.h"
 #include "module.h"
+#include <io.h>
+#include <direct.h>
+#include <errno.h>
 
 #include "tier0/memdbgon.h"
 
@@ -8,6 +11,55 @@ void Plat_WriteMemory(void *pPatchAddress, uint8_t *pPatch, int iPatchSize)
 	WriteProcessMemory(GetCurrentProcess(), pPatchAddress, (void *)pPatch, iPatchSize, nullptr);
 }
 
+bool Plat_SyncFile(FILE *file)
+{
+	return fflush(file) == 0 && _commit(_fileno(file)) == 0;
+}
+
+bool Plat_CreateDirectory(const char *path)
+{
+	return _mkdir(path) == 0 || errno == EEXIST;
+}
+
+bool Plat_ReplaceFile(const char *source, const char *destination)
+{
+	return MoveFileExA(source, destination, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+// A file can't be replaced while a view of it is mapped, a bot playing a replay back would keep a new personal best from being saved.
+// Read the file into memory instead, replays are small.
+void *Plat_MapFile(const char *path, size_t *size)
+{
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return nullptr;
+	}
+	void *data = nullptr;
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0 && fileSize.QuadPart <= MAXDWORD)
+	{
+		data = malloc((size_t)fileSize.QuadPart);
+		DWORD bytesRead = 0;
+		if (data && ReadFile(file, data, (DWORD)fileSize.QuadPart, &bytesRead, nullptr) && bytesRead == (DWORD)fileSize.QuadPart)
+		{
+			*size = (size_t)fileSize.QuadPart;
+		}
+		else
+		{
+			free(data);
+			data = nullptr;
+		}
+	}
+	CloseHandle(file);
+	return data;
+}
+
+void Plat_UnmapFile(void *data, size_t size)
+{
+	free(data);
+}
+
 void CModule::InitializeSections()
 {
 	IMAGE_DOS_HEADER *pDosHeader = reinterpret_cast<IMAGE_DOS_HEADER *>(m_hModule);
@@ -9,6 +9,12 @@
 #include "tier0/memdbgon.h"
 // private structs
 #define SCMD_MAX_NAME_LEN 128
+// Kept at most half full so that probe sequences stay short, has to be a power of two.
+#define SCMD_INDEX_SIZE   (SCMD_MAX_CMDS * 2)
+// Commands found by one lookup, at most "name" and "kz_name" can share a name without the console prefix.
+#define SCMD_MAX_MATCHES  4
+
+static_assert((SCMD_INDEX_SIZE & (SCMD_INDEX_SIZE - 1)) == 0, "The command index is probed with a mask, its size has to be a power of two");
 
 struct Scmd
 {
@@ -17,17 +23,82 @@ struct Scmd
 	char name[SCMD_MAX_NAME_LEN];
 	scmd::Callback_t *callback;
 	bool hidden;
+	u32 shortNameHash;
 };
 
 struct ScmdManager
 {
 	i32 cmdCount;
 	Scmd cmds[SCMD_MAX_CMDS];
+	// Open addressing index over the names without the console prefix, which is what chat triggers and console overrides match.
+	// Holds indices into cmds, -1 for empty slots. Rebuilt whenever commands are registered or unregistered.
+	i16 index[SCMD_INDEX_SIZE];
 };
 
 static_global ScmdManager g_cmdManager = {};
 static_global bool g_coreCmdsRegistered = false;
 
+static_function const char *GetShortName(const Scmd &cmd)
+{
+	return cmd.hasConsolePrefix ? cmd.name + strlen(SCMD_CONSOLE_PREFIX) : cmd.name;
+}
+
+static_function void RebuildIndex()
+{
+	for (i32 i = 0; i < SCMD_INDEX_SIZE; i++)
+	{
+		g_cmdManager.index[i] = -1;
+	}
+	// Inserting in registration order keeps commands with the same short name in that order along their probe sequence.
+	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+	{
+		u32 slot = g_cmdManager.cmds[i].shortNameHash & (SCMD_INDEX_SIZE - 1);
+		while (g_cmdManager.index[slot] != -1)
+		{
+			slot = (slot + 1) & (SCMD_INDEX_SIZE - 1);
+		}
+		g_cmdManager.index[slot] = i;
+	}
+}
+
+// Find the commands whose name without the console prefix is shortName, in registration order.
+static_function i32 FindCmds(const char *shortName, i32 (&matches)[SCMD_MAX_MATCHES])
+{
+	if (g_cmdManager.cmdCount == 0)
+	{
+		return 0;
+	}
+	i32 count = 0;
+	u32 hash = utils::HashStringCaseless(shortName);
+	for (u32 slot = hash & (SCMD_INDEX_SIZE - 1); g_cmdManager.index[slot] != -1; slot = (slot + 1) & (SCMD_INDEX_SIZE - 1))
+	{
+		i32 cmdIndex = g_cmdManager.index[slot];
+		const Scmd &cmd = g_cmdManager.cmds[cmdIndex];
+		if (cmd.shortNameHash == hash && !V_stricmp(GetShortName(cmd), shortName) && count < SCMD_MAX_MATCHES)
+		{
+			matches[count++] = cmdIndex;
+		}
+	}
+	return count;
+}
+
+// Find a command by its full name.
+static_function i32 FindCmd(const char *name)
+{
+	i32 conPrefixLen = strlen(SCMD_CONSOLE_PREFIX);
+	bool hasConPrefix = strnicmp(name, SCMD_CONSOLE_PREFIX, conPrefixLen) == 0 && name[conPrefixLen] != '\0';
+	i32 matches[SCMD_MAX_MATCHES];
+	i32 count = FindCmds(hasConPrefix ? name + conPrefixLen : name, matches);
+	for (i32 i = 0; i < count; i++)
+	{
+		if (g_cmdManager.cmds[matches[i]].hasConsolePrefix == hasConPrefix)
+		{
+			return matches[i];
+		}
+	}
+	return -1;
+}
+
 static_function SCMD_CALLBACK(Command_KzHelp)
 {
 	KZPlayer *player = g_pKZPlayerManager->ToPlayer(controller);
@@ -89,48 +160,34 @@ bool scmd::RegisterCmd(const char *name, scmd::Callback_t *callback, bool hidden
 	}
 
 	// Check if command with this name already exists
-	Scmd *cmds = g_cmdManager.cmds;
-	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+	if (FindCmd(name) != -1)
 	{
-		if (nameLength != g_cmdManager.cmds[i].nameLength)
-		{
-			continue;
-		}
-
-		if (!V_stricmp(g_cmdManager.cmds[i].name, name))
-		{
-			// TODO: print warning? error? segfault?
-			// Command already exists
-			// Assert(0);
-			return false;
-		}
+		// TODO: print warning? error? segfault?
+		// Command already exists
+		// Assert(0);
+		return false;
 	}
 
 	// Command name is unique!
 	Scmd cmd = {hasConPrefix, nameLength, "", callback, hidden};
 	V_snprintf(cmd.name, SCMD_MAX_NAME_LEN, "%s", name);
+	cmd.shortNameHash = utils::HashStringCaseless(GetShortName(cmd));
 	g_cmdManager.cmds[g_cmdManager.cmdCount++] = cmd;
+	RebuildIndex();
 	return true;
 }
 
 bool scmd::UnregisterCmd(const char *name)
 {
-	i32 indexToDelete = -1;
-	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
-	{
-		if (!V_stricmp(g_cmdManager.cmds[i].name, name))
-		{
-			indexToDelete = i;
-			break;
-		}
-	}
+	i32 indexToDelete = FindCmd(name);
 	if (indexToDelete != -1)
 	{
-		for (i32 i = indexToDelete; i < g_cmdManager.cmdCount; i++)
+		for (i32 i = indexToDelete; i < g_cmdManager.cmdCount - 1; i++)
 		{
 			g_cmdManager.cmds[i] = g_cmdManager.cmds[i + 1];
 		}
 		g_cmdManager.cmdCount--;
+		RebuildIndex();
 		return true;
 	}
 	return false;
@@ -156,23 +213,16 @@ META_RES scmd::OnClientCommand(CPlayerSlot &slot, const CCommand &args)
 		return MRES_IGNORED;
 	}
 
-	for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+	i32 cmdIndex = FindCmd(args[0]);
+	if (cmdIndex != -1)
 	{
-		if (!g_cmdManager.cmds[i].callback)
+		if (!g_cmdManager.cmds[cmdIndex].callback)
 		{
 			// TODO: error?
-			Assert(g_cmdManager.cmds[i].callback);
-			continue;
-		}
-
-		if (!V_stricmp(g_cmdManager.cmds[i].name, args[0]))
-		{
-			result = g_cmdManager.cmds[i].callback(controller, &args);
-			if (result == MRES_SUPERCEDE)
-			{
-				return result;
-			}
+			Assert(g_cmdManager.cmds[cmdIndex].callback);
+			return result;
 		}
+		result = g_cmdManager.cmds[cmdIndex].callback(controller, &args);
 	}
 	return result;
 }
@@ -224,48 +274,44 @@ META_RES scmd::OnDispatchConCommand(ConCommandHandle cmd, const CCommandContext
 		CCommand cmdArgs;
 		cmdArgs.Tokenize(args[1]);
 
-		for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+		const char *arg = cmdArgs[0] + 1; // skip chat trigger
+		i32 matches[SCMD_MAX_MATCHES];
+		i32 matchCount = FindCmds(arg, matches);
+		for (i32 i = 0; i < matchCount; i++)
 		{
-			if (!cmds[i].callback)
+			if (!cmds[matches[i]].callback)
 			{
 				// TODO: error?
-				Assert(cmds[i].callback);
+				Assert(cmds[matches[i]].callback);
 				continue;
 			}
 
-			const char *arg = cmdArgs[0] + 1; // skip chat trigger
-			const char *cmdName = cmds[i].hasConsolePrefix ? cmds[i].name + strlen(SCMD_CONSOLE_PREFIX) : cmds[i].name;
-			if (!V_stricmp(arg, cmdName))
+			META_RES result = cmds[matches[i]].callback(controller, &cmdArgs);
+			if (args[1][0] == SCMD_CHAT_SILENT_TRIGGER || result == MRES_SUPERCEDE)
 			{
-				META_RES result = cmds[i].callback(controller, &cmdArgs);
-				if (args[1][0] == SCMD_CHAT_SILENT_TRIGGER || result == MRES_SUPERCEDE)
-				{
-					// don't send chat message
-					return MRES_SUPERCEDE;
-				}
+				// don't send chat message
+				return MRES_SUPERCEDE;
 			}
 		}
 	}
 	else // Are we overriding a console command?
 	{
-		for (i32 i = 0; i < g_cmdManager.cmdCount; i++)
+		Scmd *cmds = g_cmdManager.cmds;
+		i32 matches[SCMD_MAX_MATCHES];
+		i32 matchCount = FindCmds(commandName, matches);
+		for (i32 i = 0; i < matchCount; i++)
 		{
-			Scmd *cmds = g_cmdManager.cmds;
-			if (!cmds[i].callback)
+			if (!cmds[matches[i]].callback)
 			{
 				// TODO: error?
-				Assert(cmds[i].callback);
+				Assert(cmds[matches[i]].callback);
 				continue;
 			}
 
-			const char *cmdName = cmds[i].hasConsolePrefix ? cmds[i].name + strlen(SCMD_CONSOLE_PREFIX) : cmds[i].name;
-			if (!V_stricmp(commandName, cmdName))
+			META_RES result = cmds[matches[i]].callback(controller, &args);
+			if (result == MRES_SUPERCEDE)
 			{
-				META_RES result = g_cmdManager.cmds[i].callback(controller, &args);
-				if (result == MRES_SUPERCEDE)
-				{
-					return result;
-				}
+				return result;
 			}
 		}
 	}
@@ -88,4 +88,16 @@ namespace utils
 		return str[strspn(str, "0123456789")] == 0;
 	}
 
+	// FNV-1a over the lowercase string, for hash lookups that have to agree with V_stricmp.
+	// Hashes the first length characters, or up to the null terminator if length is negative.
+	inline u32 HashStringCaseless(const char *str, i32 length = -1)
+	{
+		u32 hash = 0x811C9DC5;
+		for (i32 i = 0; length < 0 ? str[i] != '\0' : i < length; i++)
+		{
+			hash = (hash ^ (u32)tolower((u8)str[i])) * 0x01000193;
+		}
+		return hash;
+	}
+
 } // namespace utils
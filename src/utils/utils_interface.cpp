@@ -86,34 +86,12 @@ CGameEntitySystem *KZUtils::GetGameEntitySystem()
 
 void KZUtils::AddTimer(CTimerBase *timer, bool preserveMapChange)
 {
-	if (preserveMapChange)
-	{
-		g_PersistentTimers.AddToTail(timer);
-	}
-	else
-	{
-		g_NonPersistentTimers.AddToTail(timer);
-	}
+	ScheduleTimer(timer, preserveMapChange);
 }
 
 void KZUtils::RemoveTimer(CTimerBase *timer)
 {
-	FOR_EACH_VEC(g_PersistentTimers, i)
-	{
-		if (g_PersistentTimers.Element(i) == timer)
-		{
-			g_PersistentTimers.Remove(i);
-			return;
-		}
-	}
-	FOR_EACH_VEC(g_NonPersistentTimers, i)
-	{
-		if (g_NonPersistentTimers.Element(i) == timer)
-		{
-			g_NonPersistentTimers.Remove(i);
-			return;
-		}
-	}
+	UnscheduleTimer(timer);
 }
 
 CUtlVector<CServerSideClient *> *KZUtils::GetClientList()
@@ -0,0 +1,42 @@
+#include "varint.h"
+
+#include "tier0/memdbgon.h"
+
+void varint::Put(CUtlBuffer &buffer, u64 value)
+{
+	while (value >= 0x80)
+	{
+		buffer.PutUnsignedChar((u8)(value | 0x80));
+		value >>= 7;
+	}
+	buffer.PutUnsignedChar((u8)value);
+}
+
+void varint::Put(std::string &buffer, u64 value)
+{
+	while (value >= 0x80)
+	{
+		buffer += (char)(value | 0x80);
+		value >>= 7;
+	}
+	buffer += (char)value;
+}
+
+bool varint::Get(const u8 *data, size_t size, size_t &cursor, u64 &value)
+{
+	value = 0;
+	for (u32 shift = 0; shift < 64; shift += 7)
+	{
+		if (cursor >= size)
+		{
+			return false;
+		}
+		u8 byte = data[cursor++];
+		value |= (u64)(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,36 @@
+// LEB128 varints and zigzag encoding, used by the binary formats the plugin writes itself (replays, captures, run metadata).
+
+#pragma once
+#include "common.h"
+#include "utlbuffer.h"
+
+#include <string>
+
+namespace varint
+{
+	void Put(CUtlBuffer &buffer, u64 value);
+	void Put(std::string &buffer, u64 value);
+	// Returns false if the varint runs past size or is longer than 10 bytes.
+	bool Get(const u8 *data, size_t size, size_t &cursor, u64 &value);
+
+	// Maps signed values to unsigned ones so that small negative values stay small varints.
+	inline u32 ZigZagEncode(i32 value)
+	{
+		return ((u32)value << 1) ^ (u32)(value >> 31);
+	}
+
+	inline i32 ZigZagDecode(u32 value)
+	{
+		return (i32)(value >> 1) ^ -(i32)(value & 1);
+	}
+
+	inline u64 ZigZagEncode(i64 value)
+	{
+		return ((u64)value << 1) ^ (u64)(value >> 63);
+	}
+
+	inline i64 ZigZagDecode(u64 value)
+	{
+		return (i64)(value >> 1) ^ -(i64)(value & 1);
+	}
+} // namespace varint